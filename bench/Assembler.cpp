@@ -0,0 +1,47 @@
+#include <string>
+
+#include "Bench.hpp"
+#include "../src/Assembler.hpp"
+
+using namespace std;
+
+// Copies of the block in the synthesized source, about 4 MB
+#define BLOCKS 20000
+
+// One block: a loop over a table with labels, pseudo-instructions, comments and data
+static const char* block = "loop%d:  lw $t0, 0($s0)          # next element\n"
+                           "         addu $v0, $v0, $t0\n"
+                           "         addiu $s0, $s0, 4\n"
+                           "         li $t1, 0x12345678\n"
+                           "         blt $s0, $s1, loop%d\n"
+                           "         la $a0, table%d + 8\n"
+                           "         sw $v0, -4($a0)\n"
+                           "         beqz $v0, skip%d\n"
+                           "         jal loop%d\n"
+                           "skip%d:  sll $t2, $t0, 3\n"
+                           "         .data\n"
+                           "table%d: .word 1, 2, 3, 0xdeadbeef\n"
+                           "         .asciiz \"block, %d\"\n"
+                           "         .text\n";
+
+static size_t lines(const string& source) {
+    size_t count = 0;
+    for(char c : source) count += c == '\n';
+    return count;
+}
+
+void assembler_benchmarks(vector<Benchmark>& out) {
+    string* source = new string();
+    char buffer[1024];
+    for(int i = 0; i < BLOCKS; i++) {
+        snprintf(buffer, sizeof(buffer), block, i, i, i, i, i, i, i, i);
+        source->append(buffer);
+    }
+
+    // Per source line, both passes
+    out.push_back({"assembler/source", lines(*source), NULL, [source]() {
+        Assembler assembler;
+        keep(assembler.assemble(*source));
+        keep(assembler.image().size());
+    }});
+}
@@ -0,0 +1,50 @@
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+// A benchmark runs `ops` operations (usually guest instructions) per repetition
+struct Benchmark {
+    std::string name;
+    size_t ops;
+    std::function<void()> setup; // untimed, before every repetition
+    std::function<void()> run;
+};
+
+struct BenchResult {
+    std::string name;
+    size_t ops;
+    std::vector<double> ns_per_op; // one entry per repetition
+
+    double median() const;
+    double mean() const;
+    double min() const;
+    double stddev() const;
+    // Million operations per second, from the median
+    double mips() const { return 1000.0 / median(); }
+};
+
+BenchResult measure(const Benchmark& benchmark, int repetitions);
+
+// Runs each workload (or the named one) under the host hardware counters, in this optimised
+// build; returns the exit status for --perf
+int perf_workloads(const char* name);
+
+// Defined by each benchmark source file
+void assembler_benchmarks(std::vector<Benchmark>& out);
+void disassembler_benchmarks(std::vector<Benchmark>& out);
+void generated_benchmarks(std::vector<Benchmark>& out);
+void memory_benchmarks(std::vector<Benchmark>& out);
+void step_benchmarks(std::vector<Benchmark>& out);
+void workload_benchmarks(std::vector<Benchmark>& out);
+
+// Stops the compiler from optimising away a result
+template<typename T>
+inline void keep(T const& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+#endif
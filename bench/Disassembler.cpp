@@ -0,0 +1,27 @@
+#include <cstring>
+
+#include "Bench.hpp"
+#include "../src/Disassembler.hpp"
+#include "../src/Generator.hpp"
+
+using namespace std;
+
+void disassembler_benchmarks(vector<Benchmark>& out) {
+    GeneratorConfig config;
+    unsigned weights[GEN_CLASSES] = {4, 4, 2, 1, 2, 2, 1, 1, 1};
+    memcpy(config.weights, weights, sizeof(weights));
+    config.length = 4096;
+    vector<WORD>* code = new vector<WORD>(ProgramGenerator(config, 1).generate().code);
+
+    SymbolTable* symbols = new SymbolTable();
+    for(ADDRESS address = 0; address < code->size() * 4; address += 256) symbols->add(address, "block");
+
+    // Per instruction, into one reused buffer
+    auto run = [code](const SymbolTable* table, int flags) {
+        char buffer[DISASM_BUFFER];
+        for(size_t i = 0; i < code->size(); i++) keep(disassemble((*code)[i], i * 4, buffer, sizeof(buffer), table, flags));
+    };
+    out.push_back({"disassemble/names", code->size(), NULL, [run]() { run(NULL, 0); }});
+    out.push_back({"disassemble/numeric", code->size(), NULL, [run]() { run(NULL, DISASM_NUMERIC_REGISTERS); }});
+    out.push_back({"disassemble/symbols", code->size(), NULL, [run, symbols]() { run(symbols, 0); }});
+}
@@ -0,0 +1,64 @@
+#include <cstring>
+
+#include "Bench.hpp"
+#include "../src/Generator.hpp"
+#include "../src/Workloads.hpp"
+
+using namespace std;
+
+// Programs run per repetition
+#define BATCH 64
+
+static GeneratorConfig mix(const unsigned (&weights)[GEN_CLASSES]) {
+    GeneratorConfig config;
+    memcpy(config.weights, weights, sizeof(weights));
+    config.length = 1024;
+    config.footprint = 4096;
+    config.max_trips = 16;
+    return config;
+}
+
+// Each repetition runs a batch of freshly loaded random programs to their final break
+static Benchmark batch(string name, const GeneratorConfig& config) {
+    vector<GeneratedProgram>* programs = new vector<GeneratedProgram>();
+    vector<Emulator*>* loaded = new vector<Emulator*>(BATCH, (Emulator*)NULL);
+    ProgramGenerator generator(config, 1);
+    size_t ops = 0;
+
+    for(int i = 0; i < BATCH; i++) {
+        programs->push_back(generator.generate());
+        Emulator* vm = programs->back().load();
+        DWORD executed = 0;
+        run_workload(*vm, programs->back().max_instructions, executed);
+        ops += executed;
+        delete vm;
+    }
+
+    auto setup = [programs, loaded]() {
+        for(int i = 0; i < BATCH; i++) {
+            delete (*loaded)[i];
+            (*loaded)[i] = (*programs)[i].load();
+        }
+    };
+    auto run = [programs, loaded]() {
+        for(int i = 0; i < BATCH; i++) {
+            DWORD executed = 0;
+            keep(run_workload(*(*loaded)[i], (*programs)[i].max_instructions, executed));
+        }
+    };
+
+    return {name, ops, setup, run};
+}
+
+void generated_benchmarks(vector<Benchmark>& out) {
+    out.push_back(batch("generated/alu", mix({6, 4, 2, 1, 0, 0, 0, 0, 0})));
+    out.push_back(batch("generated/memory", mix({2, 2, 0, 0, 3, 3, 0, 0, 0})));
+    out.push_back(batch("generated/branchy", mix({4, 2, 1, 0, 1, 1, 3, 1, 0})));
+    out.push_back(batch("generated/loops", mix({4, 4, 2, 1, 2, 2, 1, 0, 1})));
+
+    // Generating alone, per program
+    static ProgramGenerator* generator = new ProgramGenerator(mix({4, 4, 2, 1, 2, 2, 1, 1, 1}), 1);
+    out.push_back({"generated/generate", BATCH, NULL, []() {
+        for(int i = 0; i < BATCH; i++) keep(generator->generate().code.size());
+    }});
+}
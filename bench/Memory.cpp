@@ -0,0 +1,58 @@
+#include "Bench.hpp"
+#include "../src/Emulator.hpp"
+#include "../src/Instruction.hpp"
+#include "../src/Utilities.hpp"
+
+using namespace std;
+
+#define MEMORY_SIZE (64 * 1024)
+#define ACCESSES (1 << 20)
+
+// Strides through the whole memory so accesses are not all to one line
+static ADDRESS address(size_t i, int alignment) {
+    return (i * 68) % (MEMORY_SIZE - 4) & ~(ADDRESS)(alignment - 1);
+}
+
+void memory_benchmarks(vector<Benchmark>& out) {
+    static Emulator* vm = new Emulator(MEMORY_SIZE);
+
+    out.push_back({"memory/load_word", ACCESSES, NULL, []() {
+        WORD sum = 0;
+        for(size_t i = 0; i < ACCESSES; i++) sum += vm->load_word(address(i, 4));
+        keep(sum);
+    }});
+
+    out.push_back({"memory/store_word", ACCESSES, NULL, []() {
+        for(size_t i = 0; i < ACCESSES; i++) vm->store_word(i, address(i, 4));
+        keep(vm->load_word(0));
+    }});
+
+    out.push_back({"memory/load_byte", ACCESSES, NULL, []() {
+        WORD sum = 0;
+        for(size_t i = 0; i < ACCESSES; i++) sum += vm->load_byte(address(i, 1));
+        keep(sum);
+    }});
+
+    out.push_back({"memory/store_byte", ACCESSES, NULL, []() {
+        for(size_t i = 0; i < ACCESSES; i++) vm->store_byte(i, address(i, 1));
+        keep(vm->load_byte(0));
+    }});
+
+    // Decoding a mix of R, I and J-type words into their fields
+    static vector<WORD> words;
+    for(int i = 0; i < 1024; i++) {
+        words.push_back(Utilities::R_instruction(OP_SPECIAL, i % 32, (i + 1) % 32, (i + 2) % 32, i % 32, FUNC_ADDU));
+        words.push_back(Utilities::I_instruction(OP_LW, i % 32, (i + 3) % 32, i * 4));
+        words.push_back(Utilities::J_instruction(OP_J, i));
+        words.push_back(Utilities::I_instruction(OP_BEQ, i % 32, (i + 5) % 32, -i));
+    }
+
+    out.push_back({"decode", ACCESSES, NULL, []() {
+        int sum = 0;
+        for(size_t i = 0; i < ACCESSES; i++) {
+            Instruction instruction(words[i & (words.size() - 1)]);
+            sum += instruction.opcode + instruction.rs + instruction.rt + instruction.se_imm;
+        }
+        keep(sum);
+    }});
+}
@@ -0,0 +1,67 @@
+#include <cstdio>
+#include <cstring>
+
+#include "Bench.hpp"
+#include "../src/PerfCounters.hpp"
+#include "../src/Workloads.hpp"
+
+// Writes the features Emulator is compiled with
+static void print_policy(FILE* out) {
+    static const struct {
+        unsigned bit;
+        const char* name;
+    } features[] = {
+        {EMU_TRACING, "tracing"},   {EMU_DIRTY_TRACKING, "dirty-tracking"}, {EMU_BOUNDS_CHECKS, "bounds-checks"},
+        {EMU_COUNTING, "counting"}, {EMU_STRICT_TRAPS, "strict-traps"},     {EMU_BIG_ENDIAN, "big-endian"},
+    };
+
+    fprintf(out, "policy:");
+    for(auto& feature : features) {
+        if(Emulator::policy::features & feature.bit) fprintf(out, " %s", feature.name);
+    }
+    fprintf(out, "%s\n", Emulator::policy::features == 0 ? " none" : "");
+}
+
+int perf_workloads(const char* name) {
+    const DWORD budget = 100000000;
+    PerfCounters perf;
+    if(!perf.available())
+        fprintf(stderr, "warning: %s, reporting time only\n", perf.error().c_str());
+
+    // The numbers only describe the interpreter as shipped if this is an optimised build without counters
+#ifdef __OPTIMIZE__
+    printf("build: optimised\n");
+#else
+    printf("build: unoptimised\n");
+#endif
+    print_policy(stdout);
+    printf("\n");
+
+    bool found = false;
+    for(const Workload& w : workload_corpus()) {
+        if(name != NULL && strcmp(w.name, name) != 0) continue;
+        found = true;
+
+        Emulator* vm = w.load();
+        DWORD branches = count_guest_branches(*vm, budget);
+        delete vm;
+
+        vm = w.load();
+        DWORD executed = 0;
+        PerfSample sample;
+        perf_run(perf, *vm, budget, executed, sample);
+        if(!w.check(*vm))
+            fprintf(stderr, "warning: %s finished with unexpected results\n", w.name);
+        delete vm;
+
+        printf("%s:\n", w.name);
+        print_perf(stdout, sample, executed, branches);
+        printf("\n");
+    }
+
+    if(!found) {
+        fprintf(stderr, "unknown workload: %s\n", name);
+        return 1;
+    }
+    return 0;
+}
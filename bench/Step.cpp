@@ -0,0 +1,103 @@
+#include "Bench.hpp"
+#include "../src/Emulator.hpp"
+#include "../src/Utilities.hpp"
+
+using namespace std;
+
+#define MEMORY_SIZE (64 * 1024)
+#define STEPS (1 << 20)
+// Copies of the measured instruction before jumping back to the start
+#define BODY 1024
+#define DATA 0x4000
+
+static Benchmark stepping(string name, vector<WORD> program, vector<pair<int, WORD>> registers) {
+    Emulator* vm = new Emulator(MEMORY_SIZE, program.data(), program.size());
+
+    auto setup = [vm, registers]() {
+        vm->state() = CPUState();
+        for(auto& r : registers) vm->set_register(r.first, r.second);
+    };
+    auto run = [vm]() {
+        int status = 0;
+        for(size_t i = 0; i < STEPS; i++) status |= vm->step();
+        keep(status);
+    };
+
+    return {name, STEPS, setup, run};
+}
+
+// BODY copies of one instruction, then `j 0`
+static Benchmark repeated(string name, WORD instruction, vector<pair<int, WORD>> registers) {
+    vector<WORD> program(BODY, instruction);
+    program.push_back(Utilities::J_instruction(OP_J, 0));
+    return stepping(name, program, registers);
+}
+
+void step_benchmarks(vector<Benchmark>& out) {
+    vector<pair<int, WORD>> regs = {{1, 0x1234}, {2, 7}, {3, 3}, {5, DATA}, {6, DATA + 0x1000}};
+
+    // ALU and immediates
+    out.push_back(repeated("step/alu/addu", Utilities::R_instruction(OP_SPECIAL, 4, 2, 3, 0, FUNC_ADDU), regs));
+    out.push_back(repeated("step/alu/add", Utilities::R_instruction(OP_SPECIAL, 4, 2, 3, 0, FUNC_ADD), regs));
+    out.push_back(repeated("step/alu/slt", Utilities::R_instruction(OP_SPECIAL, 4, 2, 3, 0, FUNC_SLT), regs));
+    out.push_back(repeated("step/alu/sll", Utilities::R_instruction(OP_SPECIAL, 4, 0, 2, 3, FUNC_SLL), regs));
+    out.push_back(repeated("step/alu/srav", Utilities::R_instruction(OP_SPECIAL, 4, 3, 2, 0, FUNC_SRAV), regs));
+    out.push_back(repeated("step/imm/addiu", Utilities::I_instruction(OP_ADDIU, 4, 2, 100), regs));
+    out.push_back(repeated("step/imm/ori", Utilities::I_instruction(OP_ORI, 4, 2, 0xff), regs));
+    out.push_back(repeated("step/imm/lui", Utilities::I_instruction(OP_LUI, 4, 0, 0xabcd), regs));
+
+    // HI/LO
+    out.push_back(repeated("step/muldiv/mult", Utilities::R_instruction(OP_SPECIAL, 0, 2, 3, 0, FUNC_MULT), regs));
+    out.push_back(repeated("step/muldiv/div", Utilities::R_instruction(OP_SPECIAL, 0, 2, 3, 0, FUNC_DIV), regs));
+    out.push_back(repeated("step/muldiv/mflo", Utilities::R_instruction(OP_SPECIAL, 4, 0, 0, 0, FUNC_MFLO), regs));
+
+    // Control flow
+    out.push_back(repeated("step/branch/beq-taken", Utilities::I_instruction(OP_BEQ, 0, 0, 1), regs));
+    out.push_back(repeated("step/branch/bne-not-taken", Utilities::I_instruction(OP_BNE, 0, 0, 5), regs));
+    {
+        vector<WORD> program;
+        for(int i = 0; i < BODY; i++) program.push_back(Utilities::J_instruction(OP_J, i + 1));
+        program.push_back(Utilities::J_instruction(OP_J, 0));
+        out.push_back(stepping("step/jump/j", program, regs));
+    }
+    {
+        // jal to a jr $31 and back
+        vector<WORD> program;
+        program.push_back(Utilities::J_instruction(OP_JAL, 3)); // jal 3
+        program.push_back(Utilities::J_instruction(OP_J, 0)); // j 0
+        program.push_back(0);
+        program.push_back(Utilities::R_instruction(OP_SPECIAL, 0, 31, 0, 0, FUNC_JR)); // jr r31
+        out.push_back(stepping("step/jump/jal-jr", program, regs));
+    }
+    out.push_back(repeated("step/trap/teq-not-taken", Utilities::R_instruction(OP_SPECIAL, 0, 2, 3, 0, FUNC_TEQ), regs));
+
+    // Memory
+    out.push_back(repeated("step/load/lw", Utilities::I_instruction(OP_LW, 4, 5, 8), regs));
+    out.push_back(repeated("step/load/lb", Utilities::I_instruction(OP_LB, 4, 5, 3), regs));
+    out.push_back(repeated("step/load/lhu", Utilities::I_instruction(OP_LHU, 4, 5, 2), regs));
+    out.push_back(repeated("step/load/lwl", Utilities::I_instruction(OP_LWL, 4, 5, 1), regs));
+    out.push_back(repeated("step/store/sw", Utilities::I_instruction(OP_SW, 1, 6, 8), regs));
+    out.push_back(repeated("step/store/sb", Utilities::I_instruction(OP_SB, 1, 6, 3), regs));
+
+    // Whole loops
+    {
+        vector<WORD> program;
+        program.push_back(Utilities::I_instruction(OP_ADDIU, 1, 1, 1)); // addiu r1, r1, 1
+        program.push_back(Utilities::I_instruction(OP_BNE, 2, 1, -1)); // bne r1, r2, -1
+        program.push_back(Utilities::J_instruction(OP_J, 0)); // j 0
+        out.push_back(stepping("loop/count", program, {{2, 0xffffffff}}));
+    }
+    {
+        // Copies 4 KiB a word at a time, then starts over
+        vector<WORD> program;
+        program.push_back(Utilities::I_instruction(OP_ADDIU, 5, 0, DATA)); // addiu r5, r0, DATA
+        program.push_back(Utilities::I_instruction(OP_ADDIU, 6, 0, DATA + 0x1000)); // addiu r6, r0, DATA + 0x1000
+        program.push_back(Utilities::I_instruction(OP_LW, 4, 5, 0)); // lw r4, 0(r5)
+        program.push_back(Utilities::I_instruction(OP_SW, 4, 6, 0)); // sw r4, 0(r6)
+        program.push_back(Utilities::I_instruction(OP_ADDIU, 5, 5, 4)); // addiu r5, r5, 4
+        program.push_back(Utilities::I_instruction(OP_ADDIU, 6, 6, 4)); // addiu r6, r6, 4
+        program.push_back(Utilities::I_instruction(OP_BNE, 7, 5, -4)); // bne r5, r7, -4
+        program.push_back(Utilities::J_instruction(OP_J, 0)); // j 0
+        out.push_back(stepping("loop/memcpy", program, {{7, DATA + 0x1000}}));
+    }
+}
@@ -0,0 +1,81 @@
+#include "Bench.hpp"
+#include "../src/AnyEmulator.hpp"
+#include "../src/Coverage.hpp"
+#include "../src/Workloads.hpp"
+
+using namespace std;
+
+#define BUDGET 100000000
+
+// Each repetition runs a workload from a freshly loaded image to its final break
+void workload_benchmarks(vector<Benchmark>& out) {
+    for(const Workload& w : workload_corpus()) {
+        Emulator* vm = w.load();
+        DWORD executed = 0;
+        run_workload(*vm, BUDGET, executed);
+        delete vm;
+
+        const Workload* workload = &w;
+        Emulator** current = new Emulator*(NULL);
+        auto setup = [workload, current]() {
+            delete *current;
+            *current = workload->load();
+        };
+        auto run = [current]() {
+            DWORD executed = 0;
+            keep(run_workload(**current, BUDGET, executed));
+        };
+
+        out.push_back({string("workload/") + w.name, executed, setup, run});
+    }
+
+    // The same runs recording edge coverage, as a fuzzer would
+    EdgeCoverage* coverage = new EdgeCoverage();
+    for(const Workload& w : workload_corpus()) {
+        Emulator* vm = w.load();
+        DWORD executed = 0;
+        run_workload(*vm, BUDGET, executed);
+        delete vm;
+
+        const Workload* workload = &w;
+        Emulator** current = new Emulator*(NULL);
+        auto setup = [workload, current, coverage]() {
+            delete *current;
+            *current = workload->load();
+            coverage->reset();
+        };
+        auto run = [current, coverage]() {
+            DWORD executed = 0;
+            keep((*current)->run(BUDGET, executed, *coverage));
+        };
+
+        out.push_back({string("coverage/") + w.name, executed, setup, run});
+    }
+
+    // The same runs through AnyEmulator, with the default features and with none at all
+    const unsigned feature_sets[] = {EMU_DEFAULT_FEATURES, 0};
+    const char* feature_names[] = {"default", "none"};
+    for(int f = 0; f < 2; f++) {
+        for(const Workload& w : workload_corpus()) {
+            Emulator* vm = w.load();
+            DWORD executed = 0;
+            run_workload(*vm, BUDGET, executed);
+            delete vm;
+
+            const Workload* workload = &w;
+            unsigned features = feature_sets[f];
+            AnyEmulator** current = new AnyEmulator*(NULL);
+            auto setup = [workload, features, current]() {
+                delete *current;
+                *current = new AnyEmulator(features, workload->memory_size, workload->image.data(), workload->image.size());
+                workload->reset(**current);
+            };
+            auto run = [current]() {
+                DWORD executed = 0;
+                keep((*current)->run(BUDGET, executed));
+            };
+
+            out.push_back({string("policy/") + feature_names[f] + "/" + w.name, executed, setup, run});
+        }
+    }
+}
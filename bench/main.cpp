@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+
+#include "Bench.hpp"
+
+using namespace std;
+
+#ifdef EMU_COUNTERS
+#define COUNTERS "true"
+#else
+#define COUNTERS "false"
+#endif
+
+double BenchResult::median() const {
+    vector<double> sorted = ns_per_op;
+    sort(sorted.begin(), sorted.end());
+    size_t n = sorted.size();
+    return n % 2 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+}
+
+double BenchResult::mean() const {
+    double sum = 0;
+    for(double v : ns_per_op) sum += v;
+    return sum / ns_per_op.size();
+}
+
+double BenchResult::min() const {
+    return *min_element(ns_per_op.begin(), ns_per_op.end());
+}
+
+double BenchResult::stddev() const {
+    double m = mean(), sum = 0;
+    for(double v : ns_per_op) sum += (v - m) * (v - m);
+    return ns_per_op.size() > 1 ? sqrt(sum / (ns_per_op.size() - 1)) : 0;
+}
+
+BenchResult measure(const Benchmark& benchmark, int repetitions) {
+    BenchResult result;
+    result.name = benchmark.name;
+    result.ops = benchmark.ops;
+
+    // One untimed warm-up run
+    if(benchmark.setup) benchmark.setup();
+    benchmark.run();
+
+    for(int i = 0; i < repetitions; i++) {
+        if(benchmark.setup) benchmark.setup();
+        auto start = chrono::steady_clock::now();
+        benchmark.run();
+        auto end = chrono::steady_clock::now();
+        double ns = chrono::duration<double, nano>(end - start).count();
+        result.ns_per_op.push_back(ns / benchmark.ops);
+    }
+
+    return result;
+}
+
+static void print_json(FILE* out, const vector<BenchResult>& results, int repetitions) {
+    fprintf(out, "{\n  \"repetitions\": %d,\n  \"counters\": %s,\n  \"benchmarks\": [\n", repetitions, COUNTERS);
+    for(size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        fprintf(out, "    {\"name\": \"%s\", \"ops\": %zu, \"median_ns\": %.4f, \"mean_ns\": %.4f, "
+                "\"min_ns\": %.4f, \"stddev_ns\": %.4f, \"mips\": %.2f}%s\n",
+                r.name.c_str(), r.ops, r.median(), r.mean(), r.min(), r.stddev(), r.mips(),
+                i + 1 < results.size() ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+// Median ns/op by benchmark name, from a file written with --json
+static bool load_baseline(const char* path, map<string, double>& baseline) {
+    FILE* in = fopen(path, "r");
+    if(in == NULL) return false;
+
+    char line[1024], name[256];
+    double median;
+    while(fgets(line, sizeof(line), in) != NULL) {
+        const char* entry = strstr(line, "{\"name\": \"");
+        const char* value = strstr(line, "\"median_ns\": ");
+        if(entry == NULL || value == NULL) continue;
+        if(sscanf(entry, "{\"name\": \"%255[^\"]\"", name) == 1 && sscanf(value, "\"median_ns\": %lf", &median) == 1)
+            baseline[name] = median;
+    }
+
+    fclose(in);
+    return true;
+}
+
+static void usage(const char* name) {
+    printf("Usage: %s [--reps N] [--filter SUBSTRING] [--json FILE|-] [--compare FILE] [--list]\n", name);
+    printf("       %s --perf [WORKLOAD]\n", name);
+}
+
+int main(int argc, char* argv[]) {
+    int repetitions = 10;
+    const char* filter = NULL;
+    const char* json = NULL;
+    const char* compare = NULL;
+    bool list = false;
+
+    if(argc > 1 && strcmp(argv[1], "--perf") == 0 && argc <= 3)
+        return perf_workloads(argc > 2 ? argv[2] : NULL);
+
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "--reps") == 0 && i + 1 < argc) repetitions = atoi(argv[++i]);
+        else if(strcmp(argv[i], "--filter") == 0 && i + 1 < argc) filter = argv[++i];
+        else if(strcmp(argv[i], "--json") == 0 && i + 1 < argc) json = argv[++i];
+        else if(strcmp(argv[i], "--compare") == 0 && i + 1 < argc) compare = argv[++i];
+        else if(strcmp(argv[i], "--list") == 0) list = true;
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if(repetitions < 1) repetitions = 1;
+
+    vector<Benchmark> benchmarks;
+    memory_benchmarks(benchmarks);
+    step_benchmarks(benchmarks);
+    workload_benchmarks(benchmarks);
+    generated_benchmarks(benchmarks);
+    assembler_benchmarks(benchmarks);
+    disassembler_benchmarks(benchmarks);
+
+    // Comparing a counters build against a plain one shows what counting costs
+    map<string, double> baseline;
+    if(compare != NULL && !load_baseline(compare, baseline)) {
+        perror(compare);
+        return 1;
+    }
+
+    vector<BenchResult> results;
+    bool to_stdout = json != NULL && strcmp(json, "-") == 0;
+    if(!to_stdout && !list) {
+        printf("counters: %s\n", COUNTERS);
+        printf("%-28s %12s %12s %12s %10s%s\n", "benchmark", "median ns/op", "min ns/op", "stddev", "MIPS",
+               compare != NULL ? "   vs base" : "");
+    }
+
+    for(const Benchmark& benchmark : benchmarks) {
+        if(filter != NULL && benchmark.name.find(filter) == string::npos) continue;
+        if(list) {
+            printf("%s\n", benchmark.name.c_str());
+            continue;
+        }
+
+        BenchResult r = measure(benchmark, repetitions);
+        if(!to_stdout) {
+            printf("%-28s %12.3f %12.3f %12.3f %10.1f", r.name.c_str(), r.median(), r.min(), r.stddev(), r.mips());
+            if(baseline.count(r.name))
+                printf(" %+9.1f%%", 100.0 * (r.median() / baseline[r.name] - 1));
+            printf("\n");
+        }
+        results.push_back(r);
+    }
+
+    if(json != NULL && !list) {
+        FILE* out = to_stdout ? stdout : fopen(json, "w");
+        if(out == NULL) {
+            perror(json);
+            return 1;
+        }
+        print_json(out, results, repetitions);
+        if(!to_stdout) fclose(out);
+    }
+
+    return 0;
+}
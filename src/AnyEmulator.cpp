@@ -0,0 +1,56 @@
+#include <array>
+#include <utility>
+
+#include "AnyEmulator.hpp"
+#include "Observer.hpp"
+
+using namespace std;
+
+template<typename E>
+class AnyEmulator::Holder : public Model {
+    E emulator;
+
+    public:
+    Holder(size_t mem_size, const WORD* program, size_t program_size) : emulator(mem_size, program, program_size) {}
+
+    int step() { return emulator.step(); }
+    int run(DWORD budget, DWORD& executed) { return emulator.run(budget, executed); }
+    int run(DWORD budget, DWORD& executed, ExecutionObserver& observer) { return emulator.run(budget, executed, observer); }
+    CPUState& state() { return emulator.state(); }
+    BYTE* memory() { return emulator.get_memory(); }
+    size_t memory_size() { return emulator.get_memory_size(); }
+    WORD load_word(ADDRESS addr) { return emulator.load_word(addr); }
+    void store_word(WORD word, ADDRESS addr) { emulator.store_word(word, addr); }
+
+    bool trace_to(TraceRing* ring) {
+        if constexpr(E::policy::tracing) emulator.trace_to(ring);
+        return E::policy::tracing;
+    }
+    bool track_dirty(BYTE* pages) {
+        if constexpr(E::policy::dirty_tracking) emulator.track_dirty(pages);
+        return E::policy::dirty_tracking;
+    }
+    Counters* counters() {
+        if constexpr(E::policy::counting) return &emulator.counters();
+        else return NULL;
+    }
+};
+
+template<unsigned Features>
+AnyEmulator::Model* AnyEmulator::make(size_t mem_size, const WORD* program, size_t program_size) {
+    return new Holder<BasicEmulator<EmulatorPolicy<Features>>>(mem_size, program, program_size);
+}
+
+AnyEmulator::AnyEmulator(unsigned features, size_t mem_size, const WORD* program, size_t program_size)
+    : feature_set(features & (EMU_FEATURE_SETS - 1)) {
+    // One constructor per feature set, indexed by its bits
+    static const auto factories = []<unsigned... Features>(integer_sequence<unsigned, Features...>) {
+        return array<Model* (*)(size_t, const WORD*, size_t), EMU_FEATURE_SETS>{&make<Features>...};
+    }(make_integer_sequence<unsigned, EMU_FEATURE_SETS>());
+
+    model = factories[feature_set](mem_size, program, program_size);
+}
+
+AnyEmulator::~AnyEmulator() {
+    delete model;
+}
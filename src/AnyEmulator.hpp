@@ -0,0 +1,70 @@
+#ifndef ANY_EMULATOR_HPP
+#define ANY_EMULATOR_HPP
+
+#include "Emulator.hpp"
+
+class ExecutionObserver;
+
+// An emulator whose features are chosen at run time, from the EMU_* bits of Emulator.hpp. It picks
+// the matching BasicEmulator instantiation once, on construction; run() then executes the whole
+// budget inside that instantiation, so the price of the indirection is one virtual call per call,
+// not per instruction. Embedders that know their features at compile time should use
+// BasicEmulator directly.
+class AnyEmulator {
+    class Model {
+        public:
+        virtual ~Model() {}
+        virtual int step() = 0;
+        virtual int run(DWORD budget, DWORD& executed) = 0;
+        virtual int run(DWORD budget, DWORD& executed, ExecutionObserver& observer) = 0;
+        virtual CPUState& state() = 0;
+        virtual BYTE* memory() = 0;
+        virtual size_t memory_size() = 0;
+        virtual WORD load_word(ADDRESS addr) = 0;
+        virtual void store_word(WORD word, ADDRESS addr) = 0;
+        virtual bool trace_to(TraceRing* ring) = 0;
+        virtual bool track_dirty(BYTE* pages) = 0;
+        virtual Counters* counters() = 0;
+    };
+
+    template<typename E>
+    class Holder;
+
+    template<unsigned Features>
+    static Model* make(size_t mem_size, const WORD* program, size_t program_size);
+
+    Model* model;
+    unsigned feature_set;
+
+    public:
+    // Any combination of EMU_* bits; bits above them are ignored
+    AnyEmulator(unsigned features, size_t mem_size, const WORD* program = NULL, size_t program_size = 0);
+    ~AnyEmulator();
+
+    AnyEmulator(const AnyEmulator&) = delete;
+    AnyEmulator& operator=(const AnyEmulator&) = delete;
+
+    unsigned features() { return feature_set; }
+
+    int step() { return model->step(); }
+    // As BasicEmulator::run()
+    int run(DWORD budget, DWORD& executed) { return model->run(budget, executed); }
+    int run(DWORD budget, DWORD& executed, ExecutionObserver& observer) { return model->run(budget, executed, observer); }
+
+    CPUState& state() { return model->state(); }
+    BYTE* get_memory() { return model->memory(); }
+    size_t get_memory_size() { return model->memory_size(); }
+    WORD load_word(ADDRESS addr) { return model->load_word(addr); }
+    void store_word(WORD word, ADDRESS addr) { model->store_word(word, addr); }
+    WORD get_register(int number) { return state().gpr[number]; }
+    void set_register(int number, WORD value) { state().gpr[register_slot(number)] = value; }
+
+    // False, doing nothing, without EMU_TRACING
+    bool trace_to(TraceRing* ring) { return model->trace_to(ring); }
+    // False, doing nothing, without EMU_DIRTY_TRACKING
+    bool track_dirty(BYTE* pages) { return model->track_dirty(pages); }
+    // NULL without EMU_COUNTING
+    Counters* counters() { return model->counters(); }
+};
+
+#endif
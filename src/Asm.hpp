@@ -0,0 +1,244 @@
+#ifndef ASM_HPP
+#define ASM_HPP
+
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+#include <vector>
+
+#include "Isa.hpp"
+#include "Utilities.hpp"
+
+// Reports a malformed program. It is deliberately not constexpr: reached while assembling in a
+// constant expression, it makes the compiler reject the program and quote the message.
+inline void asm_error(const char* message) {
+    fprintf(stderr, "asm: %s\n", message);
+    abort();
+}
+
+// Builds a program from mnemonics, resolving labels once everything is emitted. Branch offsets
+// are counted in words from the branch itself, as step() executes them (no delay slots), and the
+// program is assumed to be loaded at address 0.
+//
+// Everything is constexpr, so that with assemble<>() below a whole program becomes a constant
+// array; out-of-range registers, immediates and offsets, and unknown or duplicate labels are
+// compile errors there and abort at run time.
+class Asm {
+    enum FixupKind { FIX_BRANCH, FIX_JUMP, FIX_HIGH, FIX_LOW };
+
+    struct Label {
+        std::string_view name;
+        size_t index;
+    };
+    struct Fixup {
+        size_t index;
+        std::string_view label;
+        FixupKind kind;
+    };
+
+    std::vector<WORD> code;
+    std::vector<Label> label_list;
+    std::vector<Fixup> fixups;
+
+    static constexpr int reg(int number) {
+        if(number < 0 || number > 31) asm_error("register out of range");
+        return number;
+    }
+    static constexpr int signed_imm(int imm) {
+        if(imm < -32768 || imm > 32767) asm_error("immediate out of signed 16-bit range");
+        return imm;
+    }
+    static constexpr int unsigned_imm(int imm) {
+        if(imm < 0 || imm > 0xffff) asm_error("immediate out of unsigned 16-bit range");
+        return imm;
+    }
+    static constexpr int shift(int shamt) {
+        if(shamt < 0 || shamt > 31) asm_error("shift amount out of range");
+        return shamt;
+    }
+
+    constexpr void r(int func, int rd, int rs, int rt, int shamt) {
+        code.push_back(Utilities::R_instruction(OP_SPECIAL, reg(rd), reg(rs), reg(rt), shift(shamt), func));
+    }
+    constexpr void i(int opcode, int rt, int rs, int imm) {
+        code.push_back(Utilities::I_instruction(opcode, reg(rt), reg(rs), imm));
+    }
+    constexpr void branch(int opcode, int rs, int rt, std::string_view target) {
+        fixups.push_back({code.size(), target, FIX_BRANCH});
+        i(opcode, rt, rs, 0);
+    }
+    constexpr void jump(int opcode, std::string_view target) {
+        fixups.push_back({code.size(), target, FIX_JUMP});
+        code.push_back(Utilities::J_instruction(opcode, 0));
+    }
+
+    constexpr const Label* find(std::string_view name) const {
+        for(const Label& label : label_list) {
+            if(label.name == name) return &label;
+        }
+        return nullptr;
+    }
+
+    public:
+    constexpr void label(std::string_view name) {
+        if(find(name) != nullptr) asm_error("label defined twice");
+        label_list.push_back({name, code.size()});
+    }
+
+    // R-type: OP rd, rs, rt
+    constexpr void sll(int rd, int rt, int shamt) { r(FUNC_SLL, rd, 0, rt, shamt); }
+    constexpr void srl(int rd, int rt, int shamt) { r(FUNC_SRL, rd, 0, rt, shamt); }
+    constexpr void sra(int rd, int rt, int shamt) { r(FUNC_SRA, rd, 0, rt, shamt); }
+    constexpr void sllv(int rd, int rt, int rs) { r(FUNC_SLLV, rd, rs, rt, 0); }
+    constexpr void srlv(int rd, int rt, int rs) { r(FUNC_SRLV, rd, rs, rt, 0); }
+    constexpr void srav(int rd, int rt, int rs) { r(FUNC_SRAV, rd, rs, rt, 0); }
+    constexpr void jr(int rs) { r(FUNC_JR, 0, rs, 0, 0); }
+    constexpr void jalr(int rs) { r(FUNC_JALR, 31, rs, 0, 0); }
+    constexpr void movz(int rd, int rs, int rt) { r(FUNC_MOVZ, rd, rs, rt, 0); }
+    constexpr void movn(int rd, int rs, int rt) { r(FUNC_MOVN, rd, rs, rt, 0); }
+    constexpr void syscall() { r(FUNC_SYSCALL, 0, 0, 0, 0); }
+    constexpr void brk(int code) {
+        if(code < 0 || code >= 1 << 20) asm_error("break code out of range");
+        r(FUNC_BREAK, (code >> 5) & 31, code >> 15, (code >> 10) & 31, code & 31);
+    }
+    constexpr void mfhi(int rd) { r(FUNC_MFHI, rd, 0, 0, 0); }
+    constexpr void mthi(int rs) { r(FUNC_MTHI, 0, rs, 0, 0); }
+    constexpr void mflo(int rd) { r(FUNC_MFLO, rd, 0, 0, 0); }
+    constexpr void mtlo(int rs) { r(FUNC_MTLO, 0, rs, 0, 0); }
+    constexpr void mult(int rs, int rt) { r(FUNC_MULT, 0, rs, rt, 0); }
+    constexpr void multu(int rs, int rt) { r(FUNC_MULTU, 0, rs, rt, 0); }
+    constexpr void div(int rs, int rt) { r(FUNC_DIV, 0, rs, rt, 0); }
+    constexpr void divu(int rs, int rt) { r(FUNC_DIVU, 0, rs, rt, 0); }
+    constexpr void add(int rd, int rs, int rt) { r(FUNC_ADD, rd, rs, rt, 0); }
+    constexpr void addu(int rd, int rs, int rt) { r(FUNC_ADDU, rd, rs, rt, 0); }
+    constexpr void sub(int rd, int rs, int rt) { r(FUNC_SUB, rd, rs, rt, 0); }
+    constexpr void subu(int rd, int rs, int rt) { r(FUNC_SUBU, rd, rs, rt, 0); }
+    constexpr void and_(int rd, int rs, int rt) { r(FUNC_AND, rd, rs, rt, 0); }
+    constexpr void or_(int rd, int rs, int rt) { r(FUNC_OR, rd, rs, rt, 0); }
+    constexpr void xor_(int rd, int rs, int rt) { r(FUNC_XOR, rd, rs, rt, 0); }
+    constexpr void nor(int rd, int rs, int rt) { r(FUNC_NOR, rd, rs, rt, 0); }
+    constexpr void slt(int rd, int rs, int rt) { r(FUNC_SLT, rd, rs, rt, 0); }
+    constexpr void sltu(int rd, int rs, int rt) { r(FUNC_SLTU, rd, rs, rt, 0); }
+    constexpr void tge(int rs, int rt) { r(FUNC_TGE, 0, rs, rt, 0); }
+    constexpr void tgeu(int rs, int rt) { r(FUNC_TGEU, 0, rs, rt, 0); }
+    constexpr void tlt(int rs, int rt) { r(FUNC_TLT, 0, rs, rt, 0); }
+    constexpr void tltu(int rs, int rt) { r(FUNC_TLTU, 0, rs, rt, 0); }
+    constexpr void teq(int rs, int rt) { r(FUNC_TEQ, 0, rs, rt, 0); }
+    constexpr void tne(int rs, int rt) { r(FUNC_TNE, 0, rs, rt, 0); }
+
+    // I-type: OP rt, rs, imm; loads and stores: OP rt, offset(base)
+    constexpr void addi(int rt, int rs, int imm) { i(OP_ADDI, rt, rs, signed_imm(imm)); }
+    constexpr void addiu(int rt, int rs, int imm) { i(OP_ADDIU, rt, rs, signed_imm(imm)); }
+    constexpr void slti(int rt, int rs, int imm) { i(OP_SLTI, rt, rs, signed_imm(imm)); }
+    constexpr void sltiu(int rt, int rs, int imm) { i(OP_SLTIU, rt, rs, signed_imm(imm)); }
+    constexpr void andi(int rt, int rs, int imm) { i(OP_ANDI, rt, rs, unsigned_imm(imm)); }
+    constexpr void ori(int rt, int rs, int imm) { i(OP_ORI, rt, rs, unsigned_imm(imm)); }
+    constexpr void xori(int rt, int rs, int imm) { i(OP_XORI, rt, rs, unsigned_imm(imm)); }
+    constexpr void lui(int rt, int imm) { i(OP_LUI, rt, 0, unsigned_imm(imm)); }
+    constexpr void lb(int rt, int offset, int base) { i(OP_LB, rt, base, signed_imm(offset)); }
+    constexpr void lh(int rt, int offset, int base) { i(OP_LH, rt, base, signed_imm(offset)); }
+    constexpr void lwl(int rt, int offset, int base) { i(OP_LWL, rt, base, signed_imm(offset)); }
+    constexpr void lw(int rt, int offset, int base) { i(OP_LW, rt, base, signed_imm(offset)); }
+    constexpr void lbu(int rt, int offset, int base) { i(OP_LBU, rt, base, signed_imm(offset)); }
+    constexpr void lhu(int rt, int offset, int base) { i(OP_LHU, rt, base, signed_imm(offset)); }
+    constexpr void lwr(int rt, int offset, int base) { i(OP_LWR, rt, base, signed_imm(offset)); }
+    constexpr void sb(int rt, int offset, int base) { i(OP_SB, rt, base, signed_imm(offset)); }
+    constexpr void sh(int rt, int offset, int base) { i(OP_SH, rt, base, signed_imm(offset)); }
+    constexpr void sw(int rt, int offset, int base) { i(OP_SW, rt, base, signed_imm(offset)); }
+
+    constexpr void beq(int rs, int rt, std::string_view target) { branch(OP_BEQ, rs, rt, target); }
+    constexpr void bne(int rs, int rt, std::string_view target) { branch(OP_BNE, rs, rt, target); }
+    constexpr void blez(int rs, std::string_view target) { branch(OP_BLEZ, rs, 0, target); }
+    constexpr void bgtz(int rs, std::string_view target) { branch(OP_BGTZ, rs, 0, target); }
+    constexpr void j(std::string_view target) { jump(OP_J, target); }
+    constexpr void jal(std::string_view target) { jump(OP_JAL, target); }
+
+    // Pseudo-instructions
+    constexpr void nop() { sll(0, 0, 0); }
+    constexpr void move(int rd, int rs) { addu(rd, rs, 0); }
+    constexpr void b(std::string_view target) { beq(0, 0, target); }
+    // One addiu if the value fits, otherwise lui and ori
+    constexpr void li(int rt, WORD value) {
+        if((int)value >= -32768 && (int)value <= 32767) {
+            addiu(rt, 0, (int)value);
+        } else {
+            lui(rt, value >> 16);
+            ori(rt, rt, value & 0xffff);
+        }
+    }
+    // Always lui and ori, as the address is only known once the program is finished
+    constexpr void la(int rt, std::string_view target) {
+        fixups.push_back({code.size(), target, FIX_HIGH});
+        lui(rt, 0);
+        fixups.push_back({code.size(), target, FIX_LOW});
+        ori(rt, rt, 0);
+    }
+    // A data word in the instruction stream
+    constexpr void word(WORD value) { code.push_back(value); }
+
+    constexpr size_t size() const { return code.size(); }
+
+    // Name and address of every label, in the order they were defined
+    template<typename F>
+    void each_label(F visit) const {
+        for(const Label& label : label_list) visit(label.name, (ADDRESS)(label.index * 4));
+    }
+
+    constexpr std::vector<WORD> assemble() {
+        for(const Fixup& fixup : fixups) {
+            const Label* label = find(fixup.label);
+            if(label == nullptr) asm_error("undefined label");
+            long long target = label->index;
+            ADDRESS address = label->index * 4;
+
+            switch(fixup.kind) {
+                case FIX_BRANCH: {
+                    long long offset = target - (long long)fixup.index;
+                    if(offset < -32768 || offset > 32767) asm_error("branch target out of range");
+                    code[fixup.index] |= offset & 0xffff;
+                    break;
+                }
+                case FIX_JUMP:
+                    if(target > 0x3FFFFFF) asm_error("jump target out of range");
+                    code[fixup.index] |= target;
+                    break;
+                case FIX_HIGH:
+                    code[fixup.index] |= address >> 16;
+                    break;
+                case FIX_LOW:
+                    code[fixup.index] |= address & 0xffff;
+                    break;
+            }
+        }
+        fixups.clear();
+        return code;
+    }
+};
+
+// Assembles a program at compile time into a constant array sized to fit, e.g.
+//
+//     constexpr auto program = assemble<[](Asm& a) {
+//         a.li(1, 10);
+//         a.label("loop");
+//         a.addiu(1, 1, -1);
+//         a.bgtz(1, "loop");
+//         a.brk(1);
+//     }>();
+template<auto Source>
+constexpr auto assemble() {
+    constexpr size_t size = [] {
+        Asm a;
+        Source(a);
+        return a.assemble().size();
+    }();
+
+    Asm a;
+    Source(a);
+    std::vector<WORD> code = a.assemble();
+    std::array<WORD, size> image{};
+    for(size_t i = 0; i < size; i++) image[i] = code[i];
+    return image;
+}
+
+#endif
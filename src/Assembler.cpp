@@ -0,0 +1,734 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include "Assembler.hpp"
+#include "Isa.hpp"
+#include "Utilities.hpp"
+
+using namespace std;
+
+// Scratch register of the pseudo-instructions
+#define AT 1
+
+// Pseudo-instructions, numbered after the formats of the real ones
+enum Pseudo {
+    P_NOP = ISA_FORMATS,
+    P_MOVE,
+    P_LI,
+    P_LA,
+    P_B,
+    P_BRANCH_ZERO, // beqz, bnez: opcode of the branch
+    P_COMPARE,     // blt, bge, bgt, ble: opcode of the branch, func 1 if the operands are swapped
+    P_UNARY        // neg, negu, not: func of the R-type, with $0 as the other operand
+};
+
+struct Mnemonic {
+    const char* name;
+    int format; // an IsaFormat or a Pseudo
+    int opcode;
+    int func;
+};
+
+static const Mnemonic pseudos[] = {
+    {"nop", P_NOP, 0, 0},           {"move", P_MOVE, 0, 0},           {"li", P_LI, 0, 0},
+    {"la", P_LA, 0, 0},             {"b", P_B, 0, 0},                 {"beqz", P_BRANCH_ZERO, OP_BEQ, 0},
+    {"bnez", P_BRANCH_ZERO, OP_BNE, 0}, {"blt", P_COMPARE, OP_BNE, 0}, {"bge", P_COMPARE, OP_BEQ, 0},
+    {"bgt", P_COMPARE, OP_BNE, 1},  {"ble", P_COMPARE, OP_BEQ, 1},    {"neg", P_UNARY, 0, FUNC_SUB},
+    {"negu", P_UNARY, 0, FUNC_SUBU}, {"not", P_UNARY, 0, FUNC_NOR},
+};
+
+enum Directive { DIR_TEXT, DIR_DATA, DIR_WORD, DIR_HALF, DIR_BYTE, DIR_ASCII, DIR_ASCIIZ, DIR_SPACE, DIR_ALIGN, DIR_GLOBL };
+
+static const char* directives[] = {".text", ".data", ".word", ".half", ".byte", ".ascii", ".asciiz", ".space", ".align",
+                                   ".globl"};
+
+static const char* register_names[32] = {"zero", "at", "v0", "v1", "a0", "a1", "a2", "a3", "t0", "t1", "t2",
+                                         "t3",   "t4", "t5", "t6", "t7", "s0", "s1", "s2", "s3", "s4", "s5",
+                                         "s6",   "s7", "t8", "t9", "k0", "k1", "gp", "sp", "fp", "ra"};
+
+struct Assembler::Statement {
+    const Mnemonic* mnemonic; // NULL for a directive
+    int directive;
+    bool in_data;
+    ADDRESS offset; // from the start of its segment
+    size_t line;
+    string_view operands;
+};
+
+// Every instruction of Isa.hpp, then the pseudo-instructions
+static const unordered_map<string_view, const Mnemonic*>& mnemonic_table() {
+    static vector<Mnemonic> mnemonics = [] {
+        vector<Mnemonic> m;
+        for(int i = 0; i < 64; i++) {
+            if(isa_opcodes[i].name != NULL) m.push_back({isa_opcodes[i].name, isa_opcodes[i].format, i, 0});
+            if(isa_funcs[i].name != NULL) m.push_back({isa_funcs[i].name, isa_funcs[i].format, OP_SPECIAL, i});
+        }
+        m.insert(m.end(), begin(pseudos), end(pseudos));
+        return m;
+    }();
+    static unordered_map<string_view, const Mnemonic*> table = [] {
+        unordered_map<string_view, const Mnemonic*> t;
+        for(const Mnemonic& m : mnemonics) t[m.name] = &m;
+        return t;
+    }();
+    return table;
+}
+
+static bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static bool is_symbol_char(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '.' ||
+           c == '$';
+}
+
+static string_view trim(string_view text) {
+    while(!text.empty() && is_space(text.front())) text.remove_prefix(1);
+    while(!text.empty() && is_space(text.back())) text.remove_suffix(1);
+    return text;
+}
+
+// Cuts the first operand off a comma-separated list, ignoring commas inside quotes
+static string_view next_item(string_view& rest) {
+    char quote = 0;
+    size_t i = 0;
+    for(; i < rest.size(); i++) {
+        char c = rest[i];
+        if(quote) {
+            if(c == '\\') i++;
+            else if(c == quote) quote = 0;
+        } else if(c == '"' || c == '\'') {
+            quote = c;
+        } else if(c == ',') {
+            break;
+        }
+    }
+    string_view item = trim(rest.substr(0, i));
+    // A trailing comma leaves an empty item behind
+    rest = i < rest.size() ? rest.substr(i + 1) : string_view(NULL, 0);
+    return item;
+}
+
+// Splits operands into out, returning how many there are (even past max)
+static size_t split(string_view text, string_view* out, size_t max) {
+    size_t count = 0;
+    if(trim(text).empty()) return 0;
+    while(text.data() != NULL) {
+        string_view item = next_item(text);
+        if(count < max) out[count] = item;
+        count++;
+    }
+    return count;
+}
+
+static int escape(char c) {
+    switch(c) {
+        case 'n': return '\n';
+        case 't': return '\t';
+        case 'r': return '\r';
+        case '0': return 0;
+        default: return c;
+    }
+}
+
+// Decodes a "..." literal into out (if not NULL); returns false if it is malformed
+static bool string_literal(string_view text, string* out, size_t& length) {
+    if(text.size() < 2 || text.front() != '"' || text.back() != '"') return false;
+    length = 0;
+    for(size_t i = 1; i + 1 < text.size(); i++) {
+        char c = text[i];
+        if(c == '\\') {
+            if(i + 2 >= text.size()) return false;
+            c = escape(text[++i]);
+        }
+        if(out != NULL) out->push_back(c);
+        length++;
+    }
+    return true;
+}
+
+static ADDRESS align_up(ADDRESS value, ADDRESS alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// Words an li of this value takes
+static int li_words(long long value) {
+    if(value >= -32768 && value <= 0xffff) return 1;
+    return (value & 0xffff) == 0 ? 1 : 2;
+}
+
+// -1 for break, whose code is optional
+static int operand_count(int format) {
+    switch(format) {
+        case FMT_NONE:
+        case P_NOP: return 0;
+        case FMT_BREAK: return -1;
+        case FMT_RS:
+        case FMT_RD:
+        case FMT_JALR:
+        case FMT_JUMP:
+        case P_B: return 1;
+        case FMT_RD_RS_RT:
+        case FMT_RD_RT_SA:
+        case FMT_RD_RT_RS:
+        case FMT_IMM:
+        case FMT_UIMM:
+        case FMT_BRANCH2:
+        case P_COMPARE: return 3;
+        default: return 2;
+    }
+}
+
+static int instruction_words(const Mnemonic* m) {
+    switch(m->format) {
+        case P_LA:
+        case P_COMPARE: return 2;
+        default: return 1;
+    }
+}
+
+Assembler::Assembler(const AssemblerConfig& config)
+    : config(config), text_start(0), data_start(0), text_bytes(0), data_bytes(0), entry_point(0) {}
+
+void Assembler::error(size_t line, const string& message) {
+    if(error_list.size() < config.max_errors) error_list.push_back("line " + to_string(line) + ": " + message);
+}
+
+bool Assembler::expression(string_view text, size_t line, bool labels_allowed, long long& value) {
+    text = trim(text);
+    value = 0;
+    if(text.empty()) {
+        error(line, "missing operand");
+        return false;
+    }
+
+    size_t i = 0;
+    int sign = 1;
+    while(i < text.size()) {
+        while(i < text.size() && is_space(text[i])) i++;
+        if(i < text.size() && (text[i] == '-' || text[i] == '+')) {
+            sign = text[i] == '-' ? -sign : sign;
+            i++;
+            continue;
+        }
+        if(i >= text.size()) break;
+
+        long long term = 0;
+        char c = text[i];
+        if(c == '\'') {
+            // 'c' or '\n'
+            if(i + 2 < text.size() && text[i + 1] != '\\' && text[i + 2] == '\'') {
+                term = (unsigned char)text[i + 1];
+                i += 3;
+            } else if(i + 3 < text.size() && text[i + 1] == '\\' && text[i + 3] == '\'') {
+                term = escape(text[i + 2]);
+                i += 4;
+            } else {
+                error(line, "bad character literal");
+                return false;
+            }
+        } else if(c >= '0' && c <= '9') {
+            int base = 10;
+            if(c == '0' && i + 1 < text.size() && (text[i + 1] == 'x' || text[i + 1] == 'X')) base = 16, i += 2;
+            else if(c == '0' && i + 1 < text.size() && (text[i + 1] == 'b' || text[i + 1] == 'B')) base = 2, i += 2;
+            size_t start = i;
+            for(; i < text.size(); i++) {
+                char d = text[i];
+                int digit = d >= '0' && d <= '9' ? d - '0' : d >= 'a' && d <= 'f' ? d - 'a' + 10
+                          : d >= 'A' && d <= 'F' ? d - 'A' + 10 : 99;
+                if(digit >= base) break;
+                term = term * base + digit;
+            }
+            if(i == start || (i < text.size() && is_symbol_char(text[i]))) {
+                error(line, "bad number '" + string(text) + "'");
+                return false;
+            }
+        } else if(is_symbol_char(c) && c != '$') {
+            size_t start = i;
+            while(i < text.size() && is_symbol_char(text[i])) i++;
+            string_view name = text.substr(start, i - start);
+            if(!labels_allowed) {
+                error(line, "'" + string(name) + "' is not a constant");
+                return false;
+            }
+            auto found = labels.find(name);
+            if(found == labels.end()) {
+                error(line, "undefined label '" + string(name) + "'");
+                return false;
+            }
+            term = found->second;
+        } else {
+            error(line, "bad operand '" + string(text) + "'");
+            return false;
+        }
+
+        value += sign * term;
+        sign = 1;
+        while(i < text.size() && is_space(text[i])) i++;
+        if(i < text.size() && text[i] != '+' && text[i] != '-') {
+            error(line, "bad operand '" + string(text) + "'");
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Assembler::register_operand(string_view text, size_t line, int& number) {
+    if(text.size() >= 2 && text[0] == '$') {
+        string_view name = text.substr(1);
+        if(name[0] >= '0' && name[0] <= '9') {
+            number = 0;
+            for(char c : name) {
+                if(c < '0' || c > '9' || number > 31) {
+                    number = 32;
+                    break;
+                }
+                number = number * 10 + c - '0';
+            }
+            if(number <= 31) return true;
+        } else {
+            for(int r = 0; r < 32; r++) {
+                if(name == register_names[r]) {
+                    number = r;
+                    return true;
+                }
+            }
+            if(name == "s8") {
+                number = 30;
+                return true;
+            }
+        }
+    }
+    error(line, "bad register '" + string(text) + "'");
+    return false;
+}
+
+bool Assembler::memory_operand(string_view text, size_t line, int& offset, int& base) {
+    size_t open = text.find('(');
+    if(open == string_view::npos || text.back() != ')') {
+        error(line, "expected offset(base), got '" + string(text) + "'");
+        return false;
+    }
+    if(!register_operand(trim(text.substr(open + 1, text.size() - open - 2)), line, base)) return false;
+
+    long long value = 0;
+    if(!trim(text.substr(0, open)).empty() && !expression(text.substr(0, open), line, true, value)) return false;
+    if(value < -32768 || value > 32767) {
+        error(line, "offset out of range");
+        return false;
+    }
+    offset = value;
+    return true;
+}
+
+bool Assembler::first_pass(string_view source, vector<Statement>& statements) {
+    const auto& lookup = mnemonic_table();
+    struct Pending {
+        string_view name;
+        bool in_data;
+        ADDRESS offset;
+        size_t line;
+    };
+    vector<Pending> pending;
+    ADDRESS offsets[2] = {0, 0};
+    bool in_data = false;
+    size_t line = 0;
+    string_view line_labels[8];
+
+    for(size_t position = 0; position < source.size();) {
+        size_t end = source.find('\n', position);
+        if(end == string_view::npos) end = source.size();
+        string_view text = source.substr(position, end - position);
+        position = end + 1;
+        line++;
+
+        // Comments, outside of quotes
+        char quote = 0;
+        for(size_t i = 0; i < text.size(); i++) {
+            char c = text[i];
+            if(quote) {
+                if(c == '\\') i++;
+                else if(c == quote) quote = 0;
+            } else if(c == '"' || c == '\'') {
+                quote = c;
+            } else if(c == '#') {
+                text = text.substr(0, i);
+                break;
+            }
+        }
+        text = trim(text);
+
+        // Labels
+        size_t label_count = 0;
+        while(!text.empty()) {
+            size_t i = 0;
+            while(i < text.size() && is_symbol_char(text[i])) i++;
+            size_t colon = i;
+            while(colon < text.size() && is_space(text[colon])) colon++;
+            if(i == 0 || colon >= text.size() || text[colon] != ':') break;
+            if(label_count < 8) line_labels[label_count++] = text.substr(0, i);
+            else error(line, "too many labels on one line");
+            text = trim(text.substr(colon + 1));
+        }
+
+        Statement statement = {NULL, -1, in_data, 0, line, string_view()};
+        ADDRESS size = 0, alignment = 1;
+
+        if(!text.empty()) {
+            size_t i = 0;
+            while(i < text.size() && !is_space(text[i])) i++;
+            string_view name = text.substr(0, i);
+            statement.operands = trim(text.substr(i));
+
+            if(name[0] == '.') {
+                for(int d = 0; d < (int)(sizeof(directives) / sizeof(directives[0])); d++) {
+                    if(name == directives[d]) statement.directive = d;
+                }
+                string_view items[1];
+                size_t count = split(statement.operands, items, 1);
+                long long value = 0;
+
+                switch(statement.directive) {
+                    case DIR_TEXT:
+                    case DIR_DATA:
+                        in_data = statement.directive == DIR_DATA;
+                        statement.in_data = in_data;
+                        break;
+                    case DIR_WORD:
+                        size = 4 * count, alignment = 4;
+                        break;
+                    case DIR_HALF:
+                        size = 2 * count, alignment = 2;
+                        break;
+                    case DIR_BYTE:
+                        size = count;
+                        break;
+                    case DIR_ASCII:
+                    case DIR_ASCIIZ: {
+                        string_view strings[64];
+                        size_t n = split(statement.operands, strings, 64);
+                        if(n == 0 || n > 64) error(line, "expected 1 to 64 strings");
+                        for(size_t s = 0; s < n && s < 64; s++) {
+                            size_t length = 0;
+                            if(!string_literal(strings[s], NULL, length)) error(line, "bad string literal");
+                            size += length + (statement.directive == DIR_ASCIIZ);
+                        }
+                        break;
+                    }
+                    case DIR_SPACE:
+                        if(expression(statement.operands, line, false, value)) {
+                            if(value < 0 || value > 1 << 30) error(line, "bad .space size");
+                            else size = value;
+                        }
+                        break;
+                    case DIR_ALIGN:
+                        if(expression(statement.operands, line, false, value)) {
+                            if(value < 0 || value > 16) error(line, "bad .align");
+                            else alignment = 1 << value;
+                        }
+                        break;
+                    case DIR_GLOBL:
+                        break;
+                    default:
+                        error(line, "unknown directive '" + string(name) + "'");
+                }
+            } else {
+                auto found = lookup.find(name);
+                if(found == lookup.end()) {
+                    error(line, "unknown instruction '" + string(name) + "'");
+                } else if(in_data) {
+                    error(line, "instruction in .data");
+                } else {
+                    statement.mnemonic = found->second;
+                    alignment = 4;
+                    size = 4 * instruction_words(statement.mnemonic);
+                    if(statement.mnemonic->format == P_LI) {
+                        string_view operands[2];
+                        long long value = 0;
+                        if(split(statement.operands, operands, 2) != 2) error(line, "li takes a register and a value");
+                        else if(expression(operands[1], line, false, value)) size = 4 * li_words(value);
+                    }
+                }
+            }
+        }
+
+        ADDRESS& offset = offsets[in_data];
+        offset = align_up(offset, alignment);
+        for(size_t l = 0; l < label_count; l++) pending.push_back({line_labels[l], in_data, offset, line});
+        statement.offset = offset;
+        offset += size;
+        if(!text.empty()) statements.push_back(statement);
+        if(error_list.size() >= config.max_errors) return false;
+    }
+
+    text_start = config.text_address;
+    text_bytes = offsets[0];
+    data_bytes = offsets[1];
+    data_start = config.data_address != 0 ? config.data_address : align_up(text_start + text_bytes, EMU_PAGE_SIZE);
+    if(data_bytes > 0 && data_start < text_start + text_bytes && data_start + data_bytes > text_start)
+        error(0, "text and data overlap");
+
+    labels.reserve(pending.size());
+    for(const Pending& label : pending) {
+        ADDRESS address = (label.in_data ? data_start : text_start) + label.offset;
+        if(!labels.emplace(label.name, address).second) error(label.line, "label '" + string(label.name) + "' defined twice");
+        table.add(address, string(label.name));
+    }
+    return error_list.empty();
+}
+
+void Assembler::emit(ADDRESS address, WORD word) {
+    bytes[address] = word;
+    bytes[address + 1] = word >> 8;
+    bytes[address + 2] = word >> 16;
+    bytes[address + 3] = word >> 24;
+}
+
+void Assembler::data(const Statement& statement) {
+    ADDRESS address = (statement.in_data ? data_start : text_start) + statement.offset;
+    size_t line = statement.line;
+
+    switch(statement.directive) {
+        case DIR_WORD:
+        case DIR_HALF:
+        case DIR_BYTE: {
+            int width = statement.directive == DIR_WORD ? 4 : statement.directive == DIR_HALF ? 2 : 1;
+            string_view rest = statement.operands;
+            while(rest.data() != NULL) {
+                long long value = 0;
+                if(!expression(next_item(rest), line, true, value)) return;
+                if(value < -(1LL << (8 * width - 1)) || value >= 1LL << (8 * width)) {
+                    error(line, "value out of range");
+                    return;
+                }
+                for(int b = 0; b < width; b++) bytes[address++] = value >> (8 * b);
+            }
+            break;
+        }
+        case DIR_ASCII:
+        case DIR_ASCIIZ: {
+            string_view rest = statement.operands;
+            while(rest.data() != NULL) {
+                string decoded;
+                size_t length = 0;
+                string_literal(next_item(rest), &decoded, length);
+                memcpy(&bytes[address], decoded.data(), length);
+                address += length;
+                if(statement.directive == DIR_ASCIIZ) bytes[address++] = 0;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void Assembler::encode(const Statement& statement) {
+    const Mnemonic* m = statement.mnemonic;
+    ADDRESS pc = text_start + statement.offset;
+    size_t line = statement.line;
+    string_view operands[4];
+    size_t count = split(statement.operands, operands, 4);
+    int rd = 0, rs = 0, rt = 0;
+    long long value = 0;
+
+    int expected = operand_count(m->format);
+    if(expected >= 0 ? (int)count != expected : count > 1) {
+        error(line, string(m->name) + " takes " + to_string(max(expected, 0)) + " operands");
+        return;
+    }
+
+    auto branch_offset = [&](string_view target, ADDRESS from, int& offset) {
+        if(!expression(target, line, true, value)) return false;
+        long long words = (value - (long long)from) / 4;
+        if((value & 3) != 0 || words < -32768 || words > 32767) {
+            error(line, "branch target out of range");
+            return false;
+        }
+        offset = words;
+        return true;
+    };
+    auto immediate = [&](string_view text, long long low, long long high, int& out) {
+        if(!expression(text, line, true, value)) return false;
+        if(value < low || value > high) {
+            error(line, "immediate out of range");
+            return false;
+        }
+        out = value;
+        return true;
+    };
+
+    int imm = 0;
+    switch(m->format) {
+        case FMT_RD_RS_RT:
+            if(register_operand(operands[0], line, rd) && register_operand(operands[1], line, rs) &&
+               register_operand(operands[2], line, rt))
+                emit(pc, Utilities::R_instruction(OP_SPECIAL, rd, rs, rt, 0, m->func));
+            break;
+        case FMT_RD_RT_SA:
+            if(register_operand(operands[0], line, rd) && register_operand(operands[1], line, rt) &&
+               immediate(operands[2], 0, 31, imm))
+                emit(pc, Utilities::R_instruction(OP_SPECIAL, rd, 0, rt, imm, m->func));
+            break;
+        case FMT_RD_RT_RS:
+            if(register_operand(operands[0], line, rd) && register_operand(operands[1], line, rt) &&
+               register_operand(operands[2], line, rs))
+                emit(pc, Utilities::R_instruction(OP_SPECIAL, rd, rs, rt, 0, m->func));
+            break;
+        case FMT_RS_RT:
+            if(register_operand(operands[0], line, rs) && register_operand(operands[1], line, rt))
+                emit(pc, Utilities::R_instruction(OP_SPECIAL, 0, rs, rt, 0, m->func));
+            break;
+        case FMT_RS:
+            if(register_operand(operands[0], line, rs)) emit(pc, Utilities::R_instruction(OP_SPECIAL, 0, rs, 0, 0, m->func));
+            break;
+        case FMT_JALR:
+            // step() always links into $31
+            if(register_operand(operands[0], line, rs)) emit(pc, Utilities::R_instruction(OP_SPECIAL, 31, rs, 0, 0, m->func));
+            break;
+        case FMT_RD:
+            if(register_operand(operands[0], line, rd)) emit(pc, Utilities::R_instruction(OP_SPECIAL, rd, 0, 0, 0, m->func));
+            break;
+        case FMT_NONE:
+            emit(pc, Utilities::R_instruction(OP_SPECIAL, 0, 0, 0, 0, m->func));
+            break;
+        case FMT_BREAK:
+            if(count == 0 || immediate(operands[0], 0, (1 << 20) - 1, imm))
+                emit(pc, Utilities::R_instruction(OP_SPECIAL, imm >> 5, imm >> 15, imm >> 10, imm, m->func));
+            break;
+        case FMT_IMM:
+        case FMT_UIMM: {
+            long long low = m->format == FMT_IMM ? -32768 : 0;
+            long long high = m->format == FMT_IMM ? 32767 : 0xffff;
+            if(register_operand(operands[0], line, rt) && register_operand(operands[1], line, rs) &&
+               immediate(operands[2], low, high, imm))
+                emit(pc, Utilities::I_instruction(m->opcode, rt, rs, imm));
+            break;
+        }
+        case FMT_LUI:
+            if(register_operand(operands[0], line, rt) && immediate(operands[1], 0, 0xffff, imm))
+                emit(pc, Utilities::I_instruction(m->opcode, rt, 0, imm));
+            break;
+        case FMT_MEMORY:
+            if(register_operand(operands[0], line, rt) && memory_operand(operands[1], line, imm, rs))
+                emit(pc, Utilities::I_instruction(m->opcode, rt, rs, imm));
+            break;
+        case FMT_BRANCH2:
+            if(register_operand(operands[0], line, rs) && register_operand(operands[1], line, rt) &&
+               branch_offset(operands[2], pc, imm))
+                emit(pc, Utilities::I_instruction(m->opcode, rt, rs, imm));
+            break;
+        case FMT_BRANCH1:
+            if(register_operand(operands[0], line, rs) && branch_offset(operands[1], pc, imm))
+                emit(pc, Utilities::I_instruction(m->opcode, 0, rs, imm));
+            break;
+        case FMT_JUMP:
+            if(!expression(operands[0], line, true, value)) break;
+            if((value & 3) != 0 || value < 0 || value >> 2 > 0x3FFFFFF) error(line, "jump target out of range");
+            else emit(pc, Utilities::J_instruction(m->opcode, value >> 2));
+            break;
+        case P_NOP:
+            emit(pc, 0);
+            break;
+        case P_MOVE:
+            if(register_operand(operands[0], line, rd) && register_operand(operands[1], line, rs))
+                emit(pc, Utilities::R_instruction(OP_SPECIAL, rd, rs, 0, 0, FUNC_ADDU));
+            break;
+        case P_LI:
+            if(!register_operand(operands[0], line, rt) || !expression(operands[1], line, false, value)) break;
+            if(value < -(1LL << 31) || value > 0xffffffffLL) {
+                error(line, "immediate out of range");
+            } else if(value >= -32768 && value <= 32767) {
+                emit(pc, Utilities::I_instruction(OP_ADDIU, rt, 0, value));
+            } else if(value >= 0 && value <= 0xffff) {
+                emit(pc, Utilities::I_instruction(OP_ORI, rt, 0, value));
+            } else {
+                emit(pc, Utilities::I_instruction(OP_LUI, rt, 0, (WORD)value >> 16));
+                if(li_words(value) == 2) emit(pc + 4, Utilities::I_instruction(OP_ORI, rt, rt, value & 0xffff));
+            }
+            break;
+        case P_LA:
+            if(register_operand(operands[0], line, rt) && expression(operands[1], line, true, value)) {
+                emit(pc, Utilities::I_instruction(OP_LUI, rt, 0, (WORD)value >> 16));
+                emit(pc + 4, Utilities::I_instruction(OP_ORI, rt, rt, value & 0xffff));
+            }
+            break;
+        case P_B:
+            if(branch_offset(operands[0], pc, imm)) emit(pc, Utilities::I_instruction(OP_BEQ, 0, 0, imm));
+            break;
+        case P_BRANCH_ZERO:
+            if(register_operand(operands[0], line, rs) && branch_offset(operands[1], pc, imm))
+                emit(pc, Utilities::I_instruction(m->opcode, 0, rs, imm));
+            break;
+        case P_COMPARE:
+            // slt $at, then a branch on $at from the next word
+            if(register_operand(operands[0], line, rs) && register_operand(operands[1], line, rt) &&
+               branch_offset(operands[2], pc + 4, imm)) {
+                if(m->func) swap(rs, rt);
+                emit(pc, Utilities::R_instruction(OP_SPECIAL, AT, rs, rt, 0, FUNC_SLT));
+                emit(pc + 4, Utilities::I_instruction(m->opcode, 0, AT, imm));
+            }
+            break;
+        case P_UNARY:
+            if(register_operand(operands[0], line, rd) && register_operand(operands[1], line, rs)) {
+                if(m->func == FUNC_NOR) emit(pc, Utilities::R_instruction(OP_SPECIAL, rd, rs, 0, 0, m->func));
+                else emit(pc, Utilities::R_instruction(OP_SPECIAL, rd, 0, rs, 0, m->func));
+            }
+            break;
+    }
+}
+
+void Assembler::second_pass(const vector<Statement>& statements) {
+    size_t end = max((size_t)text_start + text_bytes, data_bytes > 0 ? (size_t)data_start + data_bytes : 0);
+    bytes.assign(end, 0);
+
+    for(const Statement& statement : statements) {
+        if(statement.mnemonic != NULL) encode(statement);
+        else data(statement);
+        if(error_list.size() >= config.max_errors) return;
+    }
+}
+
+bool Assembler::assemble(string_view source) {
+    bytes.clear();
+    table = SymbolTable();
+    labels.clear();
+    error_list.clear();
+
+    vector<Statement> statements;
+    statements.reserve(source.size() / 32);
+    if(first_pass(source, statements)) second_pass(statements);
+
+    auto main = labels.find("main");
+    entry_point = main != labels.end() ? main->second : text_start;
+    // The names point into the source
+    labels.clear();
+    return error_list.empty();
+}
+
+bool Assembler::assemble_file(const char* path) {
+    FILE* in = fopen(path, "rb");
+    if(in == NULL) {
+        error_list.assign(1, string(path) + ": " + strerror(errno));
+        return false;
+    }
+
+    string source;
+    char buffer[1 << 16];
+    size_t n;
+    while((n = fread(buffer, 1, sizeof(buffer), in)) > 0) source.append(buffer, n);
+    fclose(in);
+    return assemble(source);
+}
+
+Emulator* Assembler::load(size_t memory_size) const {
+    if(bytes.size() > memory_size) return NULL;
+
+    Emulator* emulator = new Emulator(memory_size);
+    memcpy(emulator->get_memory(), bytes.data(), bytes.size());
+    emulator->state().PC = entry_point;
+    return emulator;
+}
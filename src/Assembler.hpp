@@ -0,0 +1,78 @@
+#ifndef ASSEMBLER_HPP
+#define ASSEMBLER_HPP
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Emulator.hpp"
+#include "Symbols.hpp"
+
+struct AssemblerConfig {
+    ADDRESS text_address = 0;
+    // 0 puts the data on the page after the text
+    ADDRESS data_address = 0;
+    // Assembly stops once this many errors have been found
+    size_t max_errors = 20;
+};
+
+// Two-pass assembler for MIPS source text.
+//
+// The first pass splits the source into statements, defines labels and sizes everything; the
+// second encodes, resolving labels. Branch offsets are counted in words from the branch itself,
+// as step() executes them (no delay slots).
+//
+// Accepted: every instruction step() executes; the pseudo-instructions nop, move, li, la, b,
+// beqz, bnez, blt, bge, bgt, ble, neg, negu and not ($at is the scratch register); the directives
+// .text, .data, .word, .half, .byte, .ascii, .asciiz, .space, .align and .globl; labels; registers
+// by number or name; decimal, hex and character literals, and label +/- constant expressions.
+// Comments start with #.
+class Assembler {
+    struct Statement;
+
+    AssemblerConfig config;
+    std::vector<BYTE> bytes;
+    SymbolTable table;
+    std::unordered_map<std::string_view, ADDRESS> labels;
+    std::vector<std::string> error_list;
+    ADDRESS text_start, data_start;
+    size_t text_bytes, data_bytes;
+    ADDRESS entry_point;
+
+    void error(size_t line, const std::string& message);
+    bool first_pass(std::string_view source, std::vector<Statement>& statements);
+    void second_pass(const std::vector<Statement>& statements);
+    void encode(const Statement& statement);
+    void data(const Statement& statement);
+    void emit(ADDRESS address, WORD word);
+
+    bool expression(std::string_view text, size_t line, bool labels_allowed, long long& value);
+    bool register_operand(std::string_view text, size_t line, int& number);
+    bool memory_operand(std::string_view text, size_t line, int& offset, int& base);
+
+    public:
+    Assembler(const AssemblerConfig& config = AssemblerConfig());
+
+    // False if there were errors; the source must stay alive until it returns
+    bool assemble(std::string_view source);
+    bool assemble_file(const char* path);
+
+    // Bytes from address 0 to the end of the data, text and data included
+    const std::vector<BYTE>& image() const { return bytes; }
+    const SymbolTable& symbols() const { return table; }
+    // "line N: message" for every error found
+    const std::vector<std::string>& errors() const { return error_list; }
+
+    // The label main if there is one, else the start of the text
+    ADDRESS entry() const { return entry_point; }
+    ADDRESS text_address() const { return text_start; }
+    ADDRESS data_address() const { return data_start; }
+    size_t text_size() const { return text_bytes; }
+    size_t data_size() const { return data_bytes; }
+
+    // A new emulator holding the image with PC at the entry point; NULL if it does not fit
+    Emulator* load(size_t memory_size) const;
+};
+
+#endif
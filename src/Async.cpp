@@ -0,0 +1,87 @@
+#include <algorithm>
+
+#include "Async.hpp"
+
+void RunFor::await_suspend(std::coroutine_handle<> handle) {
+    Scheduler& scheduler = emulator.scheduler;
+
+    while(result.executed < budget) {
+        int status = emulator.step();
+        result.executed++;
+
+        if(status == STEP_SYSCALL && scheduler.on_host_call) {
+            // Park the guest until the host completes the call
+            HostCall& call = emulator.call;
+            call.emulator = &emulator;
+            call.number = emulator.get_register(2);
+            for(int i = 0; i < 4; i++) {
+                call.args[i] = emulator.get_register(4 + i);
+            }
+            call.waiting = handle;
+            scheduler.waiting++;
+            scheduler.on_host_call(call);
+            return;
+        }
+
+        if(status != STEP_OK) {
+            result.status = status;
+            break;
+        }
+    }
+
+    scheduler.ready.push_back(handle);
+}
+
+AsyncEmulator::AsyncEmulator(Scheduler& scheduler, size_t mem_size)
+    : Emulator(mem_size), scheduler(scheduler), call() {}
+
+AsyncEmulator::AsyncEmulator(Scheduler& scheduler, size_t mem_size, WORD* program, size_t program_size)
+    : Emulator(mem_size, program, program_size), scheduler(scheduler), call() {}
+
+Scheduler::Scheduler() : waiting(0) {}
+
+Scheduler::~Scheduler() {
+    for(auto task : tasks) {
+        task.destroy();
+    }
+}
+
+void Scheduler::spawn(Task task) {
+    tasks.push_back(task.handle);
+    ready.push_back(task.handle);
+}
+
+// Returns the result to the guest in $v0 and makes it runnable again
+void Scheduler::complete(HostCall& call, WORD result) {
+    std::coroutine_handle<> handle = call.waiting;
+    call.waiting = nullptr;
+    call.emulator->set_register(2, result);
+    waiting--;
+    ready.push_back(handle);
+}
+
+bool Scheduler::run_once() {
+    size_t count = ready.size();
+    if(count == 0) return false;
+
+    // Guests re-queued while resuming run on the next round
+    for(size_t i = 0; i < count; i++) {
+        std::coroutine_handle<> handle = ready.front();
+        ready.pop_front();
+        handle.resume();
+
+        if(handle.done()) {
+            auto it = std::find_if(tasks.begin(), tasks.end(), [&](auto task) {
+                return task.address() == handle.address();
+            });
+            it->destroy();
+            tasks.erase(it);
+        }
+    }
+
+    return true;
+}
+
+void Scheduler::run() {
+    while(run_once());
+}
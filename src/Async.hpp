@@ -0,0 +1,103 @@
+#ifndef ASYNC_HPP
+#define ASYNC_HPP
+
+#include <coroutine>
+#include <deque>
+#include <functional>
+
+#include "Emulator.hpp"
+
+class Scheduler;
+class AsyncEmulator;
+
+// A guest coroutine. Tasks start suspended and are driven by the Scheduler they are spawned on,
+// which also destroys them once they finish.
+class Task {
+    public:
+    struct promise_type {
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { throw; }
+    };
+
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+    private:
+    std::coroutine_handle<promise_type> handle;
+    friend class Scheduler;
+};
+
+// Request made by a guest through `syscall`: $v0 holds the call number and $a0-$a3 its arguments.
+// The guest stays suspended until the host calls Scheduler::complete() on it.
+struct HostCall {
+    AsyncEmulator* emulator;
+    WORD number;
+    WORD args[4];
+    std::coroutine_handle<> waiting;
+};
+
+// Outcome of `co_await emu.run_for(n)`
+struct Slice {
+    int status;      // STEP_OK if the whole slice ran, otherwise the result of the last step()
+    size_t executed; // instructions executed, including a serviced syscall
+};
+
+class RunFor {
+    AsyncEmulator& emulator;
+    size_t budget;
+    Slice result;
+
+    public:
+    RunFor(AsyncEmulator& emulator, size_t budget) : emulator(emulator), budget(budget), result{STEP_OK, 0} {}
+
+    bool await_ready() { return budget == 0; }
+    void await_suspend(std::coroutine_handle<> handle);
+    Slice await_resume() { return result; }
+};
+
+class AsyncEmulator : public Emulator {
+    Scheduler& scheduler;
+    HostCall call;
+
+    friend class RunFor;
+
+    public:
+    AsyncEmulator(Scheduler& scheduler, size_t mem_size);
+    AsyncEmulator(Scheduler& scheduler, size_t mem_size, WORD* program, size_t program_size);
+
+    // Executes up to n instructions, then suspends so other guests can run. Stops early on a
+    // trap or break; a syscall suspends the guest until the host completes it.
+    RunFor run_for(size_t n) { return RunFor(*this, n); }
+};
+
+// Runs any number of guests on the calling thread, round-robin, one slice at a time.
+class Scheduler {
+    std::deque<std::coroutine_handle<>> ready;
+    std::deque<std::coroutine_handle<Task::promise_type>> tasks;
+    size_t waiting;
+
+    friend class RunFor;
+
+    public:
+    // Called when a guest issues a syscall. The handler may complete the call immediately or
+    // later (e.g. from an I/O callback). Without a handler, run_for() returns STEP_SYSCALL.
+    std::function<void(HostCall&)> on_host_call;
+
+    Scheduler();
+    ~Scheduler();
+
+    void spawn(Task task);
+    void complete(HostCall& call, WORD result);
+
+    // Resumes each guest that is ready once; returns false when none were ready
+    bool run_once();
+    // Runs until every guest has finished or is waiting on a host call
+    void run();
+
+    size_t pending_calls() { return waiting; }
+    size_t active_tasks() { return tasks.size(); }
+};
+
+#endif
@@ -0,0 +1,258 @@
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "BranchPredictor.hpp"
+#include "Instruction.hpp"
+
+using namespace std;
+
+static const int HISTORY_LENGTHS[] = {5, 11, 22, 44};
+
+static bool counter_taken(BYTE counter) {
+    return counter >= 2;
+}
+
+static void train(BYTE& counter, bool taken) {
+    if(taken && counter < 3) counter++;
+    if(!taken && counter > 0) counter--;
+}
+
+BimodalPredictor::BimodalPredictor(int index_bits) : counters(1 << index_bits, 1), mask((1 << index_bits) - 1) {}
+
+bool BimodalPredictor::predict(ADDRESS pc) {
+    return counter_taken(counters[(pc >> 2) & mask]);
+}
+
+void BimodalPredictor::update(ADDRESS pc, bool taken) {
+    train(counters[(pc >> 2) & mask], taken);
+}
+
+GsharePredictor::GsharePredictor(int index_bits)
+    : counters(1 << index_bits, 1), mask((1 << index_bits) - 1), history(0) {}
+
+bool GsharePredictor::predict(ADDRESS pc) {
+    return counter_taken(counters[((pc >> 2) ^ history) & mask]);
+}
+
+void GsharePredictor::update(ADDRESS pc, bool taken) {
+    train(counters[((pc >> 2) ^ history) & mask], taken);
+    history = (history << 1) | taken;
+}
+
+// Xors the newest `length` bits of history down to `bits` bits
+static WORD fold(DWORD history, int length, int bits) {
+    DWORD h = length < 64 ? history & ((1ULL << length) - 1) : history;
+    WORD folded = 0;
+    for(; h != 0; h >>= bits) folded ^= h & ((1 << bits) - 1);
+    return folded;
+}
+
+TagePredictor::TagePredictor() : base(12), history(0), updates(0), allocation_seed(1) {
+    for(int t = 0; t < TABLES; t++) tables[t].assign(1 << INDEX_BITS, Entry{0, 0, 0});
+}
+
+void TagePredictor::compute(ADDRESS pc) {
+    WORD p = pc >> 2;
+    provider = -1;
+    int alternate = -1;
+
+    for(int t = 0; t < TABLES; t++) {
+        indices[t] = (p ^ (p >> INDEX_BITS) ^ fold(history, HISTORY_LENGTHS[t], INDEX_BITS)) & ((1 << INDEX_BITS) - 1);
+        tags[t] = (p ^ fold(history, HISTORY_LENGTHS[t], TAG_BITS) ^ (fold(history, HISTORY_LENGTHS[t], TAG_BITS - 1) << 1)) &
+                  ((1 << TAG_BITS) - 1);
+    }
+    for(int t = TABLES - 1; t >= 0; t--) {
+        if(tables[t][indices[t]].tag != tags[t]) continue;
+        if(provider < 0) {
+            provider = t;
+        } else {
+            alternate = t;
+            break;
+        }
+    }
+
+    alternate_prediction = alternate >= 0 ? tables[alternate][indices[alternate]].counter >= 0 : base.predict(pc);
+    provider_prediction = provider >= 0 ? tables[provider][indices[provider]].counter >= 0 : alternate_prediction;
+}
+
+bool TagePredictor::predict(ADDRESS pc) {
+    compute(pc);
+    return provider_prediction;
+}
+
+void TagePredictor::update(ADDRESS pc, bool taken) {
+    if(provider >= 0) {
+        Entry& entry = tables[provider][indices[provider]];
+        if(taken && entry.counter < 3) entry.counter++;
+        if(!taken && entry.counter > -4) entry.counter--;
+        if(provider_prediction != alternate_prediction) {
+            if(provider_prediction == taken && entry.useful < 3) entry.useful++;
+            if(provider_prediction != taken && entry.useful > 0) entry.useful--;
+        }
+    } else {
+        base.update(pc, taken);
+    }
+
+    // On a misprediction, take over a not-useful entry in a longer table, starting from a
+    // pseudo-randomly chosen one so that allocations spread out
+    if(provider_prediction != taken && provider < TABLES - 1) {
+        allocation_seed = allocation_seed * 1103515245 + 12345;
+        int first = provider + 1 + ((allocation_seed >> 16) & 1);
+        if(first >= TABLES) first = provider + 1;
+
+        bool allocated = false;
+        for(int t = first; t < TABLES && !allocated; t++) {
+            Entry& entry = tables[t][indices[t]];
+            if(entry.useful == 0) {
+                entry = Entry{(unsigned short)tags[t], (signed char)(taken ? 0 : -1), 0};
+                allocated = true;
+            }
+        }
+        if(!allocated) {
+            for(int t = provider + 1; t < TABLES; t++) {
+                BYTE& useful = tables[t][indices[t]].useful;
+                if(useful > 0) useful--;
+            }
+        }
+    }
+
+    // Age useful bits so stale entries can be replaced
+    if((++updates & ((1 << 18) - 1)) == 0) {
+        for(auto& table : tables) {
+            for(Entry& entry : table) entry.useful >>= 1;
+        }
+    }
+
+    history = (history << 1) | taken;
+}
+
+BranchSimulator::BranchSimulator(DirectionPredictor* predictor, size_t btb_entries, size_t ras_depth)
+    : predictor(predictor) {
+    if(btb_entries == 0 || (btb_entries & (btb_entries - 1)) != 0)
+        throw invalid_argument("BTB entries must be a power of two");
+    if(ras_depth == 0) throw invalid_argument("return-address stack depth must be at least one");
+
+    btb.resize(btb_entries);
+    ras.resize(ras_depth);
+    clear();
+}
+
+void BranchSimulator::clear() {
+    for(BtbEntry& entry : btb) entry = BtbEntry{0, 0, false};
+    ras_top = 0;
+    ras_size = 0;
+    sites.clear();
+    instructions = 0;
+    for(int k = 0; k < BRANCH_KINDS; k++) {
+        branches[k] = 0;
+        mispredictions[k] = 0;
+    }
+}
+
+// Looks up the BTB and trains it with the real target
+bool BranchSimulator::predict_target(ADDRESS pc, ADDRESS target) {
+    BtbEntry& entry = btb[(pc >> 2) & (btb.size() - 1)];
+    bool hit = entry.valid && entry.pc == pc && entry.target == target;
+    entry = BtbEntry{pc, target, true};
+    return hit;
+}
+
+// The return-address stack is circular: overflowing it loses the oldest entries
+void BranchSimulator::push_return(ADDRESS address) {
+    ras[ras_top] = address;
+    ras_top = (ras_top + 1) % ras.size();
+    if(ras_size < ras.size()) ras_size++;
+}
+
+ADDRESS BranchSimulator::pop_return() {
+    if(ras_size == 0) return -1;
+    ras_top = (ras_top + ras.size() - 1) % ras.size();
+    ras_size--;
+    return ras[ras_top];
+}
+
+void BranchSimulator::after(const Instruction& instruction, ADDRESS pc, const CPUState& cpu, int status) {
+    instructions++;
+    if(status != STEP_OK) return;
+
+    ADDRESS target = cpu.PC;
+    BranchKind kind;
+    bool correct;
+
+    if(instruction.is_conditional_branch()) {
+        kind = BRANCH_CONDITIONAL;
+        bool taken = target != pc + 4;
+        correct = predictor->predict(pc) == taken;
+        predictor->update(pc, taken);
+    } else if(instruction.is_jump()) {
+        kind = instruction.opcode == OP_JAL ? BRANCH_CALL : BRANCH_JUMP;
+        predict_target(pc, target);
+        correct = true;
+    } else if(instruction.is_return()) {
+        kind = BRANCH_RETURN;
+        correct = pop_return() == target;
+    } else if(instruction.is_indirect()) {
+        kind = instruction.func == FUNC_JALR ? BRANCH_CALL : BRANCH_INDIRECT;
+        correct = predict_target(pc, target);
+    } else {
+        return;
+    }
+
+    if(instruction.is_call()) push_return(pc + 4);
+
+    Site& site = sites[pc];
+    site.kind = kind;
+    site.executed++;
+    site.taken += target != pc + 4;
+    site.mispredicted += !correct;
+    branches[kind]++;
+    mispredictions[kind] += !correct;
+}
+
+DWORD BranchSimulator::total_branches() {
+    DWORD total = 0;
+    for(int k = 0; k < BRANCH_KINDS; k++) total += branches[k];
+    return total;
+}
+
+DWORD BranchSimulator::total_mispredictions() {
+    DWORD total = 0;
+    for(int k = 0; k < BRANCH_KINDS; k++) total += mispredictions[k];
+    return total;
+}
+
+DWORD BranchSimulator::mispredictions_at(ADDRESS pc) {
+    auto it = sites.find(pc);
+    return it != sites.end() ? it->second.mispredicted : 0;
+}
+
+double BranchSimulator::mpki() {
+    return instructions ? 1000.0 * total_mispredictions() / instructions : 0;
+}
+
+void BranchSimulator::report(FILE* out, const SymbolTable* symbols, size_t top) {
+    static const char* kind_names[BRANCH_KINDS] = {"conditional", "jump", "call", "return", "indirect"};
+
+    fprintf(out, "Predictor: %s\nInstructions: %llu\nBranches: %llu\nMispredictions: %llu (%.3f MPKI)\n\n",
+            predictor->name(), instructions, total_branches(), total_mispredictions(), mpki());
+    for(int k = 0; k < BRANCH_KINDS; k++) {
+        if(branches[k] == 0) continue;
+        fprintf(out, "  %-12s %12llu branches %12llu mispredicted %7.2f%%\n", kind_names[k], branches[k],
+                mispredictions[k], 100.0 * mispredictions[k] / branches[k]);
+    }
+
+    vector<pair<ADDRESS, Site>> sorted(sites.begin(), sites.end());
+    stable_sort(sorted.begin(), sorted.end(), [](auto& a, auto& b) {
+        if(a.second.mispredicted != b.second.mispredicted) return a.second.mispredicted > b.second.mispredicted;
+        return a.first < b.first;
+    });
+
+    fprintf(out, "\nMispredictions by address:\n");
+    for(size_t i = 0; i < sorted.size() && i < top && sorted[i].second.mispredicted > 0; i++) {
+        Site& site = sorted[i].second;
+        string name = symbols != NULL ? symbols->describe(sorted[i].first) : "";
+        fprintf(out, "  %10llu / %10llu %6.2f%%  %-11s 0x%08x  %s\n", site.mispredicted, site.executed,
+                100.0 * site.mispredicted / site.executed, kind_names[site.kind], sorted[i].first, name.c_str());
+    }
+}
@@ -0,0 +1,139 @@
+#ifndef BRANCHPREDICTOR_HPP
+#define BRANCHPREDICTOR_HPP
+
+#include <cstdio>
+#include <unordered_map>
+#include <vector>
+
+#include "Emulator.hpp"
+#include "Observer.hpp"
+#include "Symbols.hpp"
+
+// Direction predictor for conditional branches. update() is always called with the outcome right
+// after predict() for the same branch, so predictors can keep state between the two.
+class DirectionPredictor {
+    public:
+    virtual ~DirectionPredictor() {}
+    virtual const char* name() = 0;
+    virtual bool predict(ADDRESS pc) = 0;
+    virtual void update(ADDRESS pc, bool taken) = 0;
+};
+
+// Table of 2-bit saturating counters indexed by PC
+class BimodalPredictor : public DirectionPredictor {
+    std::vector<BYTE> counters;
+    WORD mask;
+
+    public:
+    BimodalPredictor(int index_bits = 12);
+    const char* name() { return "bimodal"; }
+    bool predict(ADDRESS pc);
+    void update(ADDRESS pc, bool taken);
+};
+
+// 2-bit counters indexed by PC xor global history
+class GsharePredictor : public DirectionPredictor {
+    std::vector<BYTE> counters;
+    WORD mask;
+    WORD history;
+
+    public:
+    GsharePredictor(int index_bits = 12);
+    const char* name() { return "gshare"; }
+    bool predict(ADDRESS pc);
+    void update(ADDRESS pc, bool taken);
+};
+
+// Small TAGE: a bimodal base and tagged tables over geometrically longer global histories. The
+// longest matching table provides the prediction, and a misprediction allocates in a longer one.
+class TagePredictor : public DirectionPredictor {
+    static const int TABLES = 4;
+    static const int INDEX_BITS = 10;
+    static const int TAG_BITS = 9;
+
+    struct Entry {
+        unsigned short tag;
+        signed char counter; // -4..3, taken when >= 0
+        BYTE useful;         // 0..3
+    };
+
+    BimodalPredictor base;
+    std::vector<Entry> tables[TABLES];
+    DWORD history;
+    DWORD updates;
+    WORD allocation_seed;
+
+    // Filled by predict() for update()
+    WORD indices[TABLES];
+    WORD tags[TABLES];
+    int provider;
+    bool provider_prediction;
+    bool alternate_prediction;
+
+    void compute(ADDRESS pc);
+
+    public:
+    TagePredictor();
+    const char* name() { return "tage"; }
+    bool predict(ADDRESS pc);
+    void update(ADDRESS pc, bool taken);
+};
+
+enum BranchKind { BRANCH_CONDITIONAL, BRANCH_JUMP, BRANCH_CALL, BRANCH_RETURN, BRANCH_INDIRECT, BRANCH_KINDS };
+
+// Branch prediction model for guest code: conditional branches go to a DirectionPredictor, returns
+// to a return-address stack, and jr/jalr to other targets to a BTB. Direct j/jal targets are known
+// at decode and never mispredict, but still fill the BTB and (jal) the return-address stack. Runs
+// as an observer of BasicEmulator::run(); each prediction only uses what was known before the
+// branch, and is then checked against where it went.
+class BranchSimulator final : public ExecutionObserver {
+    struct BtbEntry {
+        ADDRESS pc;
+        ADDRESS target;
+        bool valid;
+    };
+
+    struct Site {
+        BranchKind kind;
+        DWORD executed;
+        DWORD taken;
+        DWORD mispredicted;
+    };
+
+    DirectionPredictor* predictor;
+    std::vector<BtbEntry> btb;
+    std::vector<ADDRESS> ras;
+    size_t ras_top;
+    size_t ras_size;
+
+    std::unordered_map<ADDRESS, Site> sites;
+    DWORD instructions;
+    DWORD branches[BRANCH_KINDS];
+    DWORD mispredictions[BRANCH_KINDS];
+
+    bool predict_target(ADDRESS pc, ADDRESS target);
+    void push_return(ADDRESS address);
+    ADDRESS pop_return();
+
+    public:
+    // The predictor is owned by the caller. Throws std::invalid_argument unless btb_entries is a
+    // power of two and ras_depth at least one
+    BranchSimulator(DirectionPredictor* predictor, size_t btb_entries = 512, size_t ras_depth = 16);
+
+    void after(const Instruction& instruction, ADDRESS pc, const CPUState& cpu, int status);
+
+    DWORD total_instructions() { return instructions; }
+    DWORD total_branches();
+    DWORD total_mispredictions();
+    DWORD branches_of(BranchKind kind) { return branches[kind]; }
+    DWORD mispredictions_of(BranchKind kind) { return mispredictions[kind]; }
+    DWORD mispredictions_at(ADDRESS pc);
+    // Mispredictions per thousand instructions
+    double mpki();
+
+    void clear();
+    // Totals per kind and the top PCs by mispredictions
+    void report(FILE* out, const SymbolTable* symbols, size_t top);
+};
+
+#endif
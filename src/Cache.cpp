@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "Cache.hpp"
+#include "Instruction.hpp"
+
+using namespace std;
+
+static bool power_of_two(size_t n) {
+    return n != 0 && (n & (n - 1)) == 0;
+}
+
+Cache::Cache(const char* name, const CacheConfig& config, Cache* next)
+    : level_name(name), config(config), next(next), clock(0), seed(1) {
+    if(config.line <= 0 || !power_of_two(config.line) || config.size == 0 || config.size % config.line != 0)
+        throw invalid_argument(level_name + ": line size must be a power of two dividing the cache size");
+    size_t count = config.size / config.line;
+    if(config.ways < 1 || (size_t)config.ways > count || count % config.ways != 0 || !power_of_two(count / config.ways))
+        throw invalid_argument(level_name + ": ways must split the lines into a power-of-two number of sets");
+
+    lines.assign(config.size / config.line, Line{0, 0, false, false});
+    sets = lines.size() / config.ways;
+    line_bits = __builtin_ctz(config.line);
+    clear_stats();
+}
+
+void Cache::clear_stats() {
+    counts = CacheStats{0, 0, 0, 0, 0};
+}
+
+double Cache::miss_rate() {
+    DWORD accesses = counts.reads + counts.writes;
+    return accesses ? (double)(counts.read_misses + counts.write_misses) / accesses : 0;
+}
+
+Cache::Line* Cache::victim(Line* set) {
+    for(int w = 0; w < config.ways; w++) {
+        if(!set[w].valid) return &set[w];
+    }
+    if(config.replacement == REPLACE_RANDOM) {
+        seed = seed * 1103515245 + 12345;
+        return &set[(seed >> 16) % config.ways];
+    }
+
+    // LRU and FIFO differ only in when the stamp is set
+    Line* oldest = &set[0];
+    for(int w = 1; w < config.ways; w++) {
+        if(set[w].stamp < oldest->stamp) oldest = &set[w];
+    }
+    return oldest;
+}
+
+bool Cache::access(ADDRESS address, bool write) {
+    ADDRESS block = address >> line_bits;
+    Line* set = &lines[(block % sets) * config.ways];
+    clock++;
+
+    if(write) counts.writes++;
+    else counts.reads++;
+
+    for(int w = 0; w < config.ways; w++) {
+        Line& line = set[w];
+        if(!line.valid || line.tag != block) continue;
+
+        if(config.replacement == REPLACE_LRU) line.stamp = clock;
+        if(write) {
+            if(config.write == WRITE_BACK) line.dirty = true;
+            else if(next != NULL) next->access(address, true);
+        }
+        return true;
+    }
+
+    if(write) counts.write_misses++;
+    else counts.read_misses++;
+
+    if(write && !config.write_allocate) {
+        if(next != NULL) next->access(address, true);
+        return false;
+    }
+
+    Line* line = victim(set);
+    if(line->valid && line->dirty) {
+        counts.writebacks++;
+        if(next != NULL) next->access(line->tag << line_bits, true);
+    }
+    if(next != NULL) next->access(block << line_bits, false);
+
+    *line = Line{block, clock, true, write && config.write == WRITE_BACK};
+    if(write && config.write == WRITE_THROUGH && next != NULL) next->access(address, true);
+    return false;
+}
+
+bool Cache::access(ADDRESS address, int size, bool write) {
+    bool hit = true;
+    ADDRESS last = (address + size - 1) >> line_bits;
+    for(ADDRESS block = address >> line_bits; block <= last; block++) {
+        hit &= access(block == address >> line_bits ? address : block << line_bits, write);
+    }
+    return hit;
+}
+
+void Cache::flush() {
+    for(Line& line : lines) {
+        if(line.valid && line.dirty) {
+            counts.writebacks++;
+            if(next != NULL) next->access(line.tag << line_bits, true);
+        }
+        line = Line{0, 0, false, false};
+    }
+}
+
+CacheConfig CacheSimulator::l2_defaults() {
+    CacheConfig config;
+    config.size = 256 * 1024;
+    config.ways = 8;
+    config.line = 64;
+    return config;
+}
+
+CacheSimulator::CacheSimulator(const CacheConfig& l1i, const CacheConfig& l1d, const CacheConfig& l2)
+    : l2_cache("L2", l2), l1i_cache("L1I", l1i, &l2_cache), l1d_cache("L1D", l1d, &l2_cache) {}
+
+void CacheSimulator::before(const Instruction& instruction, ADDRESS pc, const CPUState& cpu) {
+    bool fetch_hit = l1i_cache.access(pc, 4, false);
+    if(!fetch_hit) sites[pc].fetch_misses++;
+
+    if(instruction.is_load() || instruction.is_store()) {
+        // Before step(), which may overwrite rs
+        ADDRESS address = cpu.gpr[instruction.rs] + instruction.se_imm;
+        int size = instruction.access_size();
+        // lwl and lwr only touch the aligned word
+        if(instruction.opcode == OP_LWL || instruction.opcode == OP_LWR) address &= ~3;
+
+        bool hit = l1d_cache.access(address, size, instruction.is_store());
+        Site& site = sites[pc];
+        site.accesses++;
+        site.misses += !hit;
+    }
+}
+
+DWORD CacheSimulator::data_misses_at(ADDRESS pc) {
+    auto it = sites.find(pc);
+    return it != sites.end() ? it->second.misses : 0;
+}
+
+void CacheSimulator::report(FILE* out, const SymbolTable* symbols, size_t top) {
+    for(Cache* cache : {&l1i_cache, &l1d_cache, &l2_cache}) {
+        const CacheStats& s = cache->stats();
+        const CacheConfig& c = cache->configuration();
+        fprintf(out, "%-4s %6zu KiB %2d-way %3dB lines: %12llu reads %10llu misses, %12llu writes %10llu misses, "
+                     "%10llu writebacks, %6.2f%% miss rate\n",
+                cache->name().c_str(), c.size / 1024, c.ways, c.line, s.reads, s.read_misses, s.writes, s.write_misses,
+                s.writebacks, 100 * cache->miss_rate());
+    }
+
+    vector<pair<ADDRESS, Site>> sorted(sites.begin(), sites.end());
+    stable_sort(sorted.begin(), sorted.end(), [](auto& a, auto& b) {
+        DWORD a_misses = a.second.misses + a.second.fetch_misses, b_misses = b.second.misses + b.second.fetch_misses;
+        if(a_misses != b_misses) return a_misses > b_misses;
+        return a.first < b.first;
+    });
+
+    fprintf(out, "\nL1 misses by address:\n  %10s %23s\n", "L1I", "L1D");
+    for(size_t i = 0; i < sorted.size() && i < top; i++) {
+        Site& site = sorted[i].second;
+        if(site.misses + site.fetch_misses == 0) break;
+        string name = symbols != NULL ? symbols->describe(sorted[i].first) : "";
+        fprintf(out, "  %10llu %10llu / %10llu  0x%08x  %s\n", site.fetch_misses, site.misses, site.accesses,
+                sorted[i].first, name.c_str());
+    }
+}
@@ -0,0 +1,108 @@
+#ifndef CACHE_HPP
+#define CACHE_HPP
+
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Emulator.hpp"
+#include "Observer.hpp"
+#include "Symbols.hpp"
+
+enum Replacement { REPLACE_LRU, REPLACE_FIFO, REPLACE_RANDOM };
+enum WritePolicy { WRITE_BACK, WRITE_THROUGH };
+
+struct CacheConfig {
+    size_t size = 16 * 1024;
+    int ways = 4;
+    int line = 32;
+    Replacement replacement = REPLACE_LRU;
+    WritePolicy write = WRITE_BACK;
+    // Whether a write miss brings the line in, or only goes to the next level
+    bool write_allocate = true;
+};
+
+struct CacheStats {
+    DWORD reads;
+    DWORD read_misses;
+    DWORD writes;
+    DWORD write_misses;
+    DWORD writebacks;
+};
+
+// One set-associative cache level. Misses, write-through writes and dirty evictions go to the
+// next level, if there is one. Only tags are simulated; the data stays in the emulator's memory.
+class Cache {
+    struct Line {
+        ADDRESS tag;
+        DWORD stamp; // last use (LRU) or fill (FIFO)
+        bool valid;
+        bool dirty;
+    };
+
+    std::string level_name;
+    CacheConfig config;
+    Cache* next;
+    std::vector<Line> lines;
+    size_t sets;
+    int line_bits;
+    DWORD clock;
+    WORD seed;
+    CacheStats counts;
+
+    Line* victim(Line* set);
+
+    public:
+    // Throws std::invalid_argument unless the line size is a power of two that divides the size,
+    // and the ways (at least one, at most one per line) split the lines into a power-of-two number
+    // of sets
+    Cache(const char* name, const CacheConfig& config, Cache* next = NULL);
+
+    // Accesses the line holding address; true on a hit
+    bool access(ADDRESS address, bool write);
+    // Accesses every line touched by size bytes at address; true if all of them hit
+    bool access(ADDRESS address, int size, bool write);
+
+    const std::string& name() { return level_name; }
+    const CacheConfig& configuration() { return config; }
+    const CacheStats& stats() { return counts; }
+    double miss_rate();
+
+    // Invalidates every line, writing dirty ones back first
+    void flush();
+    void clear_stats();
+};
+
+// Split L1 instruction and data caches over a unified L2, fed with the fetch of every executed
+// instruction and the bytes of every load and store by observing BasicEmulator::run().
+class CacheSimulator final : public ExecutionObserver {
+    struct Site {
+        DWORD fetch_misses;
+        DWORD accesses;
+        DWORD misses;
+    };
+
+    Cache l2_cache;
+    Cache l1i_cache;
+    Cache l1d_cache;
+    std::unordered_map<ADDRESS, Site> sites;
+
+    public:
+    CacheSimulator(const CacheConfig& l1i = CacheConfig(), const CacheConfig& l1d = CacheConfig(),
+                   const CacheConfig& l2 = l2_defaults());
+
+    static CacheConfig l2_defaults();
+
+    void before(const Instruction& instruction, ADDRESS pc, const CPUState& cpu);
+
+    Cache& l1i() { return l1i_cache; }
+    Cache& l1d() { return l1d_cache; }
+    Cache& l2() { return l2_cache; }
+    DWORD data_misses_at(ADDRESS pc);
+
+    // Hit and miss rates per level, then the PCs with the most L1 data misses
+    void report(FILE* out, const SymbolTable* symbols, size_t top);
+};
+
+#endif
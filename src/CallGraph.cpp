@@ -0,0 +1,149 @@
+#include <algorithm>
+
+#include "CallGraph.hpp"
+#include "Instruction.hpp"
+
+using namespace std;
+
+CallGraphProfiler::CallGraphProfiler(const SymbolTable* symbols) : symbols(symbols), total(0) {}
+
+int CallGraphProfiler::function_at(ADDRESS entry) {
+    auto it = by_entry.find(entry);
+    if(it != by_entry.end()) return it->second;
+
+    Function function = {entry, "", 0, 0, 0, {}};
+    const Symbol* symbol = symbols != NULL ? symbols->lookup(entry) : NULL;
+    if(symbol != NULL && symbol->address == entry) {
+        function.name = symbol->name;
+    } else {
+        char buffer[16];
+        snprintf(buffer, sizeof(buffer), "0x%08x", entry);
+        function.name = buffer;
+    }
+
+    functions.push_back(function);
+    by_entry[entry] = functions.size() - 1;
+    return functions.size() - 1;
+}
+
+void CallGraphProfiler::push(int function, int caller, ADDRESS call_site, ADDRESS return_address) {
+    stack.push_back({function, caller, call_site, return_address, total});
+    functions[function].active++;
+}
+
+void CallGraphProfiler::pop() {
+    Frame frame = stack.back();
+    stack.pop_back();
+
+    DWORD cost = total - frame.start;
+    Function& function = functions[frame.function];
+    if(--function.active == 0)
+        function.inclusive += cost;
+
+    if(frame.caller >= 0) {
+        Calls& c = calls[make_tuple(frame.caller, frame.call_site, frame.function)];
+        c.count++;
+        c.inclusive += cost;
+    }
+}
+
+void CallGraphProfiler::before(const Instruction& /*instruction*/, ADDRESS pc, const CPUState& /*cpu*/) {
+    // The code we start in is the root of the call graph
+    if(stack.empty())
+        push(function_at(pc), -1, 0, -1);
+
+    Function& current = functions[stack.back().function];
+    current.exclusive++;
+    current.lines[pc]++;
+    total++;
+}
+
+void CallGraphProfiler::after(const Instruction& instruction, ADDRESS pc, const CPUState& cpu, int status) {
+    if(status != STEP_OK) return;
+
+    if(instruction.is_call()) {
+        push(function_at(cpu.PC), stack.back().function, pc, pc + 4);
+    } else if(instruction.is_return()) {
+        // Pop to the frame returning here; a jr $31 matching no frame is just a jump
+        for(size_t f = stack.size(); f-- > 1;) {
+            if(stack[f].return_address == cpu.PC) {
+                while(stack.size() > f) pop();
+                break;
+            }
+        }
+    }
+}
+
+void CallGraphProfiler::finish() {
+    while(!stack.empty()) pop();
+}
+
+DWORD CallGraphProfiler::exclusive(const string& name) {
+    for(Function& f : functions) {
+        if(f.name == name) return f.exclusive;
+    }
+    return 0;
+}
+
+DWORD CallGraphProfiler::inclusive(const string& name) {
+    for(Function& f : functions) {
+        if(f.name == name) return f.inclusive;
+    }
+    return 0;
+}
+
+DWORD CallGraphProfiler::call_count(const string& caller, const string& callee) {
+    DWORD count = 0;
+    for(auto& c : calls) {
+        if(functions[get<0>(c.first)].name == caller && functions[get<2>(c.first)].name == callee)
+            count += c.second.count;
+    }
+    return count;
+}
+
+void CallGraphProfiler::report(FILE* out) {
+    vector<int> order;
+    for(size_t i = 0; i < functions.size(); i++) order.push_back(i);
+    stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return functions[a].inclusive > functions[b].inclusive;
+    });
+
+    fprintf(out, "Instructions: %llu\n\n", total);
+    fprintf(out, "%12s %8s %12s %8s  %s\n", "inclusive", "", "exclusive", "", "function");
+    for(int i : order) {
+        Function& f = functions[i];
+        fprintf(out, "%12llu %7.2f%% %12llu %7.2f%%  %s\n", f.inclusive, total ? 100.0 * f.inclusive / total : 0,
+                f.exclusive, total ? 100.0 * f.exclusive / total : 0, f.name.c_str());
+    }
+}
+
+void CallGraphProfiler::write_callgrind(FILE* out) {
+    fprintf(out, "# callgrind format\nversion: 1\ncreator: mips-emulator\n");
+    fprintf(out, "positions: instr\nevents: Ir\nsummary: %llu\n", total);
+
+    // Names are compressed to "(id)" after their first use
+    vector<bool> named(functions.size(), false);
+    auto name = [&](int i) {
+        if(named[i]) return "(" + to_string(i + 1) + ")";
+        named[i] = true;
+        return "(" + to_string(i + 1) + ") " + functions[i].name;
+    };
+
+    for(size_t i = 0; i < functions.size(); i++) {
+        Function& f = functions[i];
+        fprintf(out, "\nfn=%s\n", name(i).c_str());
+
+        map<ADDRESS, DWORD> lines(f.lines.begin(), f.lines.end());
+        for(auto& line : lines) {
+            fprintf(out, "0x%x %llu\n", line.first, line.second);
+        }
+
+        for(auto& c : calls) {
+            if(get<0>(c.first) != (int)i) continue;
+            int callee = get<2>(c.first);
+            fprintf(out, "cfn=%s\n", name(callee).c_str());
+            fprintf(out, "calls=%llu 0x%x\n", c.second.count, functions[callee].entry);
+            fprintf(out, "0x%x %llu\n", get<1>(c.first), c.second.inclusive);
+        }
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef CALLGRAPH_HPP
+#define CALLGRAPH_HPP
+
+#include <cstdio>
+#include <map>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "Emulator.hpp"
+#include "Observer.hpp"
+#include "Symbols.hpp"
+
+// Call-graph profiler. It keeps a shadow call stack: jal/jalr push a frame for the target (their
+// return address is the PC + 4 step() writes to $31), and `jr $31` pops back to the frame that
+// returns there. Executed instructions are attributed to the function on top of the stack. Runs
+// as an observer of BasicEmulator::run(), and can keep observing the same program across runs.
+class CallGraphProfiler final : public ExecutionObserver {
+    struct Function {
+        ADDRESS entry;
+        std::string name;
+        DWORD exclusive;
+        DWORD inclusive;
+        int active; // frames on the stack, so recursion is only counted once inclusively
+        std::unordered_map<ADDRESS, DWORD> lines;
+    };
+
+    struct Frame {
+        int function;
+        int caller;
+        ADDRESS call_site;
+        ADDRESS return_address;
+        DWORD start;
+    };
+
+    struct Calls {
+        DWORD count;
+        DWORD inclusive;
+    };
+
+    const SymbolTable* symbols;
+    std::vector<Function> functions;
+    std::unordered_map<ADDRESS, int> by_entry;
+    std::vector<Frame> stack;
+    // (caller, call site, callee)
+    std::map<std::tuple<int, ADDRESS, int>, Calls> calls;
+    DWORD total;
+
+    int function_at(ADDRESS entry);
+    void push(int function, int caller, ADDRESS call_site, ADDRESS return_address);
+    void pop();
+
+    public:
+    CallGraphProfiler(const SymbolTable* symbols);
+
+    void before(const Instruction& instruction, ADDRESS pc, const CPUState& cpu);
+    void after(const Instruction& instruction, ADDRESS pc, const CPUState& cpu, int status);
+    // Unwinds every open frame, so that inclusive costs are complete
+    void finish();
+
+    DWORD instructions() { return total; }
+    DWORD exclusive(const std::string& name);
+    DWORD inclusive(const std::string& name);
+    // Calls from caller to callee, over all call sites
+    DWORD call_count(const std::string& caller, const std::string& callee);
+
+    // Functions by inclusive count
+    void report(FILE* out);
+    // callgrind format, for kcachegrind/qcachegrind and callgrind_annotate
+    void write_callgrind(FILE* out);
+};
+
+#endif
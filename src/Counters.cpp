@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "Counters.hpp"
+#include "Isa.hpp"
+
+using namespace std;
+
+// Every branch opcode has a row in Counters::branch
+static_assert([] {
+    for(int op = 0; op < 64; op++) {
+        if(isa_opcodes[op].kind == KIND_BRANCH && op >= (int)(sizeof(Counters::branch) / sizeof(Counters::branch[0])))
+            return false;
+    }
+    return true;
+}(), "branch opcode outside of Counters::branch");
+
+// Bytes a load or store moves (0 for anything else). The table's bytes are what step() checks
+// against memory, which for lwl and lwr is one byte of the word they merge
+static int access_width(int op) {
+    if(op == OP_LWL || op == OP_LWR) return 4;
+    return isa_opcodes[op].bytes;
+}
+
+static double percent(DWORD part, DWORD whole) {
+    return whole == 0 ? 0 : 100.0 * part / whole;
+}
+
+DWORD total_instructions(const Counters& counters) {
+    DWORD total = 0;
+    for(int i = 0; i < 64; i++) {
+        total += counters.opcode[i] + counters.func[i];
+    }
+    return total;
+}
+
+void print_counters(const Counters& counters, FILE* out) {
+    DWORD total = total_instructions(counters);
+    fprintf(out, "Instructions executed: %llu\n", total);
+
+    // Unknown encodings are still counted, under their number
+    vector<pair<DWORD, const char*>> mix;
+    static char unknown[128][16];
+    for(int i = 0; i < 64; i++) {
+        if(counters.opcode[i] != 0) {
+            if(isa_opcodes[i].name == NULL) snprintf(unknown[i], 16, "opcode %d", i);
+            mix.push_back({counters.opcode[i], isa_opcodes[i].name ? isa_opcodes[i].name : unknown[i]});
+        }
+        if(counters.func[i] != 0) {
+            if(isa_funcs[i].name == NULL) snprintf(unknown[64 + i], 16, "func %d", i);
+            mix.push_back({counters.func[i], isa_funcs[i].name ? isa_funcs[i].name : unknown[64 + i]});
+        }
+    }
+    sort(mix.begin(), mix.end(), [](auto& a, auto& b) { return a.first > b.first; });
+
+    fprintf(out, "\nInstruction mix:\n");
+    for(auto& m : mix) {
+        fprintf(out, "  %-10s %12llu %6.2f%%\n", m.second, m.first, percent(m.first, total));
+    }
+
+    fprintf(out, "\nBranches:\n");
+    for(int op = 0; op < 64; op++) {
+        if(isa_opcodes[op].kind != KIND_BRANCH) continue;
+        DWORD taken = counters.branch[op][1], not_taken = counters.branch[op][0];
+        if(taken + not_taken == 0) continue;
+        fprintf(out, "  %-10s taken %12llu (%6.2f%%)  not taken %12llu\n",
+                isa_opcodes[op].name, taken, percent(taken, taken + not_taken), not_taken);
+    }
+
+    fprintf(out, "\nTraps: %llu  Breaks: %llu  Syscalls: %llu  Faults: %llu\n", counters.traps, counters.breaks,
+            counters.syscalls, counters.faults);
+
+    // Bucketed by the width each opcode moves: byte, half, word
+    DWORD loads[3] = {}, stores[3] = {};
+    for(int op = 0; op < 64; op++) {
+        int width = access_width(op);
+        if(width == 0) continue;
+        int bucket = width == 1 ? 0 : width == 2 ? 1 : 2;
+        if(isa_opcodes[op].kind == KIND_LOAD) loads[bucket] += counters.opcode[op];
+        else stores[bucket] += counters.opcode[op];
+    }
+    DWORD total_loads = loads[0] + loads[1] + loads[2];
+    DWORD total_stores = stores[0] + stores[1] + stores[2];
+
+    fprintf(out, "\nLoads:  %12llu  byte %6.2f%%  half %6.2f%%  word %6.2f%%\n", total_loads,
+            percent(loads[0], total_loads), percent(loads[1], total_loads), percent(loads[2], total_loads));
+    fprintf(out, "Stores: %12llu  byte %6.2f%%  half %6.2f%%  word %6.2f%%\n", total_stores,
+            percent(stores[0], total_stores), percent(stores[1], total_stores), percent(stores[2], total_stores));
+}
@@ -0,0 +1,14 @@
+#ifndef COUNTERS_HPP
+#define COUNTERS_HPP
+
+#include <cstdio>
+
+#include "Emulator.hpp"
+
+DWORD total_instructions(const Counters& counters);
+
+// Writes the instruction mix, branch taken/not-taken ratios, trap, break, syscall and fault counts
+// and the load/store size distribution
+void print_counters(const Counters& counters, FILE* out);
+
+#endif
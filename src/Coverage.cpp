@@ -0,0 +1,64 @@
+#include <cstring>
+
+#include <sys/ipc.h>
+#include <sys/shm.h>
+
+#include "Coverage.hpp"
+
+EdgeCoverage::EdgeCoverage() : segment(-1), previous(0) {
+    bitmap = new BYTE[COVERAGE_MAP_SIZE]();
+}
+
+EdgeCoverage::EdgeCoverage(int segment) : segment(segment), previous(0) {
+    void* address = shmat(segment, NULL, 0);
+    bitmap = address == (void*)-1 ? NULL : (BYTE*)address;
+}
+
+EdgeCoverage::~EdgeCoverage() {
+    if(segment < 0) delete[] bitmap;
+    else if(bitmap != NULL) shmdt(bitmap);
+}
+
+int EdgeCoverage::create_segment() {
+    return shmget(IPC_PRIVATE, COVERAGE_MAP_SIZE, IPC_CREAT | IPC_EXCL | 0600);
+}
+
+void EdgeCoverage::remove_segment(int segment) {
+    shmctl(segment, IPC_RMID, NULL);
+}
+
+void EdgeCoverage::reset() {
+    memset(bitmap, 0, COVERAGE_MAP_SIZE);
+    previous = 0;
+}
+
+size_t EdgeCoverage::edges() {
+    size_t count = 0;
+    for(size_t i = 0; i < COVERAGE_MAP_SIZE; i++) count += bitmap[i] != 0;
+    return count;
+}
+
+static BYTE bucket(BYTE hits) {
+    if(hits <= 3) return hits == 3 ? 4 : hits;
+    if(hits <= 7) return 8;
+    if(hits <= 15) return 16;
+    if(hits <= 31) return 32;
+    if(hits <= 127) return 64;
+    return 128;
+}
+
+bool EdgeCoverage::merge_into(BYTE* virgin) {
+    bool found = false;
+    // Most of the map is zero; skip it a word at a time
+    const DWORD* words = (const DWORD*)bitmap;
+    for(size_t w = 0; w < COVERAGE_MAP_SIZE / sizeof(DWORD); w++) {
+        if(words[w] == 0) continue;
+        for(size_t i = w * sizeof(DWORD); i < (w + 1) * sizeof(DWORD); i++) {
+            BYTE bits = bucket(bitmap[i]);
+            if(bitmap[i] == 0 || (bits & virgin[i]) == 0) continue;
+            virgin[i] &= ~bits;
+            found = true;
+        }
+    }
+    return found;
+}
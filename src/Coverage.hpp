@@ -0,0 +1,60 @@
+#ifndef COVERAGE_HPP
+#define COVERAGE_HPP
+
+#include <cstddef>
+
+#include "Emulator.hpp"
+#include "Observer.hpp"
+
+#define COVERAGE_MAP_SIZE (1 << 16)
+
+// AFL-style edge coverage. Every branch (taken or not) and jump ends a block; the address that
+// execution continues at is hashed, and the byte for (previous block ^ this block) is bumped,
+// with the previous hash shifted so that A->B and B->A land in different bytes. Edges are
+// recorded by observing BasicEmulator::run().
+class EdgeCoverage final : public ExecutionObserver {
+    BYTE* bitmap;
+    int segment;
+    WORD previous;
+
+    public:
+    // A private, heap-allocated map
+    EdgeCoverage();
+    // Attaches to a System V shared-memory segment of COVERAGE_MAP_SIZE bytes, e.g. the one AFL
+    // passes in __AFL_SHM_ID; valid() tells whether that worked
+    explicit EdgeCoverage(int segment);
+    ~EdgeCoverage();
+    EdgeCoverage(const EdgeCoverage&) = delete;
+    EdgeCoverage& operator=(const EdgeCoverage&) = delete;
+
+    // A new segment for the map, or -1; remove it when done, and it goes once the last
+    // process detaches
+    static int create_segment();
+    static void remove_segment(int segment);
+
+    bool valid() { return bitmap != NULL; }
+    BYTE* map() { return bitmap; }
+
+    // Records an edge into the block at `target`
+    void visit(ADDRESS target) {
+        WORD current = ((target >> 2) * 0x9e3779b1u) >> 16;
+        bitmap[(current ^ previous) & (COVERAGE_MAP_SIZE - 1)]++;
+        previous = current >> 1;
+    }
+
+    // Records an edge after every branch and jump that completes
+    void after(const Instruction& instruction, ADDRESS /*pc*/, const CPUState& cpu, int status) {
+        if(status == STEP_OK && (instruction.is_conditional_branch() || instruction.is_jump() || instruction.is_indirect()))
+            visit(cpu.PC);
+    }
+
+    // Clears the map and the previous block, before the next execution
+    void reset();
+    size_t edges();
+
+    // Buckets hit counts as AFL does (1, 2, 3, 4-7, 8-15, 16-31, 32-127, 128+) and clears the bits
+    // seen in `virgin` (COVERAGE_MAP_SIZE bytes, initially all 0xff); true if any were new
+    bool merge_into(BYTE* virgin);
+};
+
+#endif
@@ -0,0 +1,168 @@
+#include <cstring>
+
+#include "Differential.hpp"
+#include "Instruction.hpp"
+
+using namespace std;
+
+int run_exactly(ExecutionBackend& backend, DWORD count, DWORD& executed) {
+    DWORD done = 0;
+    int status = STEP_OK;
+    while(done < count && status == STEP_OK) {
+        status = backend.run_block(count - done, done);
+    }
+    executed += done;
+    return status;
+}
+
+int InterpreterBackend::run_block(DWORD budget, DWORD& executed) {
+    CPUState& cpu = emulator->state();
+    int status = STEP_OK;
+    DWORD i;
+
+    for(i = 0; i < budget; i++) {
+        // Nothing to decode; step() reports the fault
+        if((size_t)cpu.PC + 4 > emulator->get_memory_size()) {
+            status = emulator->step();
+            i++;
+            break;
+        }
+
+        Instruction instruction(emulator->load_word(cpu.PC));
+        status = emulator->step();
+        if(status != STEP_OK || instruction.is_conditional_branch() || instruction.is_jump() ||
+           instruction.is_indirect()) {
+            i++;
+            break;
+        }
+    }
+
+    executed += i;
+    return status;
+}
+
+// Everything architectural but memory; the discard slot and the status are not state
+static bool same_registers(const CPUState& a, const CPUState& b) {
+    return memcmp(a.gpr, b.gpr, DISCARD_SLOT * sizeof(REGISTER)) == 0 && a.PC == b.PC && a.HI == b.HI && a.LO == b.LO;
+}
+
+LockstepChecker::LockstepChecker(const BackendFactory& reference, const BackendFactory& candidate, DWORD memory_interval)
+    : reference(reference), candidate(candidate), memory_interval(memory_interval ? memory_interval : 1),
+      result{false, 0, 0, STEP_OK, STEP_OK}, reference_name(""), candidate_name("") {}
+
+bool LockstepChecker::agree_after(DWORD count) {
+    Snapshot* snapshots[2] = {&reference_state, &candidate_state};
+    DWORD executed[2] = {0, 0};
+
+    for(int b = 0; b < 2; b++) {
+        ExecutionBackend* backend = b == 0 ? reference() : candidate();
+        snapshots[b]->status = run_exactly(*backend, count, executed[b]);
+        snapshots[b]->cpu = backend->state();
+        snapshots[b]->memory.assign(backend->memory(), backend->memory() + backend->memory_size());
+        delete backend;
+    }
+
+    return executed[0] == executed[1] && reference_state.status == candidate_state.status &&
+           same_registers(reference_state.cpu, candidate_state.cpu) && reference_state.memory == candidate_state.memory;
+}
+
+void LockstepChecker::bisect(DWORD good, DWORD bad) {
+    while(bad - good > 1) {
+        DWORD middle = good + (bad - good) / 2;
+        if(agree_after(middle)) good = middle;
+        else bad = middle;
+    }
+
+    agree_after(good);
+    result.pc = reference_state.cpu.PC;
+    agree_after(bad);
+    result.diverged = true;
+    result.executed = bad;
+    result.reference_status = reference_state.status;
+    result.candidate_status = candidate_state.status;
+}
+
+DiffResult LockstepChecker::run(DWORD budget) {
+    ExecutionBackend* a = reference();
+    ExecutionBackend* b = candidate();
+    reference_name = a->name();
+    candidate_name = b->name();
+
+    StateHasher a_hasher(a->memory(), a->memory_size());
+    StateHasher b_hasher(b->memory(), b->memory_size());
+    a_hasher.set_tracked(a->track_dirty(a_hasher.dirty_pages()));
+    b_hasher.set_tracked(b->track_dirty(b_hasher.dirty_pages()));
+
+    DWORD done = 0, good = 0, blocks = 0;
+    int reference_status = STEP_OK, candidate_status = STEP_OK;
+    result = DiffResult{false, 0, 0, STEP_OK, STEP_OK};
+
+    while(done < budget) {
+        DWORD n = 0, m = 0;
+        reference_status = a->run_block(budget - done, n);
+        candidate_status = run_exactly(*b, n, m);
+        done += n;
+
+        bool whole = ++blocks % memory_interval == 0 || reference_status != STEP_OK || done >= budget;
+        bool same = n == m && reference_status == candidate_status && same_registers(a->state(), b->state()) &&
+                    (!whole || a_hasher.digest(a->state()) == b_hasher.digest(b->state()));
+        if(!same) {
+            delete a;
+            delete b;
+            bisect(good, done);
+            return result;
+        }
+
+        if(whole) good = done;
+        if(reference_status != STEP_OK) break;
+    }
+
+    // A store a backend did not flag would have been missed until now
+    bool same = state_hash(a->state(), a->memory(), a->memory_size()) ==
+                state_hash(b->state(), b->memory(), b->memory_size());
+    delete a;
+    delete b;
+    if(!same) {
+        bisect(0, done);
+        return result;
+    }
+
+    result.executed = done;
+    result.reference_status = reference_status;
+    result.candidate_status = candidate_status;
+    return result;
+}
+
+void LockstepChecker::report(FILE* out) {
+    if(!result.diverged) {
+        fprintf(out, "%s and %s agree over %llu instructions\n", reference_name, candidate_name, result.executed);
+        return;
+    }
+
+    const Snapshot& a = reference_state;
+    const Snapshot& b = candidate_state;
+    WORD instruction = 0;
+    if((size_t)result.pc + 4 <= a.memory.size()) memcpy(&instruction, &a.memory[result.pc], 4);
+
+    fprintf(out, "%s and %s diverge at instruction %llu, PC 0x%08x (0x%08x)\n\n", reference_name, candidate_name,
+            result.executed, result.pc, instruction);
+    fprintf(out, "          %12s %12s\n", reference_name, candidate_name);
+    for(int r = 0; r < 32; r++) {
+        fprintf(out, "%c  $%-2d    0x%08x   0x%08x\n", a.cpu.gpr[r] != b.cpu.gpr[r] ? '*' : ' ', r, a.cpu.gpr[r],
+                b.cpu.gpr[r]);
+    }
+    fprintf(out, "%c  PC     0x%08x   0x%08x\n", a.cpu.PC != b.cpu.PC ? '*' : ' ', a.cpu.PC, b.cpu.PC);
+    fprintf(out, "%c  HI     0x%08x   0x%08x\n", a.cpu.HI != b.cpu.HI ? '*' : ' ', a.cpu.HI, b.cpu.HI);
+    fprintf(out, "%c  LO     0x%08x   0x%08x\n", a.cpu.LO != b.cpu.LO ? '*' : ' ', a.cpu.LO, b.cpu.LO);
+    fprintf(out, "%c  status 0x%08x   0x%08x\n", a.status != b.status ? '*' : ' ', a.status, b.status);
+
+    size_t differing = 0;
+    size_t common = min(a.memory.size(), b.memory.size());
+    for(size_t i = 0; i < common; i++) {
+        if(a.memory[i] == b.memory[i]) continue;
+        if(differing++ < 16) fprintf(out, "*  [0x%08zx]  0x%02x         0x%02x\n", i, a.memory[i], b.memory[i]);
+    }
+    if(differing > 16) fprintf(out, "   ... %zu bytes differ in all\n", differing);
+    if(a.memory.size() != b.memory.size())
+        fprintf(out, "*  memory size %zu vs %zu\n", a.memory.size(), b.memory.size());
+}
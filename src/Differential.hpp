@@ -0,0 +1,108 @@
+#ifndef DIFFERENTIAL_HPP
+#define DIFFERENTIAL_HPP
+
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+#include "Emulator.hpp"
+#include "StateHash.hpp"
+#include "Trace.hpp"
+
+// An execution engine that can be checked against Emulator::step()
+class ExecutionBackend {
+    public:
+    virtual ~ExecutionBackend() {}
+    virtual const char* name() = 0;
+
+    // Runs until a branch or jump has executed, a step stops with a non-zero status, or `budget`
+    // instructions have run; returns the status of the last step
+    virtual int run_block(DWORD budget, DWORD& executed) = 0;
+
+    virtual CPUState& state() = 0;
+    virtual BYTE* memory() = 0;
+    virtual size_t memory_size() = 0;
+    // Flags pages on every store as Emulator::track_dirty() does; false if the backend cannot
+    virtual bool track_dirty(BYTE* /*pages*/) { return false; }
+};
+
+// Calls run_block() until exactly `count` instructions have run or a step stops
+int run_exactly(ExecutionBackend& backend, DWORD count, DWORD& executed);
+
+// The reference: Emulator::step(), one instruction at a time
+class InterpreterBackend : public ExecutionBackend {
+    protected:
+    Emulator* emulator;
+
+    public:
+    // Takes ownership of the emulator
+    InterpreterBackend(Emulator* emulator) : emulator(emulator) {}
+    ~InterpreterBackend() { delete emulator; }
+
+    const char* name() { return "interpreter"; }
+    int run_block(DWORD budget, DWORD& executed);
+
+    CPUState& state() { return emulator->state(); }
+    BYTE* memory() { return emulator->get_memory(); }
+    size_t memory_size() { return emulator->get_memory_size(); }
+    bool track_dirty(BYTE* pages) {
+        emulator->track_dirty(pages);
+        return true;
+    }
+};
+
+// Emulator::step() through the tracing path, which is a separate copy of the dispatch
+class TracingBackend : public InterpreterBackend {
+    TraceRing ring;
+
+    public:
+    TracingBackend(Emulator* emulator) : InterpreterBackend(emulator), ring(1024) { emulator->trace_to(&ring); }
+    ~TracingBackend() { emulator->trace_to(NULL); }
+    const char* name() { return "tracing"; }
+};
+
+// Fresh backends on the same program, so that a run can be replayed from the start
+typedef std::function<ExecutionBackend*()> BackendFactory;
+
+struct DiffResult {
+    bool diverged;
+    // Instructions the reference ran; on divergence, the count after which states first differ
+    DWORD executed;
+    // Address of the first instruction whose result differs
+    ADDRESS pc;
+    int reference_status;
+    int candidate_status;
+};
+
+// Runs a reference and a candidate backend side by side, comparing their registers after every
+// block and incremental digests of their whole state every `memory_interval` blocks, and all of
+// memory once they stop. On a mismatch it bisects, replaying both from the start, down to the
+// first instruction after which the states differ.
+class LockstepChecker {
+    struct Snapshot {
+        CPUState cpu;
+        std::vector<BYTE> memory;
+        int status;
+    };
+
+    BackendFactory reference;
+    BackendFactory candidate;
+    DWORD memory_interval;
+    DiffResult result;
+    Snapshot reference_state;
+    Snapshot candidate_state;
+    const char* reference_name;
+    const char* candidate_name;
+
+    bool agree_after(DWORD count);
+    void bisect(DWORD good, DWORD bad);
+
+    public:
+    LockstepChecker(const BackendFactory& reference, const BackendFactory& candidate, DWORD memory_interval = 64);
+
+    DiffResult run(DWORD budget);
+    // Both states after the first differing instruction
+    void report(FILE* out);
+};
+
+#endif
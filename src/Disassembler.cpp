@@ -0,0 +1,154 @@
+#include <cstring>
+
+#include "Disassembler.hpp"
+#include "Isa.hpp"
+
+static const char register_names[32][5] = {"zero", "at", "v0", "v1", "a0", "a1", "a2", "a3", "t0", "t1", "t2",
+                                           "t3",   "t4", "t5", "t6", "t7", "s0", "s1", "s2", "s3", "s4", "s5",
+                                           "s6",   "s7", "t8", "t9", "k0", "k1", "gp", "sp", "fp", "ra"};
+
+static const char hex_digits[] = "0123456789abcdef";
+
+// Appends without bounds checks, into a scratch line long enough for any instruction
+struct Writer {
+    char* p;
+
+    void put(char c) { *p++ = c; }
+    void text(const char* s) {
+        while(*s) *p++ = *s++;
+    }
+    void decimal(int value) {
+        char digits[12];
+        int n = 0;
+        unsigned magnitude = value;
+        if(value < 0) put('-'), magnitude = -magnitude;
+        do digits[n++] = '0' + magnitude % 10;
+        while((magnitude /= 10) != 0);
+        while(n > 0) put(digits[--n]);
+    }
+    void hex(WORD value) {
+        int shift = 28;
+        put('0'), put('x');
+        while(shift > 0 && (value >> shift) == 0) shift -= 4;
+        for(; shift >= 0; shift -= 4) put(hex_digits[(value >> shift) & 0xf]);
+    }
+    void reg(int number, bool numeric) {
+        put('$');
+        if(numeric) {
+            if(number >= 10) put('0' + number / 10);
+            put('0' + number % 10);
+        } else {
+            // Names are 2 characters, but for zero
+            memcpy(p, register_names[number], 4);
+            p += number == 0 ? 4 : 2;
+        }
+    }
+};
+
+// Copies what fits of data after the first length characters of out, leaving room for the NUL
+static size_t append(char* out, size_t length, size_t size, const char* data, size_t count) {
+    if(count > size - 1 - length) count = size - 1 - length;
+    memcpy(out + length, data, count);
+    return length + count;
+}
+
+size_t disassemble(WORD word, ADDRESS pc, char* out, size_t size, const SymbolTable* symbols, int flags) {
+    if(size == 0) return 0;
+
+    // Fields extracted as step() does
+    int rs = (word >> 21) & 0b11111;
+    int rt = (word >> 16) & 0b11111;
+    int rd = (word >> 11) & 0b11111;
+    int shamt = (word >> 6) & 0b11111;
+    int imm = word & 65535;
+    int se_imm = (short)imm;
+
+    const IsaEntry& entry = isa_entry(word);
+    bool numeric = flags & DISASM_NUMERIC_REGISTERS;
+    char line[64];
+    Writer w = {line};
+    ADDRESS target = 0;
+
+    if(word == 0) {
+        w.text("nop");
+    } else if(entry.name == NULL) {
+        w.text(".word ");
+        w.hex(word);
+    } else {
+        w.text(entry.name);
+        if(entry.format != FMT_NONE && !(entry.format == FMT_BREAK && (word >> 6) == 0)) w.put(' ');
+
+        switch(entry.format) {
+            case FMT_INVALID:
+            case ISA_FORMATS:
+            case FMT_NONE:
+                break;
+            case FMT_RD_RS_RT:
+                w.reg(rd, numeric), w.text(", "), w.reg(rs, numeric), w.text(", "), w.reg(rt, numeric);
+                break;
+            case FMT_RD_RT_SA:
+                w.reg(rd, numeric), w.text(", "), w.reg(rt, numeric), w.text(", "), w.decimal(shamt);
+                break;
+            case FMT_RD_RT_RS:
+                w.reg(rd, numeric), w.text(", "), w.reg(rt, numeric), w.text(", "), w.reg(rs, numeric);
+                break;
+            case FMT_RS_RT:
+                w.reg(rs, numeric), w.text(", "), w.reg(rt, numeric);
+                break;
+            case FMT_RS:
+            case FMT_JALR:
+                w.reg(rs, numeric);
+                break;
+            case FMT_RD:
+                w.reg(rd, numeric);
+                break;
+            case FMT_BREAK:
+                if((word >> 6) != 0) w.hex((word >> 6) & 0xfffff);
+                break;
+            case FMT_IMM:
+                w.reg(rt, numeric), w.text(", "), w.reg(rs, numeric), w.text(", "), w.decimal(se_imm);
+                break;
+            case FMT_UIMM:
+                w.reg(rt, numeric), w.text(", "), w.reg(rs, numeric), w.text(", "), w.hex(imm);
+                break;
+            case FMT_LUI:
+                w.reg(rt, numeric), w.text(", "), w.hex(imm);
+                break;
+            case FMT_MEMORY:
+                w.reg(rt, numeric), w.text(", "), w.decimal(se_imm), w.put('('), w.reg(rs, numeric), w.put(')');
+                break;
+            case FMT_BRANCH2:
+                w.reg(rs, numeric), w.text(", "), w.reg(rt, numeric), w.text(", ");
+                target = pc + (se_imm << 2);
+                w.hex(target);
+                break;
+            case FMT_BRANCH1:
+                w.reg(rs, numeric), w.text(", ");
+                target = pc + (se_imm << 2);
+                w.hex(target);
+                break;
+            case FMT_JUMP:
+                target = (pc & (0b111111 << 26)) | ((word & 0x3FFFFFF) << 2);
+                w.hex(target);
+                break;
+        }
+
+        bool control = entry.format == FMT_BRANCH2 || entry.format == FMT_BRANCH1 || entry.format == FMT_JUMP;
+        const Symbol* symbol = control && symbols != NULL ? symbols->lookup(target) : NULL;
+        if(symbol != NULL) {
+            // Only the name can be too long for the scratch line, so it is copied to out directly
+            w.text("  # ");
+            size_t length = append(out, 0, size, line, w.p - line);
+            length = append(out, length, size, symbol->name.data(), symbol->name.size());
+            w.p = line;
+            if(target != symbol->address) w.put('+'), w.hex(target - symbol->address);
+            length = append(out, length, size, line, w.p - line);
+            out[length] = '\0';
+            return length;
+        }
+    }
+
+    size_t length = append(out, 0, size, line, w.p - line);
+    out[length] = '\0';
+    return length;
+}
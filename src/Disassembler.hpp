@@ -0,0 +1,24 @@
+#ifndef DISASSEMBLER_HPP
+#define DISASSEMBLER_HPP
+
+#include <cstddef>
+
+#include "Emulator.hpp"
+#include "Symbols.hpp"
+
+// $8 instead of $t0
+#define DISASM_NUMERIC_REGISTERS 0x1
+
+// Enough for any instruction with a symbol name of up to 48 characters
+#define DISASM_BUFFER 96
+
+// Writes one instruction as assembler text into out, NUL-terminated and cut to size, and returns
+// its length. Nothing is allocated, so it can run on a trace consumer thread.
+//
+// Decoding goes through the tables of Isa.hpp; the text is what Assembler accepts back, with
+// branch and jump targets as absolute addresses (as step() computes them from pc) and, when
+// symbols are given, a "# name+0x4" comment naming the target. Encodings step() does not
+// execute come out as ".word 0x...".
+size_t disassemble(WORD word, ADDRESS pc, char* out, size_t size, const SymbolTable* symbols = NULL, int flags = 0);
+
+#endif
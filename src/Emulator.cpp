@@ -4,15 +4,26 @@
 #include <new>
 
 #include "Emulator.hpp"
+#include "Pool.hpp"
+#include "Instruction.hpp"
+#include "Isa.hpp"
+#include "Trace.hpp"
 
 using namespace std;
 
-void Emulator::init(size_t mem_size, WORD* program, size_t program_size) {
+// The switches in execute() are over the ISA enums with no default, so a row of Isa.hpp without
+// its case here does not compile
+#pragma GCC diagnostic error "-Wswitch"
+
+template<typename Policy>
+void BasicEmulator<Policy>::init(size_t mem_size, const WORD* program, size_t program_size) {
     memory_size = mem_size;
 
-    memory = new BYTE[memory_size]();
-    registers = new REGISTER[31]();
-    PC = 0;
+    cpu = CPUState();
+    memory = Pool::acquire(memory_size);
+    tracer = NULL;
+    dirty = NULL;
+    if constexpr(Policy::counting) counts = Counters();
 
     // Load program to first portion of memory
     if(mem_size < program_size*4 - 1) {
@@ -24,15 +35,23 @@ void Emulator::init(size_t mem_size, WORD* program, size_t program_size) {
     }
 }
 
-Emulator::Emulator(size_t mem_size) {
+template<typename Policy>
+BasicEmulator<Policy>::BasicEmulator(size_t mem_size) {
     init(mem_size, NULL, 0);
 }
 
-Emulator::Emulator(size_t mem_size, WORD* program, size_t program_size) {
+template<typename Policy>
+BasicEmulator<Policy>::BasicEmulator(size_t mem_size, const WORD* program, size_t program_size) {
     init(mem_size, program, program_size);
 }
 
-void Emulator::dump_memory_range(BYTE* start, int length, int bytes_per_row) {
+template<typename Policy>
+BasicEmulator<Policy>::~BasicEmulator() {
+    Pool::release(memory, memory_size);
+}
+
+template<typename Policy>
+void BasicEmulator<Policy>::dump_memory_range(BYTE* start, int length, int bytes_per_row) {
     // TODO: bytes_per_row is a multiple of 4
     for(int i = 0; i < length / bytes_per_row; i++) {
         int j;
@@ -43,11 +62,15 @@ void Emulator::dump_memory_range(BYTE* start, int length, int bytes_per_row) {
     }
 }
 
-void Emulator::memory_dump(int bytes_per_row) {
+template<typename Policy>
+void BasicEmulator<Policy>::memory_dump(int bytes_per_row) {
     dump_memory_range(memory, memory_size, bytes_per_row);
 }
 
-WORD Emulator::load_word(ADDRESS addr) {
+template<typename Policy>
+WORD BasicEmulator<Policy>::load_word(ADDRESS addr) {
+    if constexpr(Policy::big_endian)
+        return (WORD)memory[addr] << 24 | memory[addr + 1] << 16 | memory[addr + 2] << 8 | memory[addr + 3];
     WORD temp = memory[addr];
     temp = temp | (memory[addr + 1] << 8);
     temp = temp | (memory[addr + 2] << 16);
@@ -55,35 +78,113 @@ WORD Emulator::load_word(ADDRESS addr) {
     return temp;
 }
 
-void Emulator::store_word(WORD word, ADDRESS addr) {
+template<typename Policy>
+void BasicEmulator<Policy>::store_word(WORD word, ADDRESS addr) {
+    if(Policy::dirty_tracking && dirty != NULL) {
+        dirty[addr >> EMU_PAGE_BITS] = 1;
+        dirty[(addr + 3) >> EMU_PAGE_BITS] = 1;
+    }
+    if constexpr(Policy::big_endian) {
+        memory[addr] = word >> 24;
+        memory[addr + 1] = word >> 16;
+        memory[addr + 2] = word >> 8;
+        memory[addr + 3] = word;
+        return;
+    }
     memory[addr] = word;
     memory[addr + 1] = word >> 8;
     memory[addr + 2] = word >> 16;
     memory[addr + 3] = word >> 24;
 }
 
-BYTE Emulator::load_byte(ADDRESS addr) {
+template<typename Policy>
+BYTE BasicEmulator<Policy>::load_byte(ADDRESS addr) {
     return memory[addr];
 }
 
-void Emulator::store_byte(BYTE byte, ADDRESS addr) {
+template<typename Policy>
+void BasicEmulator<Policy>::store_byte(BYTE byte, ADDRESS addr) {
+    if(Policy::dirty_tracking && dirty != NULL) dirty[addr >> EMU_PAGE_BITS] = 1;
     memory[addr] = byte;
 }
 
-WORD Emulator::get_register(int number) {
-    if(number == 0) return 0;
-    else return registers[number - 1];
+template<typename Policy>
+WORD BasicEmulator<Policy>::get_register(int number) {
+    return cpu.gpr[number];
+}
+
+template<typename Policy>
+void BasicEmulator<Policy>::set_register(int number, WORD value) {
+    cpu.gpr[register_slot(number)] = value;
+}
+
+static void count_status(Counters& counts, int status) {
+    if(status == STEP_TRAP) counts.traps++;
+    else if(status == STEP_SYSCALL) counts.syscalls++;
+    else if(status == STEP_FAULT) counts.faults++;
+    else if(status != STEP_OK) counts.breaks++;
 }
 
-void Emulator::set_register(int number, WORD value) {
-    if(number > 0)
-        registers[number - 1] = value;
+// Halfwords, in the byte order of the policy
+template<typename Policy>
+static WORD halfword(BYTE first, BYTE second) {
+    return Policy::big_endian ? first << 8 | second : first | second << 8;
 }
 
 // Executes the next instruction
 // Returns: 0 if success, 1 if error
-int Emulator::step() {
-    WORD instruction = load_word(PC);
+template<typename Policy>
+int BasicEmulator<Policy>::step() {
+    int status = Policy::tracing && tracer != NULL ? traced_step() : execute();
+
+    if constexpr(Policy::counting) count_status(counts, status);
+
+    return status;
+}
+
+template<typename Policy>
+int BasicEmulator<Policy>::run(DWORD budget, DWORD& executed) {
+    for(DWORD i = 0; i < budget; i++) {
+        int status = step();
+        if(status != STEP_OK) {
+            executed += i + 1;
+            return status;
+        }
+    }
+    executed += budget;
+    return STEP_OK;
+}
+
+template<typename Policy>
+int BasicEmulator<Policy>::traced_step() {
+    // Nothing to fetch or record; execute() reports the fault
+    if(Policy::bounds_checks && (size_t)cpu.PC + 4 > memory_size)
+        return execute();
+
+    Instruction instruction(load_word(cpu.PC));
+    TraceRecord record = {cpu.PC, instruction.word, 0, 0, 0, 0};
+
+    if(instruction.is_load() || instruction.is_store()) {
+        record.address = get_register(instruction.rs) + instruction.se_imm;
+        record.flags = instruction.is_load() ? TRACE_LOAD : TRACE_STORE;
+    }
+
+    record.status = execute();
+
+    // rt holds the loaded value afterwards, or the value that was stored
+    if(record.flags != 0)
+        record.value = get_register(instruction.rt);
+
+    tracer->push(record);
+    return record.status;
+}
+
+template<typename Policy>
+int BasicEmulator<Policy>::execute() {
+    if(Policy::bounds_checks && (size_t)cpu.PC + 4 > memory_size)
+        return cpu.status = STEP_FAULT;
+
+    WORD instruction = load_word(cpu.PC);
     int opcode = (instruction >> 26) & 0b111111;
 
     // R-type instruction
@@ -99,7 +200,7 @@ int Emulator::step() {
 
     // J-type (pseudo address is 26 bit, shifted by 2, and top 6 bits same as current PC)
     // 0x3FFFFFF is 26 lower bits set
-    int pseudo_addr = (PC & (0b111111 << 26)) | ((instruction & 0x3FFFFFF) << 2);
+    int pseudo_addr = (cpu.PC & (0b111111 << 26)) | ((instruction & 0x3FFFFFF) << 2);
 
     // Register values (unsigned)
     REGISTER Rs = get_register(rs);
@@ -109,272 +210,293 @@ int Emulator::step() {
     signed int Rss = *(REGISTER*)&Rs;
     signed int Rts = *(REGISTER*)&Rt;
 
+    if constexpr(Policy::counting) opcode == 0 ? counts.func[func]++ : counts.opcode[opcode]++;
+
+    if constexpr(Policy::bounds_checks) {
+        int access = isa_access_bytes[opcode];
+        if(access != 0 && (size_t)(ADDRESS)(Rs + se_imm) + access > memory_size)
+            return cpu.status = STEP_FAULT;
+    }
+
+    // Where the addressed byte sits in its aligned word, for lwl and lwr
+    int lane = Policy::big_endian ? 3 - ((Rs + se_imm) & 0b11) : (Rs + se_imm) & 0b11;
+
     // Exception
     WORD exception = (rs << 15) | (rt << 10) | (rd << 5) | shamt;
 
-    switch(opcode) {
-        case 0: // ALU
-            switch(func) {
-                case 0: // sll
+    switch((Opcode)opcode) {
+        case OP_SPECIAL:
+            switch((Func)func) {
+                case FUNC_SLL:
                     set_register(rd, Rt << shamt);
                     break;
-                case 2: // srl
+                case FUNC_SRL:
                     set_register(rd, Rt >> shamt);
                     break;
-                case 3: // sra
+                case FUNC_SRA:
                     set_register(rd, Rts >> shamt);
                     break;
-                case 4: // sllv
+                case FUNC_SLLV:
                     set_register(rd, Rt << (Rs & 0b11111));
                     break;
-                case 6: // srlv
+                case FUNC_SRLV:
                     set_register(rd, Rt >> (Rs & 0b11111));
                     break;
-                case 7: // srav
+                case FUNC_SRAV:
                     set_register(rd, Rts >> (Rs & 0b11111));
                     break;
-                case 8: // jr
-                    PC = Rs - 4;
+                case FUNC_JR:
+                    cpu.PC = Rs - 4;
                     break;
-                case 9: // jalr
-                    set_register(31, PC + 4);
-                    PC = Rs - 4;
+                case FUNC_JALR:
+                    set_register(31, cpu.PC + 4);
+                    cpu.PC = Rs - 4;
                     break;
-                case 10: // movz
+                case FUNC_MOVZ:
                     if(get_register(rt) == 0)
                         set_register(rd, Rs);
                     break;
-                case 11: // movn
+                case FUNC_MOVN:
                     if(get_register(rt) != 0)
                         set_register(rd, Rs);
                     break;
-                case 13: // break
-                    return exception;
+                case FUNC_SYSCALL: // resumes after the instruction once the host has serviced it
+                    cpu.PC = cpu.PC + 4;
+                    return cpu.status = STEP_SYSCALL;
                     break;
-                case 16: // mfhi
-                    set_register(rd, HI);
+                case FUNC_BREAK:
+                    return cpu.status = exception;
                     break;
-                case 17: // mthi
-                    HI = get_register(rs);
+                case FUNC_MFHI:
+                    set_register(rd, cpu.HI);
                     break;
-                case 18: // mflo
-                    set_register(rd, LO);
+                case FUNC_MTHI:
+                    cpu.HI = get_register(rs);
                     break;
-                case 19: // mtlo
-                    LO = get_register(rs);
+                case FUNC_MFLO:
+                    set_register(rd, cpu.LO);
                     break;
-                case 24: // mult
+                case FUNC_MTLO:
+                    cpu.LO = get_register(rs);
+                    break;
+                case FUNC_MULT:
                     {
                         int64_t result = (int64_t)Rss * (int64_t)Rts;
-                        LO = result;
-                        HI = result >> 32;
+                        cpu.LO = result;
+                        cpu.HI = result >> 32;
                     }
                     break;
-                case 25: // multu
+                case FUNC_MULTU:
                     {
                         DWORD result = (DWORD)Rs * (DWORD)Rt;
-                        LO = result;
-                        HI = result >> 32;
+                        cpu.LO = result;
+                        cpu.HI = result >> 32;
                     }
                     break;
-                case 26: // div
-                    LO = Rss / Rts;
-                    HI = Rss % Rts;
+                case FUNC_DIV: // HI and LO are left alone on division by zero, as the result is undefined
+                    if(Rts == -1) {
+                        // Also avoids the host trap on INT_MIN / -1
+                        cpu.LO = -Rs;
+                        cpu.HI = 0;
+                    } else if(Rts != 0) {
+                        cpu.LO = Rss / Rts;
+                        cpu.HI = Rss % Rts;
+                    }
                     break;
-                case 27: // divu
-                    LO = Rs / Rt;
-                    HI = Rs % Rt;
+                case FUNC_DIVU:
+                    if(Rt != 0) {
+                        cpu.LO = Rs / Rt;
+                        cpu.HI = Rs % Rt;
+                    }
                     break;
-                case 32: // add (traps on overflow)
-                    if((Rss > 0 && Rts > 0 && (Rss + Rts) < 0) || (Rss < 0 && Rts < 0 && (Rss + Rts) > 0)) {
+                case FUNC_ADD: // traps on overflow
+                    if(Policy::strict_traps && ((Rss > 0 && Rts > 0 && (Rss + Rts) < 0) || (Rss < 0 && Rts < 0 && (Rss + Rts) > 0))) {
                         // Overflow occurred, trap
-                        return 1;
+                        return cpu.status = STEP_TRAP;
                     }
                     set_register(rd, Rss + Rts);
                     break;
-                case 33: // addu
+                case FUNC_ADDU:
                     set_register(rd, Rss + Rts);
                     break;
-                case 34: // sub (traps on overflow)
-                    if((Rss > 0 && Rts < 0 && (Rss - Rts) < 0) || (Rss < 0 && Rts > 0 && (Rss - Rts) > 0)) {
+                case FUNC_SUB: // traps on overflow
+                    if(Policy::strict_traps && ((Rss > 0 && Rts < 0 && (Rss - Rts) < 0) || (Rss < 0 && Rts > 0 && (Rss - Rts) > 0))) {
                         // Overflow occurred, trap
-                        return 1;
+                        return cpu.status = STEP_TRAP;
                     }
                     set_register(rd, Rss - Rts);
                     break;
-                case 35: // subu
+                case FUNC_SUBU:
                     set_register(rd, Rss - Rts);
                     break;
-                case 36: // and
+                case FUNC_AND:
                     set_register(rd, Rs & Rt);
                     break;
-                case 37: // or
+                case FUNC_OR:
                     set_register(rd, Rs | Rt);
                     break;
-                case 38: // xor
+                case FUNC_XOR:
                     set_register(rd, Rs ^ Rt);
                     break;
-                case 39: // nor
+                case FUNC_NOR:
                     set_register(rd, ~(Rs | Rt));
                     break;
-                case 42: // slt
+                case FUNC_SLT:
                     set_register(rd, Rss < Rts);
                     break;
-                case 43: // sltu
+                case FUNC_SLTU:
                     set_register(rd, Rs < Rt);
                     break;
-                case 48: // tge
+                case FUNC_TGE:
                     if(Rss >= Rts)
-                        return 1;
+                        return cpu.status = STEP_TRAP;
                     break;
-                case 49: // tgeu
+                case FUNC_TGEU:
                     if(Rs >= Rt)
-                        return 1;
+                        return cpu.status = STEP_TRAP;
                     break;
-                case 50: // tlt
+                case FUNC_TLT:
                     if(Rss < Rts)
-                        return 1;
+                        return cpu.status = STEP_TRAP;
                     break;
-                case 51: // tltu
+                case FUNC_TLTU:
                     if(Rs < Rt)
-                        return 1;
+                        return cpu.status = STEP_TRAP;
                     break;
-                case 52: // teq
+                case FUNC_TEQ:
                     if(Rs == Rt)
-                        return 1;
+                        return cpu.status = STEP_TRAP;
                     break;
-                case 54: // tne
+                case FUNC_TNE:
                     if(Rs != Rt)
-                        return 1;
+                        return cpu.status = STEP_TRAP;
                     break;
             }
             break;
-        case 2: // j
-            PC = pseudo_addr - 4;
+        case OP_J:
+            cpu.PC = pseudo_addr - 4;
             break;
-        case 3: // jal
-            set_register(31, PC + 4);
-            PC = pseudo_addr - 4;
+        case OP_JAL:
+            set_register(31, cpu.PC + 4);
+            cpu.PC = pseudo_addr - 4;
             break;
-        case 4: // beq
+        case OP_BEQ:
             if(Rs == Rt)
-                PC += (se_imm << 2) - 4;
+                cpu.PC += (se_imm << 2) - 4;
+            if constexpr(Policy::counting) counts.branch[opcode][Rs == Rt]++;
             break;
-        case 5: // bne
+        case OP_BNE:
             if(Rs != Rt)
-                PC += (se_imm << 2) - 4;
+                cpu.PC += (se_imm << 2) - 4;
+            if constexpr(Policy::counting) counts.branch[opcode][Rs != Rt]++;
             break;
-        case 6: // blez
+        case OP_BLEZ:
             if(Rss <= 0)
-                PC += (se_imm << 2) - 4;
+                cpu.PC += (se_imm << 2) - 4;
+            if constexpr(Policy::counting) counts.branch[opcode][Rss <= 0]++;
             break;
-        case 7: // bgtz
+        case OP_BGTZ:
             if(Rss > 0)
-                PC += (se_imm << 2) - 4;
+                cpu.PC += (se_imm << 2) - 4;
+            if constexpr(Policy::counting) counts.branch[opcode][Rss > 0]++;
             break;
-        case 8: // addi (with overflow)
-            if((Rss > 0 && se_imm > 0 && (Rss + se_imm) < 0) || (Rss < 0 && se_imm < 0 && (Rss + se_imm) > 0)) {
-                return 1;
+        case OP_ADDI: // with overflow
+            if(Policy::strict_traps && ((Rss > 0 && se_imm > 0 && (Rss + se_imm) < 0) || (Rss < 0 && se_imm < 0 && (Rss + se_imm) > 0))) {
+                return cpu.status = STEP_TRAP;
             }
             set_register(rt, Rss + se_imm);
             break;
-        case 9: // addiu
+        case OP_ADDIU:
             set_register(rt, Rss + se_imm);
             break;
-        case 10: // slti
+        case OP_SLTI:
             set_register(rt, Rss < se_imm);
             break;
-        case 11: // sltiu
+        case OP_SLTIU:
             set_register(rt, Rss < imm);
             break;
-        case 12: // andi
+        case OP_ANDI:
             set_register(rt, Rs & imm);
             break;
-        case 13: // ori
+        case OP_ORI:
             set_register(rt, Rs | imm);
             break;
-        case 14: // xori
+        case OP_XORI:
             set_register(rt, Rs ^ imm);
             break;
-        case 15: // lui
+        case OP_LUI:
             set_register(rt, (imm << 16) | (0xffff & Rs));
             break;
-        case 32: // lb
+        case OP_LB:
             {
                 BYTE res = load_byte(Rs + se_imm);
                 REGISTER se_res = ((res & 0x80) != 0) ? (0xffffff << 8) | res : res;
                 set_register(rt, se_res);
             }
             break;
-        case 33: // lh
-            if((Rs + se_imm) & 0x1)
-                return 1; // Trap if not multiple of 2
+        case OP_LH:
+            if(Policy::strict_traps && ((Rs + se_imm) & 0x1))
+                return cpu.status = STEP_TRAP; // Trap if not multiple of 2
             else
             {
-                WORD a = load_byte(Rs + se_imm);
-                WORD b = load_byte(Rs + se_imm + 1);
-                WORD res = a | (b << 8);
+                WORD res = halfword<Policy>(load_byte(Rs + se_imm), load_byte(Rs + se_imm + 1));
                 REGISTER se_res = ((res & 0x8000) != 0) ? (0xffff << 16) | res : res;
                 set_register(rt, se_res);
             }
             break;
-        case 34: // lwl
+        case OP_LWL:
             {
-                ADDRESS effective_address = Rs + se_imm;
-                WORD aligned_word = load_word(effective_address & 0xfffffffc);
-                int left_shift = 3 - (effective_address & 0b11);
+                WORD aligned_word = load_word((Rs + se_imm) & 0xfffffffc);
+                int left_shift = 3 - lane;
                 set_register(rt, aligned_word << (8 * left_shift));
             }
             break;
-        case 35: // lw
-            if((Rs + se_imm) & 0x3)
-                return 1; // Trap if not multiple of 4
+        case OP_LW:
+            if(Policy::strict_traps && ((Rs + se_imm) & 0x3))
+                return cpu.status = STEP_TRAP; // Trap if not multiple of 4
             else
             {
                 set_register(rt, load_word(Rs + se_imm));
             }
             break;
-        case 36: // lbu
+        case OP_LBU:
             {
                 BYTE res = load_byte(Rs + se_imm);
                 set_register(rt, res);
             }
             break;
-        case 37: // lhu
-            if((Rs + se_imm) & 0x1)
-                return 1; // Trap if not multiple of 2
+        case OP_LHU:
+            if(Policy::strict_traps && ((Rs + se_imm) & 0x1))
+                return cpu.status = STEP_TRAP; // Trap if not multiple of 2
             else
             {
-                WORD a = load_byte(Rs + se_imm);
-                WORD b = load_byte(Rs + se_imm + 1);
-                WORD res = a | (b << 8);
+                WORD res = halfword<Policy>(load_byte(Rs + se_imm), load_byte(Rs + se_imm + 1));
                 set_register(rt, res);
             }
             break;
-        case 38: // lwr
+        case OP_LWR:
             {
-                ADDRESS effective_address = Rs + se_imm;
-                WORD aligned_word = load_word(effective_address & 0xfffffffc);
-                int right_shift = effective_address & 0b11;
+                WORD aligned_word = load_word((Rs + se_imm) & 0xfffffffc);
+                int right_shift = lane;
                 set_register(rt, aligned_word >> (8 * right_shift));
             }
             break;
-        case 40: // sb
+        case OP_SB:
             store_byte(Rt, Rs + se_imm);
             break;
-        case 41: // sh
-            if((Rs + se_imm) & 0x1)
-                return 1; // Trap if not multiple of 2
+        case OP_SH:
+            if(Policy::strict_traps && ((Rs + se_imm) & 0x1))
+                return cpu.status = STEP_TRAP; // Trap if not multiple of 2
             else
             {
                 WORD a = Rt >> 8;
-                store_byte(Rt, Rs + se_imm);
-                store_byte(a, Rs + se_imm + 1);
+                store_byte(Policy::big_endian ? a : Rt, Rs + se_imm);
+                store_byte(Policy::big_endian ? Rt : a, Rs + se_imm + 1);
             }
             break;
-        case 43: // sw
-            if((Rs + se_imm) & 0x3)
-                return 1; // Trap if not multiple of 4
+        case OP_SW:
+            if(Policy::strict_traps && ((Rs + se_imm) & 0x3))
+                return cpu.status = STEP_TRAP; // Trap if not multiple of 4
             else
             {
                 store_word(Rt, Rs + se_imm);
@@ -382,7 +504,22 @@ int Emulator::step() {
             break;
     }
 
-    PC = PC + 4;
+    cpu.PC = cpu.PC + 4;
 
     return 0;
 }
+
+// Every combination of features, each with its own copy of the loops above, for AnyEmulator to
+// choose from
+#define EMU_INSTANTIATE(features) template class BasicEmulator<EmulatorPolicy<features>>;
+#define EMU_INSTANTIATE_8(base)                                                                          \
+    EMU_INSTANTIATE(base) EMU_INSTANTIATE(base + 1) EMU_INSTANTIATE(base + 2) EMU_INSTANTIATE(base + 3) \
+    EMU_INSTANTIATE(base + 4) EMU_INSTANTIATE(base + 5) EMU_INSTANTIATE(base + 6) EMU_INSTANTIATE(base + 7)
+EMU_INSTANTIATE_8(0)
+EMU_INSTANTIATE_8(8)
+EMU_INSTANTIATE_8(16)
+EMU_INSTANTIATE_8(24)
+EMU_INSTANTIATE_8(32)
+EMU_INSTANTIATE_8(40)
+EMU_INSTANTIATE_8(48)
+EMU_INSTANTIATE_8(56)
@@ -1,4 +1,9 @@
+#ifndef EMULATOR_HPP
+#define EMULATOR_HPP
+
+#include <cstddef>
 #include <cstdio>
+#include <type_traits>
 
 typedef unsigned int REGISTER;
 typedef unsigned int ADDRESS;
@@ -6,19 +11,122 @@ typedef unsigned int WORD;
 typedef unsigned long long int DWORD;
 typedef unsigned char BYTE;
 
-class Emulator {
-    BYTE* memory;
+// Values returned by step(); any other non-zero value is the code of a break instruction
+enum StepStatus {
+    STEP_OK = 0,
+    STEP_TRAP = 1,
+    STEP_SYSCALL = 1 << 20, // above the 20 bits a break code can use
+    STEP_FAULT = 1 << 21    // fetch, load or store outside of memory; nothing was changed
+};
+
+// Granularity of dirty-page tracking
+#define EMU_PAGE_BITS 12
+#define EMU_PAGE_SIZE (1 << EMU_PAGE_BITS)
+
+// Index of the register slot that writes to $0 land in
+#define DISCARD_SLOT 32
+
+// Architectural state of one CPU, kept in whole cache lines at fixed offsets so that generated
+// code and batch engines can address it directly. Writes to $0 land in the discard slot after
+// $31, so gpr[0] always reads as 0 without a branch.
+struct alignas(64) CPUState {
+    REGISTER gpr[DISCARD_SLOT + 1]; // $0 to $31, then the discard slot
     REGISTER PC;
     REGISTER HI;
     REGISTER LO;
-    REGISTER* registers;
+    REGISTER status; // last non-zero value returned by step()
+};
+
+static_assert(offsetof(CPUState, gpr) == 0, "GPRs must start the CPU state");
+static_assert(sizeof(CPUState::gpr) == (DISCARD_SLOT + 1) * sizeof(REGISTER), "discard slot must follow $31");
+static_assert(offsetof(CPUState, PC) == 132, "CPU state layout changed");
+static_assert(offsetof(CPUState, HI) == 136, "CPU state layout changed");
+static_assert(offsetof(CPUState, LO) == 140, "CPU state layout changed");
+static_assert(offsetof(CPUState, status) == 144, "CPU state layout changed");
+static_assert(sizeof(CPUState) == 192, "CPU state must fill exactly three cache lines");
+
+// Slot a write to register `number` goes to: $0 is redirected to the discard slot, without a branch
+constexpr int register_slot(int number) {
+    return number + (number == 0) * DISCARD_SLOT;
+}
+
+// Per-opcode execution counters, kept by emulators whose policy has EMU_COUNTING
+struct Counters {
+    DWORD opcode[64];     // executed, by primary opcode
+    DWORD func[64];       // executed R-type (opcode 0), by func
+    DWORD branch[8][2];   // beq/bne/blez/bgtz (opcodes 4-7), [not taken, taken]
+    DWORD traps;
+    DWORD breaks;
+    DWORD syscalls;
+    DWORD faults;         // STEP_FAULT, with EMU_BOUNDS_CHECKS
+};
+
+// Features an emulator can be compiled with. Each one left out is absent from the generated
+// code, not skipped at run time:
+//   EMU_TRACING         trace_to() records executed instructions
+//   EMU_DIRTY_TRACKING  track_dirty() flags the pages stores touch
+//   EMU_BOUNDS_CHECKS   fetches, loads and stores outside of memory return STEP_FAULT; without it
+//                       the program must stay in bounds
+//   EMU_COUNTING        counters() counts executed opcodes, branches and traps
+//   EMU_STRICT_TRAPS    add, sub and addi trap on overflow and lh, lhu, lw, sh and sw on misaligned
+//                       addresses; without it they wrap and access the bytes as addressed
+//   EMU_BIG_ENDIAN      words and halves are stored most significant byte first
+#define EMU_TRACING 0x1
+#define EMU_DIRTY_TRACKING 0x2
+#define EMU_BOUNDS_CHECKS 0x4
+#define EMU_COUNTING 0x8
+#define EMU_STRICT_TRAPS 0x10
+#define EMU_BIG_ENDIAN 0x20
+#define EMU_FEATURE_SETS 64
+
+// An emulator policy is any type with these constants; EmulatorPolicy builds one from feature bits
+template<unsigned Features>
+struct EmulatorPolicy {
+    static constexpr unsigned features = Features;
+    static constexpr bool tracing = Features & EMU_TRACING;
+    static constexpr bool dirty_tracking = Features & EMU_DIRTY_TRACKING;
+    static constexpr bool bounds_checks = Features & EMU_BOUNDS_CHECKS;
+    static constexpr bool counting = Features & EMU_COUNTING;
+    static constexpr bool strict_traps = Features & EMU_STRICT_TRAPS;
+    static constexpr bool big_endian = Features & EMU_BIG_ENDIAN;
+};
+
+// Everything but big-endian memory; counting only in builds with -DEMU_COUNTERS
+#ifdef EMU_COUNTERS
+#define EMU_DEFAULT_FEATURES (EMU_TRACING | EMU_DIRTY_TRACKING | EMU_BOUNDS_CHECKS | EMU_COUNTING | EMU_STRICT_TRAPS)
+#else
+#define EMU_DEFAULT_FEATURES (EMU_TRACING | EMU_DIRTY_TRACKING | EMU_BOUNDS_CHECKS | EMU_STRICT_TRAPS)
+#endif
+
+class TraceRing;
+
+struct NoCounters {};
+
+// The emulator, specialised for one policy: every combination of features gets its own step()
+// and run() loops. The definitions are in Emulator.cpp, instantiated there for every
+// EmulatorPolicy.
+template<typename Policy>
+class BasicEmulator {
+    CPUState cpu;
+    BYTE* memory;
     size_t memory_size;
+    TraceRing* tracer;
+    BYTE* dirty;
+    [[no_unique_address]] std::conditional_t<Policy::counting, Counters, NoCounters> counts;
 
-    void init(size_t mem_size, WORD* progam, size_t program_size);
+    void init(size_t mem_size, const WORD* progam, size_t program_size);
+    int execute();
+    int traced_step();
 
     public:
-    Emulator(size_t mem_size);
-    Emulator(size_t mem_size, WORD* progam, size_t program_size);
+    typedef Policy policy;
+
+    BasicEmulator(size_t mem_size);
+    BasicEmulator(size_t mem_size, const WORD* progam, size_t program_size);
+    ~BasicEmulator();
+
+    BasicEmulator(const BasicEmulator&) = delete;
+    BasicEmulator& operator=(const BasicEmulator&) = delete;
 
     void dump_memory_range(BYTE* start, int length, int bytes_per_row);
     void memory_dump(int bytes_per_row);
@@ -29,4 +137,28 @@ class Emulator {
     WORD get_register(int number);
     void set_register(int number, WORD value);
     int step();
+    // Steps until an instruction returns anything but STEP_OK (which is returned) or budget
+    // instructions have run; adds the instructions run to executed
+    int run(DWORD budget, DWORD& executed);
+    // The same, showing every instruction to an ExecutionObserver before and after it executes.
+    // Defined in Observer.hpp, so that the calls into a final observer class are direct.
+    template<typename Observer>
+    int run(DWORD budget, DWORD& executed, Observer& observer);
+
+    CPUState& state() { return cpu; }
+    BYTE* get_memory() { return memory; }
+    size_t get_memory_size() { return memory_size; }
+
+    // Records every executed instruction into ring (NULL to stop tracing)
+    void trace_to(TraceRing* ring) requires Policy::tracing { tracer = ring; }
+    // Sets pages[address >> EMU_PAGE_BITS] on every store (NULL to stop); one byte per page
+    void track_dirty(BYTE* pages) requires Policy::dirty_tracking { dirty = pages; }
+
+    Counters& counters() requires Policy::counting { return counts; }
+    void reset_counters() requires Policy::counting { counts = Counters(); }
 };
+
+typedef BasicEmulator<EmulatorPolicy<EMU_DEFAULT_FEATURES>> Emulator;
+extern template class BasicEmulator<EmulatorPolicy<EMU_DEFAULT_FEATURES>>;
+
+#endif
@@ -0,0 +1,189 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include "Fuzzer.hpp"
+
+using namespace std;
+
+const char* fuzz_outcome_name(FuzzOutcome outcome) {
+    static const char* names[FUZZ_OUTCOMES] = {"exit", "break", "trap", "syscall", "fault", "timeout"};
+    return names[outcome];
+}
+
+FuzzTarget::FuzzTarget(const function<Emulator*()>& load, const FuzzConfig& config)
+    : config(config), emulator(load()), reached(false), restored(0) {
+    CPUState& cpu = emulator->state();
+    for(DWORD i = 0; i < config.snapshot_budget && cpu.PC != config.snapshot_pc; i++) {
+        if(emulator->step() != STEP_OK) break;
+    }
+    if(cpu.PC != config.snapshot_pc) return;
+
+    // A test case must fit in memory
+    if((size_t)config.input_address + config.input_capacity > emulator->get_memory_size()) return;
+
+    snapshot.assign(emulator->get_memory(), emulator->get_memory() + emulator->get_memory_size());
+    snapshot_cpu = cpu;
+    dirty.assign((emulator->get_memory_size() + EMU_PAGE_SIZE - 1) / EMU_PAGE_SIZE, 0);
+    emulator->track_dirty(dirty.data());
+    reached = true;
+}
+
+FuzzTarget::~FuzzTarget() {
+    delete emulator;
+}
+
+void FuzzTarget::restore() {
+    BYTE* memory = emulator->get_memory();
+    size_t size = emulator->get_memory_size();
+
+    for(size_t page = 0; page < dirty.size(); page++) {
+        if(!dirty[page]) continue;
+        size_t start = page * EMU_PAGE_SIZE;
+        memcpy(memory + start, snapshot.data() + start, min((size_t)EMU_PAGE_SIZE, size - start));
+        dirty[page] = 0;
+        restored++;
+    }
+    emulator->state() = snapshot_cpu;
+}
+
+FuzzResult FuzzTarget::execute(const BYTE* input, size_t size) {
+    CPUState& cpu = emulator->state();
+    size = min(size, config.input_capacity);
+
+    memcpy(emulator->get_memory() + config.input_address, input, size);
+    if(size > 0) {
+        for(size_t page = config.input_address >> EMU_PAGE_BITS; page <= (config.input_address + size - 1) >> EMU_PAGE_BITS;
+            page++)
+            dirty[page] = 1;
+    }
+    if(config.length_register > 0)
+        cpu.gpr[config.length_register] = size;
+
+    FuzzResult result = {FUZZ_TIMEOUT, STEP_OK, 0, 0};
+    edge_coverage.reset();
+    result.status = emulator->run(config.budget, result.executed, edge_coverage);
+    result.pc = cpu.PC;
+
+    if(result.status == STEP_OK) result.outcome = FUZZ_TIMEOUT;
+    else if(result.status == (int)config.exit_code) result.outcome = FUZZ_EXIT;
+    else if(result.status == STEP_TRAP) result.outcome = FUZZ_TRAP;
+    else if(result.status == STEP_SYSCALL) result.outcome = FUZZ_SYSCALL;
+    else if(result.status == STEP_FAULT) result.outcome = FUZZ_FAULT;
+    else result.outcome = FUZZ_BREAK;
+
+    restore();
+    return result;
+}
+
+Fuzzer::Fuzzer(const function<Emulator*()>& load, const FuzzConfig& config)
+    : load(load), config(config), virgin(COVERAGE_MAP_SIZE, 0xff) {
+    memset(&totals, 0, sizeof(totals));
+}
+
+void Fuzzer::add_seed(const vector<BYTE>& input) {
+    lock_guard<mutex> guard(lock);
+    queue.push_back(input);
+}
+
+static WORD next_random(WORD& state) {
+    // xorshift32
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+void Fuzzer::mutate(vector<BYTE>& input, WORD& rng) {
+    static const BYTE interesting[] = {0, 1, 0x7f, 0x80, 0xff, 16, 32, 64, 100, 127};
+    int stack = 1 + next_random(rng) % 4;
+
+    for(int m = 0; m < stack; m++) {
+        if(input.empty()) input.push_back(0);
+        size_t at = next_random(rng) % input.size();
+
+        switch(next_random(rng) % 7) {
+            case 0: // flip a bit
+                input[at] ^= 1 << (next_random(rng) % 8);
+                break;
+            case 1: // random byte
+                input[at] = next_random(rng);
+                break;
+            case 2: // interesting byte
+                input[at] = interesting[next_random(rng) % sizeof(interesting)];
+                break;
+            case 3: // small arithmetic
+                input[at] += (int)(next_random(rng) % 35) - 17;
+                break;
+            case 4: // grow
+                if(input.size() < config.input_capacity) input.push_back(next_random(rng));
+                break;
+            case 5: // shrink
+                if(input.size() > 1) input.pop_back();
+                break;
+            case 6: // copy a byte over another
+                input[at] = input[next_random(rng) % input.size()];
+                break;
+        }
+    }
+}
+
+void Fuzzer::worker(unsigned seed, DWORD executions) {
+    FuzzTarget target(load, config);
+    if(!target.ready()) return;
+
+    WORD rng = seed * 2654435761u + 1;
+    vector<BYTE> local_virgin(COVERAGE_MAP_SIZE, 0xff);
+    DWORD outcomes[FUZZ_OUTCOMES] = {};
+    vector<BYTE> input;
+
+    for(DWORD n = 0; n < executions; n++) {
+        {
+            lock_guard<mutex> guard(lock);
+            input = queue[next_random(rng) % queue.size()];
+        }
+        mutate(input, rng);
+        if(input.size() > config.input_capacity) input.resize(config.input_capacity);
+
+        FuzzResult result = target.execute(input.data(), input.size());
+        outcomes[result.outcome]++;
+
+        bool interesting = target.coverage().merge_into(local_virgin.data());
+        if(!interesting && result.outcome == FUZZ_EXIT) continue;
+
+        lock_guard<mutex> guard(lock);
+        if(interesting && target.coverage().merge_into(virgin.data()))
+            queue.push_back(input);
+
+        if(result.outcome != FUZZ_EXIT) {
+            // Timeouts are one crash wherever they stop
+            bool known = any_of(crash_list.begin(), crash_list.end(), [&](const FuzzCrash& c) {
+                return c.result.outcome == result.outcome && (result.outcome == FUZZ_TIMEOUT || c.result.pc == result.pc);
+            });
+            if(!known) crash_list.push_back({result, input});
+        }
+    }
+
+    lock_guard<mutex> guard(lock);
+    totals.executions += executions;
+    for(int o = 0; o < FUZZ_OUTCOMES; o++) totals.outcomes[o] += outcomes[o];
+}
+
+FuzzStats Fuzzer::run(unsigned threads, DWORD executions, unsigned seed) {
+    if(threads == 0) threads = 1;
+    if(queue.empty()) add_seed(vector<BYTE>(1, 0));
+
+    auto begin = chrono::steady_clock::now();
+    vector<thread> workers;
+    for(unsigned t = 0; t < threads; t++) {
+        DWORD share = executions / threads + (t < executions % threads);
+        workers.emplace_back(&Fuzzer::worker, this, seed + t, share);
+    }
+    for(thread& t : workers) t.join();
+
+    totals.seconds += chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+    totals.corpus = queue.size();
+    totals.crashes = crash_list.size();
+    return totals;
+}
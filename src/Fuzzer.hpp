@@ -0,0 +1,117 @@
+#ifndef FUZZER_HPP
+#define FUZZER_HPP
+
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "Coverage.hpp"
+#include "Emulator.hpp"
+
+enum FuzzOutcome {
+    FUZZ_EXIT,    // the break code of a normal exit
+    FUZZ_BREAK,   // any other break
+    FUZZ_TRAP,
+    FUZZ_SYSCALL,
+    FUZZ_FAULT,   // access outside of memory
+    FUZZ_TIMEOUT, // budget ran out
+    FUZZ_OUTCOMES
+};
+
+const char* fuzz_outcome_name(FuzzOutcome outcome);
+
+struct FuzzConfig {
+    // The program runs from its start to here once, and every test case starts from this state
+    ADDRESS snapshot_pc = 0;
+    DWORD snapshot_budget = 100000000;
+    // Where each test case is copied to, and at most how much of it
+    ADDRESS input_address = 0;
+    size_t input_capacity = 0;
+    // Register that receives the length of the test case, or -1
+    int length_register = -1;
+    DWORD budget = 100000;
+    // WORKLOAD_DONE of the workload corpus
+    WORD exit_code = (31 << 5) | 31;
+};
+
+struct FuzzResult {
+    FuzzOutcome outcome;
+    int status;
+    ADDRESS pc;
+    DWORD executed;
+};
+
+// One emulator for running test cases: loaded and run to the snapshot PC once, then reset after
+// every test case by copying back only the pages it stored to.
+class FuzzTarget {
+    FuzzConfig config;
+    Emulator* emulator;
+    EdgeCoverage edge_coverage;
+    std::vector<BYTE> snapshot;
+    CPUState snapshot_cpu;
+    std::vector<BYTE> dirty;
+    bool reached;
+    DWORD restored;
+
+    void restore();
+
+    public:
+    FuzzTarget(const std::function<Emulator*()>& load, const FuzzConfig& config);
+    ~FuzzTarget();
+    FuzzTarget(const FuzzTarget&) = delete;
+    FuzzTarget& operator=(const FuzzTarget&) = delete;
+
+    // Whether the snapshot PC was reached; nothing can run otherwise
+    bool ready() { return reached; }
+
+    // Runs one test case; the emulator is back at the snapshot afterwards
+    FuzzResult execute(const BYTE* input, size_t size);
+
+    // Edges of the last test case
+    EdgeCoverage& coverage() { return edge_coverage; }
+    Emulator& emulator_state() { return *emulator; }
+    DWORD pages_restored() { return restored; }
+};
+
+struct FuzzCrash {
+    FuzzResult result;
+    std::vector<BYTE> input;
+};
+
+struct FuzzStats {
+    DWORD executions;
+    DWORD outcomes[FUZZ_OUTCOMES];
+    size_t corpus;
+    size_t crashes;
+    double seconds;
+};
+
+// Coverage-guided mutational fuzzer. Each thread has its own FuzzTarget and mutates inputs from
+// the shared corpus; inputs reaching new edges join the corpus, and every distinct way of not
+// exiting normally (outcome and PC) is kept as a crash.
+class Fuzzer {
+    std::function<Emulator*()> load;
+    FuzzConfig config;
+
+    std::mutex lock;
+    std::vector<std::vector<BYTE>> queue;
+    std::vector<FuzzCrash> crash_list;
+    std::vector<BYTE> virgin;
+    FuzzStats totals;
+
+    void worker(unsigned seed, DWORD executions);
+    void mutate(std::vector<BYTE>& input, WORD& rng);
+
+    public:
+    Fuzzer(const std::function<Emulator*()>& load, const FuzzConfig& config);
+
+    void add_seed(const std::vector<BYTE>& input);
+
+    // Runs about `executions` test cases over `threads` threads
+    FuzzStats run(unsigned threads, DWORD executions, unsigned seed = 1);
+
+    const std::vector<std::vector<BYTE>>& corpus() { return queue; }
+    const std::vector<FuzzCrash>& crashes() { return crash_list; }
+};
+
+#endif
@@ -0,0 +1,181 @@
+#include <algorithm>
+
+#include "Generator.hpp"
+#include "Utilities.hpp"
+
+using namespace std;
+
+// Registers the generator keeps for itself
+#define LOOP_COUNTER 27
+#define DATA_BASE 28
+// Random instructions write $1 to $23 and read $0 to $23
+#define WRITABLE 23
+
+// The trapping ones last
+static const int alu_funcs[] = {FUNC_ADDU, FUNC_SUBU, FUNC_AND, FUNC_OR,   FUNC_XOR, FUNC_NOR,
+                                FUNC_SLT,  FUNC_SLTU, FUNC_MOVZ, FUNC_MOVN, FUNC_ADD, FUNC_SUB};
+static const int immediate_opcodes[] = {OP_ADDIU, OP_SLTI, OP_SLTIU, OP_ANDI, OP_ORI, OP_XORI, OP_LUI, OP_ADDI};
+static const int shift_funcs[] = {FUNC_SLL, FUNC_SRL, FUNC_SRA, FUNC_SLLV, FUNC_SRLV, FUNC_SRAV};
+static const int load_opcodes[] = {OP_LB, OP_LBU, OP_LH, OP_LHU, OP_LW};
+static const int store_opcodes[] = {OP_SB, OP_SH, OP_SW};
+// Access size of each entry above
+static const int load_sizes[] = {1, 1, 2, 2, 4};
+static const int store_sizes[] = {1, 2, 4};
+
+Emulator* GeneratedProgram::load() const {
+    return new Emulator(memory_size, code.data(), code.size());
+}
+
+ProgramGenerator::ProgramGenerator(const GeneratorConfig& config, WORD seed)
+    : config(config), rng(seed ? seed : 1), total_weight(0) {
+    for(int c = 0; c < GEN_CLASSES; c++) total_weight += config.weights[c];
+    this->config.footprint = max((size_t)4, min(config.footprint, (size_t)0x8000)) & ~(size_t)3;
+    this->config.max_trips = max(config.max_trips, 1u);
+    this->config.max_loop_body = max(config.max_loop_body, (size_t)1);
+}
+
+WORD ProgramGenerator::next() {
+    // xorshift32
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+int ProgramGenerator::destination() {
+    return 1 + next() % WRITABLE;
+}
+
+int ProgramGenerator::source() {
+    return next() % (WRITABLE + 1);
+}
+
+GeneratedClass ProgramGenerator::pick(bool in_loop) {
+    if(total_weight == 0) return GEN_ALU;
+
+    unsigned ticket = next() % total_weight;
+    int c = 0;
+    while(ticket >= config.weights[c]) ticket -= config.weights[c++];
+    // Loops do not nest
+    return in_loop && c == GEN_LOOP ? GEN_ALU : (GeneratedClass)c;
+}
+
+void ProgramGenerator::instruction(vector<WORD>& code, GeneratedClass kind, size_t left) {
+    // Branch and jump targets stay within the block: at most the first instruction after it
+    size_t skip = next() % (min(config.max_skip, left - 1) + 1);
+    int op;
+
+    switch(kind) {
+        case GEN_LOOP:
+        case GEN_ALU:
+            op = alu_funcs[next() % (config.trapping ? 12 : 10)];
+            code.push_back(Utilities::R_instruction(OP_SPECIAL, destination(), source(), source(), 0, op));
+            break;
+        case GEN_IMMEDIATE:
+            op = immediate_opcodes[next() % (config.trapping ? 8 : 7)];
+            code.push_back(Utilities::I_instruction(op, destination(), op == OP_LUI ? 0 : source(), next()));
+            break;
+        case GEN_SHIFT:
+            op = shift_funcs[next() % 6];
+            if(op <= FUNC_SRA) code.push_back(Utilities::R_instruction(OP_SPECIAL, destination(), 0, source(), next(), op));
+            else code.push_back(Utilities::R_instruction(OP_SPECIAL, destination(), source(), source(), 0, op));
+            break;
+        case GEN_MULDIV:
+            switch(next() % 4) {
+                case 0:
+                case 1: // mult, multu, div, divu
+                    op = FUNC_MULT + next() % 4;
+                    code.push_back(Utilities::R_instruction(OP_SPECIAL, 0, source(), source(), 0, op));
+                    break;
+                case 2: // mfhi, mflo
+                    op = next() % 2 ? FUNC_MFHI : FUNC_MFLO;
+                    code.push_back(Utilities::R_instruction(OP_SPECIAL, destination(), 0, 0, 0, op));
+                    break;
+                case 3: // mthi, mtlo
+                    op = next() % 2 ? FUNC_MTHI : FUNC_MTLO;
+                    code.push_back(Utilities::R_instruction(OP_SPECIAL, 0, source(), 0, 0, op));
+                    break;
+            }
+            break;
+        case GEN_LOAD: {
+            int which = next() % 5;
+            int offset = next() % (config.footprint / load_sizes[which]) * load_sizes[which];
+            code.push_back(Utilities::I_instruction(load_opcodes[which], destination(), DATA_BASE, offset));
+            break;
+        }
+        case GEN_STORE: {
+            int which = next() % 3;
+            int offset = next() % (config.footprint / store_sizes[which]) * store_sizes[which];
+            code.push_back(Utilities::I_instruction(store_opcodes[which], source(), DATA_BASE, offset));
+            break;
+        }
+        case GEN_BRANCH:
+            op = OP_BEQ + next() % 4;
+            // blez and bgtz only have rs
+            code.push_back(Utilities::I_instruction(op, op < OP_BLEZ ? source() : 0, source(), skip + 1));
+            break;
+        case GEN_JUMP:
+            op = next() % 2 ? OP_J : OP_JAL;
+            code.push_back(Utilities::J_instruction(op, code.size() + 1 + skip));
+            break;
+        case GEN_CLASSES:
+            break;
+    }
+}
+
+DWORD ProgramGenerator::block(vector<WORD>& code, size_t count, bool in_loop) {
+    DWORD cost = 0;
+    size_t produced = 0;
+
+    while(produced < count) {
+        size_t left = count - produced;
+        GeneratedClass kind = pick(in_loop);
+
+        if(kind == GEN_LOOP && left >= 4) {
+            size_t body = 1 + next() % min(config.max_loop_body, left - 3);
+            int trips = 1 + next() % config.max_trips;
+
+            code.push_back(Utilities::I_instruction(OP_ADDIU, LOOP_COUNTER, 0, trips));
+            DWORD inner = block(code, body, true);
+            code.push_back(Utilities::I_instruction(OP_ADDIU, LOOP_COUNTER, LOOP_COUNTER, -1));
+            code.push_back(Utilities::I_instruction(OP_BGTZ, 0, LOOP_COUNTER, -(int)(body + 1))); // bgtz to the body
+
+            cost += 1 + trips * (inner + 2);
+            produced += body + 3;
+            continue;
+        }
+
+        instruction(code, kind, left);
+        cost++;
+        produced++;
+    }
+
+    return cost;
+}
+
+GeneratedProgram ProgramGenerator::generate() {
+    GeneratedProgram program;
+    vector<WORD>& code = program.code;
+
+    size_t prologue = 2 + (config.seed_registers ? 2 * WRITABLE : 0);
+    size_t words = prologue + config.length + 1;
+    program.data_address = (words * 4 + EMU_PAGE_SIZE - 1) & ~(size_t)(EMU_PAGE_SIZE - 1);
+    program.memory_size = program.data_address + ((config.footprint + EMU_PAGE_SIZE - 1) & ~(size_t)(EMU_PAGE_SIZE - 1));
+    code.reserve(words);
+
+    code.push_back(Utilities::I_instruction(OP_LUI, DATA_BASE, 0, program.data_address >> 16));
+    code.push_back(Utilities::I_instruction(OP_ORI, DATA_BASE, DATA_BASE, program.data_address & 0xffff));
+    if(config.seed_registers) {
+        for(int r = 1; r <= WRITABLE; r++) {
+            code.push_back(Utilities::I_instruction(OP_LUI, r, 0, next()));
+            code.push_back(Utilities::I_instruction(OP_ORI, r, r, next()));
+        }
+    }
+
+    DWORD cost = block(code, config.length, false);
+    WORD exit = config.exit_code;
+    code.push_back(Utilities::R_instruction(OP_SPECIAL, exit >> 5, exit >> 15, exit >> 10, exit & 0b11111, FUNC_BREAK));
+
+    program.max_instructions = prologue + cost + 1;
+    return program;
+}
@@ -0,0 +1,73 @@
+#ifndef GENERATOR_HPP
+#define GENERATOR_HPP
+
+#include <vector>
+
+#include "Emulator.hpp"
+
+// Kinds of instruction a generated program is drawn from
+enum GeneratedClass {
+    GEN_ALU,       // addu, subu, and, or, xor, nor, slt, sltu, movz, movn (add, sub if trapping)
+    GEN_IMMEDIATE, // addiu, slti, sltiu, andi, ori, xori, lui (addi if trapping)
+    GEN_SHIFT,     // sll, srl, sra, sllv, srlv, srav
+    GEN_MULDIV,    // mult, multu, div, divu, mfhi, mflo, mthi, mtlo
+    GEN_LOAD,      // lb, lbu, lh, lhu, lw
+    GEN_STORE,     // sb, sh, sw
+    GEN_BRANCH,    // beq, bne, blez, bgtz, forward only
+    GEN_JUMP,      // j, jal, forward only
+    GEN_LOOP,      // a counted loop around a random body
+    GEN_CLASSES
+};
+
+struct GeneratorConfig {
+    // Relative weight of each GeneratedClass
+    unsigned weights[GEN_CLASSES] = {6, 4, 2, 1, 2, 2, 1, 0, 0};
+    // Instructions drawn for the body, loop bookkeeping included
+    size_t length = 256;
+    // Bytes loads and stores stay within, starting on the page after the code (at most 32 KiB)
+    size_t footprint = 1024;
+    // Branches and jumps skip at most this many instructions
+    size_t max_skip = 8;
+    // Loops run 1 to max_trips times over a body of at most max_loop_body instructions
+    unsigned max_trips = 8;
+    size_t max_loop_body = 16;
+    // Start from random values in $1-$23 rather than zeros
+    bool seed_registers = true;
+    // Include the instructions that trap on overflow, which can end a program early
+    bool trapping = false;
+    WORD exit_code = (31 << 5) | 31;
+};
+
+// A program that stops with config.exit_code (or a trap) within max_instructions. Only $1-$23,
+// $31, HI, LO and the data area are written; $27 counts loop trips and $28 holds the data address.
+struct GeneratedProgram {
+    std::vector<WORD> code;
+    ADDRESS data_address;
+    size_t memory_size;
+    DWORD max_instructions;
+
+    Emulator* load() const;
+};
+
+// Constrained random programs encoded with Utilities. Control flow only goes forward, except for
+// the closing branch of a counted loop, and loops do not nest, so every program terminates.
+class ProgramGenerator {
+    GeneratorConfig config;
+    WORD rng;
+    unsigned total_weight;
+
+    WORD next();
+    int destination();
+    int source();
+    GeneratedClass pick(bool in_loop);
+    // Appends `count` instructions, returning how many can run at most
+    DWORD block(std::vector<WORD>& code, size_t count, bool in_loop);
+    void instruction(std::vector<WORD>& code, GeneratedClass kind, size_t left);
+
+    public:
+    ProgramGenerator(const GeneratorConfig& config, WORD seed = 1);
+
+    GeneratedProgram generate();
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef INSTRUCTION_HPP
+#define INSTRUCTION_HPP
+
+#include "Emulator.hpp"
+#include "Isa.hpp"
+
+// Fields of an encoded instruction, extracted the same way step() does
+struct Instruction {
+    WORD word;
+    int opcode;
+    int rs;
+    int rt;
+    int rd;
+    int shamt;
+    int func;
+    int imm;
+    int se_imm;
+
+    explicit Instruction(WORD word) : word(word) {
+        opcode = (word >> 26) & 0b111111;
+        rs = (word >> 21) & 0b11111;
+        rt = (word >> 16) & 0b11111;
+        rd = (word >> 11) & 0b11111;
+        shamt = (word >> 6) & 0b11111;
+        func = word & 0b111111;
+        imm = word & 65535;
+        se_imm = ((word & 0x8000) != 0) ? (0xffff << 16) | imm : imm;
+    }
+
+    const IsaEntry& entry() const { return opcode == OP_SPECIAL ? isa_funcs[func] : isa_opcodes[opcode]; }
+
+    // lb, lh, lwl, lw, lbu, lhu, lwr
+    bool is_load() const { return isa_opcodes[opcode].kind == KIND_LOAD; }
+    // sb, sh, sw
+    bool is_store() const { return isa_opcodes[opcode].kind == KIND_STORE; }
+
+    // beq, bne, blez, bgtz
+    bool is_conditional_branch() const { return isa_opcodes[opcode].kind == KIND_BRANCH; }
+    // j, jal
+    bool is_jump() const { return opcode == OP_J || opcode == OP_JAL; }
+    // jal, jalr
+    bool is_call() const { return opcode == OP_JAL || (opcode == OP_SPECIAL && func == FUNC_JALR); }
+    // jr $31
+    bool is_return() const { return opcode == OP_SPECIAL && func == FUNC_JR && rs == 31; }
+    // jr or jalr, whose target comes from a register
+    bool is_indirect() const { return opcode == OP_SPECIAL && (func == FUNC_JR || func == FUNC_JALR); }
+
+    // Bytes touched by a load or store; lwl and lwr touch the aligned word around their byte
+    int access_size() const {
+        return opcode == OP_LWL || opcode == OP_LWR || isa_opcodes[opcode].bytes == 0 ? 4 : isa_opcodes[opcode].bytes;
+    }
+};
+
+#endif
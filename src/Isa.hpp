@@ -0,0 +1,157 @@
+#ifndef ISA_HPP
+#define ISA_HPP
+
+#include <array>
+
+#include "Emulator.hpp"
+
+// The instruction set step() executes, in one place.
+//
+// Each row is X(ID, mnemonic, number, format, kind, bytes): ID names the OP_ or FUNC_ constant,
+// number is the primary opcode (or the func of an opcode 0 instruction), format the operand
+// layout the assembler and disassembler use, kind the class reported by profilers, and bytes how
+// many bytes of memory step() checks a load or store against.
+//
+// The opcode and func enums, the decode tables below, the bounds checks and the case labels of
+// step(), the disassembler, the text assembler and the counter names are all derived from these
+// rows. Adding an instruction is a row here and its case in step().
+#define ISA_OPCODES(X)                                  \
+    X(J,     "j",     2,  FMT_JUMP,    KIND_JUMP,   0) \
+    X(JAL,   "jal",   3,  FMT_JUMP,    KIND_JUMP,   0) \
+    X(BEQ,   "beq",   4,  FMT_BRANCH2, KIND_BRANCH, 0) \
+    X(BNE,   "bne",   5,  FMT_BRANCH2, KIND_BRANCH, 0) \
+    X(BLEZ,  "blez",  6,  FMT_BRANCH1, KIND_BRANCH, 0) \
+    X(BGTZ,  "bgtz",  7,  FMT_BRANCH1, KIND_BRANCH, 0) \
+    X(ADDI,  "addi",  8,  FMT_IMM,     KIND_ALU,    0) \
+    X(ADDIU, "addiu", 9,  FMT_IMM,     KIND_ALU,    0) \
+    X(SLTI,  "slti",  10, FMT_IMM,     KIND_ALU,    0) \
+    X(SLTIU, "sltiu", 11, FMT_IMM,     KIND_ALU,    0) \
+    X(ANDI,  "andi",  12, FMT_UIMM,    KIND_ALU,    0) \
+    X(ORI,   "ori",   13, FMT_UIMM,    KIND_ALU,    0) \
+    X(XORI,  "xori",  14, FMT_UIMM,    KIND_ALU,    0) \
+    X(LUI,   "lui",   15, FMT_LUI,     KIND_ALU,    0) \
+    X(LB,    "lb",    32, FMT_MEMORY,  KIND_LOAD,   1) \
+    X(LH,    "lh",    33, FMT_MEMORY,  KIND_LOAD,   2) \
+    X(LWL,   "lwl",   34, FMT_MEMORY,  KIND_LOAD,   1) \
+    X(LW,    "lw",    35, FMT_MEMORY,  KIND_LOAD,   4) \
+    X(LBU,   "lbu",   36, FMT_MEMORY,  KIND_LOAD,   1) \
+    X(LHU,   "lhu",   37, FMT_MEMORY,  KIND_LOAD,   2) \
+    X(LWR,   "lwr",   38, FMT_MEMORY,  KIND_LOAD,   1) \
+    X(SB,    "sb",    40, FMT_MEMORY,  KIND_STORE,  1) \
+    X(SH,    "sh",    41, FMT_MEMORY,  KIND_STORE,  2) \
+    X(SW,    "sw",    43, FMT_MEMORY,  KIND_STORE,  4)
+
+// lwl and lwr check one byte: they read the aligned word around it, which is in memory as long
+// as the byte is
+
+#define ISA_FUNCS(X)                                        \
+    X(SLL,     "sll",     0,  FMT_RD_RT_SA, KIND_SHIFT,   0) \
+    X(SRL,     "srl",     2,  FMT_RD_RT_SA, KIND_SHIFT,   0) \
+    X(SRA,     "sra",     3,  FMT_RD_RT_SA, KIND_SHIFT,   0) \
+    X(SLLV,    "sllv",    4,  FMT_RD_RT_RS, KIND_SHIFT,   0) \
+    X(SRLV,    "srlv",    6,  FMT_RD_RT_RS, KIND_SHIFT,   0) \
+    X(SRAV,    "srav",    7,  FMT_RD_RT_RS, KIND_SHIFT,   0) \
+    X(JR,      "jr",      8,  FMT_RS,       KIND_JUMP,    0) \
+    X(JALR,    "jalr",    9,  FMT_JALR,     KIND_JUMP,    0) \
+    X(MOVZ,    "movz",    10, FMT_RD_RS_RT, KIND_ALU,     0) \
+    X(MOVN,    "movn",    11, FMT_RD_RS_RT, KIND_ALU,     0) \
+    X(SYSCALL, "syscall", 12, FMT_NONE,     KIND_TRAP,    0) \
+    X(BREAK,   "break",   13, FMT_BREAK,    KIND_TRAP,    0) \
+    X(MFHI,    "mfhi",    16, FMT_RD,       KIND_MULTDIV, 0) \
+    X(MTHI,    "mthi",    17, FMT_RS,       KIND_MULTDIV, 0) \
+    X(MFLO,    "mflo",    18, FMT_RD,       KIND_MULTDIV, 0) \
+    X(MTLO,    "mtlo",    19, FMT_RS,       KIND_MULTDIV, 0) \
+    X(MULT,    "mult",    24, FMT_RS_RT,    KIND_MULTDIV, 0) \
+    X(MULTU,   "multu",   25, FMT_RS_RT,    KIND_MULTDIV, 0) \
+    X(DIV,     "div",     26, FMT_RS_RT,    KIND_MULTDIV, 0) \
+    X(DIVU,    "divu",    27, FMT_RS_RT,    KIND_MULTDIV, 0) \
+    X(ADD,     "add",     32, FMT_RD_RS_RT, KIND_ALU,     0) \
+    X(ADDU,    "addu",    33, FMT_RD_RS_RT, KIND_ALU,     0) \
+    X(SUB,     "sub",     34, FMT_RD_RS_RT, KIND_ALU,     0) \
+    X(SUBU,    "subu",    35, FMT_RD_RS_RT, KIND_ALU,     0) \
+    X(AND,     "and",     36, FMT_RD_RS_RT, KIND_ALU,     0) \
+    X(OR,      "or",      37, FMT_RD_RS_RT, KIND_ALU,     0) \
+    X(XOR,     "xor",     38, FMT_RD_RS_RT, KIND_ALU,     0) \
+    X(NOR,     "nor",     39, FMT_RD_RS_RT, KIND_ALU,     0) \
+    X(SLT,     "slt",     42, FMT_RD_RS_RT, KIND_ALU,     0) \
+    X(SLTU,    "sltu",    43, FMT_RD_RS_RT, KIND_ALU,     0) \
+    X(TGE,     "tge",     48, FMT_RS_RT,    KIND_TRAP,    0) \
+    X(TGEU,    "tgeu",    49, FMT_RS_RT,    KIND_TRAP,    0) \
+    X(TLT,     "tlt",     50, FMT_RS_RT,    KIND_TRAP,    0) \
+    X(TLTU,    "tltu",    51, FMT_RS_RT,    KIND_TRAP,    0) \
+    X(TEQ,     "teq",     52, FMT_RS_RT,    KIND_TRAP,    0) \
+    X(TNE,     "tne",     54, FMT_RS_RT,    KIND_TRAP,    0)
+
+// Primary opcodes; R-type instructions are OP_SPECIAL with a Func
+enum Opcode {
+    OP_SPECIAL = 0,
+#define ISA_ENUM(id, name, number, format, kind, bytes) OP_##id = number,
+    ISA_OPCODES(ISA_ENUM)
+#undef ISA_ENUM
+};
+
+enum Func {
+#define ISA_ENUM(id, name, number, format, kind, bytes) FUNC_##id = number,
+    ISA_FUNCS(ISA_ENUM)
+#undef ISA_ENUM
+};
+
+// Operand layout, as written in assembler text
+enum IsaFormat {
+    FMT_INVALID, // not executed by step()
+    FMT_RD_RS_RT, // addu rd, rs, rt
+    FMT_RD_RT_SA, // sll rd, rt, shamt
+    FMT_RD_RT_RS, // sllv rd, rt, rs
+    FMT_RS_RT,    // mult rs, rt
+    FMT_RS,       // jr rs
+    FMT_RD,       // mfhi rd
+    FMT_JALR,     // jalr rs (step() always links into $31)
+    FMT_NONE,     // syscall
+    FMT_BREAK,    // break [code]
+    FMT_IMM,      // addiu rt, rs, signed imm
+    FMT_UIMM,     // andi rt, rs, unsigned imm
+    FMT_LUI,      // lui rt, unsigned imm
+    FMT_MEMORY,   // lw rt, offset(base)
+    FMT_BRANCH2,  // beq rs, rt, target
+    FMT_BRANCH1,  // blez rs, target
+    FMT_JUMP,     // j target
+    ISA_FORMATS
+};
+
+// Class of an instruction; unimplemented encodings count as traps
+enum IsaKind { KIND_ALU, KIND_SHIFT, KIND_MULTDIV, KIND_LOAD, KIND_STORE, KIND_BRANCH, KIND_JUMP, KIND_TRAP, ISA_KINDS };
+
+struct IsaEntry {
+    const char* name = NULL; // NULL if step() does not execute it
+    IsaFormat format = FMT_INVALID;
+    IsaKind kind = KIND_TRAP;
+    int bytes = 0;
+};
+
+// Decode tables, indexed by opcode and by func
+#define ISA_ROW(id, name, number, format, kind, bytes) table[number] = {name, format, kind, bytes};
+inline constexpr std::array<IsaEntry, 64> isa_opcodes = [] {
+    std::array<IsaEntry, 64> table{};
+    ISA_OPCODES(ISA_ROW)
+    return table;
+}();
+inline constexpr std::array<IsaEntry, 64> isa_funcs = [] {
+    std::array<IsaEntry, 64> table{};
+    ISA_FUNCS(ISA_ROW)
+    return table;
+}();
+#undef ISA_ROW
+
+// Bytes step() checks against the end of memory, by opcode (0 for anything but loads and stores)
+inline constexpr std::array<BYTE, 64> isa_access_bytes = [] {
+    std::array<BYTE, 64> table{};
+    for(int i = 0; i < 64; i++) table[i] = isa_opcodes[i].bytes;
+    return table;
+}();
+
+constexpr const IsaEntry& isa_entry(WORD word) {
+    int opcode = (word >> 26) & 0b111111;
+    return opcode == OP_SPECIAL ? isa_funcs[word & 0b111111] : isa_opcodes[opcode];
+}
+
+#endif
@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+#include "Latency.hpp"
+
+using namespace std;
+
+#if defined(__x86_64__) || defined(__i386__)
+#define TICK_UNIT "tsc"
+
+// The fences keep the timed step() from being reordered around the reads
+static inline DWORD ticks() {
+    _mm_lfence();
+    DWORD t = __rdtsc();
+    _mm_lfence();
+    return t;
+}
+#else
+#define TICK_UNIT "ns"
+
+static inline DWORD ticks() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+#endif
+
+static_assert(CLASS_ALU == (int)KIND_ALU && CLASS_SHIFT == (int)KIND_SHIFT && CLASS_MULTDIV == (int)KIND_MULTDIV &&
+                  CLASS_LOAD == (int)KIND_LOAD && CLASS_STORE == (int)KIND_STORE && CLASS_BRANCH == (int)KIND_BRANCH &&
+                  CLASS_JUMP == (int)KIND_JUMP && CLASS_TRAP == (int)KIND_TRAP && OPCODE_CLASSES == (int)ISA_KINDS,
+              "opcode classes follow the kinds of Isa.hpp");
+
+OpcodeClass opcode_class(const Instruction& instruction) {
+    return (OpcodeClass)instruction.entry().kind;
+}
+
+const char* opcode_class_name(OpcodeClass c) {
+    static const char* names[OPCODE_CLASSES] = {"alu", "shift", "multdiv", "load", "store", "branch", "jump", "trap"};
+    return names[c];
+}
+
+LatencyHistogram::LatencyHistogram() : counts((64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS, 0) {
+    clear();
+}
+
+void LatencyHistogram::clear() {
+    fill(counts.begin(), counts.end(), 0);
+    total = 0;
+    sum = 0;
+    minimum = ~0ULL;
+    maximum = 0;
+}
+
+size_t LatencyHistogram::index_of(DWORD value) {
+    if(value < 2 * SUB_BUCKETS) return value;
+    int magnitude = 63 - __builtin_clzll(value);
+    int shift = magnitude - SUB_BUCKET_BITS;
+    return (shift + 1) * SUB_BUCKETS + ((value >> shift) - SUB_BUCKETS);
+}
+
+DWORD LatencyHistogram::bucket_low(size_t index) {
+    if(index < 2 * SUB_BUCKETS) return index;
+    int shift = index / SUB_BUCKETS - 1;
+    return (DWORD)(index % SUB_BUCKETS + SUB_BUCKETS) << shift;
+}
+
+DWORD LatencyHistogram::bucket_high(size_t index) {
+    if(index < 2 * SUB_BUCKETS) return index;
+    int shift = index / SUB_BUCKETS - 1;
+    return bucket_low(index) + (1ULL << shift) - 1;
+}
+
+void LatencyHistogram::record(DWORD value) {
+    counts[index_of(value)]++;
+    total++;
+    sum += value;
+    minimum = std::min(minimum, value);
+    maximum = std::max(maximum, value);
+}
+
+DWORD LatencyHistogram::percentile(double p) const {
+    if(total == 0) return 0;
+    DWORD rank = std::max<DWORD>(1, (DWORD)ceil(p / 100 * total));
+    DWORD seen = 0;
+    for(size_t i = 0; i < counts.size(); i++) {
+        seen += counts[i];
+        if(seen >= rank) return std::min(bucket_high(i), maximum);
+    }
+    return maximum;
+}
+
+void LatencyHistogram::write_json(FILE* out) const {
+    fprintf(out, "{\"count\": %llu, \"min\": %llu, \"mean\": %.2f, \"p50\": %llu, \"p90\": %llu, \"p99\": %llu, "
+                 "\"p999\": %llu, \"max\": %llu, \"buckets\": [",
+            total, min(), mean(), percentile(50), percentile(90), percentile(99), percentile(99.9), max());
+    bool first = true;
+    for(size_t i = 0; i < counts.size(); i++) {
+        if(counts[i] == 0) continue;
+        fprintf(out, "%s[%llu, %llu]", first ? "" : ", ", bucket_low(i), counts[i]);
+        first = false;
+    }
+    fprintf(out, "]}");
+}
+
+LatencyProfiler::LatencyProfiler(DWORD sample_every) : sample_every(sample_every ? sample_every : 1) {
+    // The cheapest of many back-to-back reads is what timing an empty region costs
+    overhead = ~0ULL;
+    for(int i = 0; i < 1000; i++) {
+        DWORD start = ticks();
+        overhead = std::min(overhead, ticks() - start);
+    }
+    clear();
+}
+
+void LatencyProfiler::clear() {
+    for(LatencyHistogram& h : histograms) h.clear();
+    countdown = sample_every;
+    sampling = false;
+}
+
+void LatencyProfiler::before(const Instruction& instruction, ADDRESS /*pc*/, const CPUState& /*cpu*/) {
+    if(--countdown != 0) return;
+
+    countdown = sample_every;
+    sampling = true;
+    sampled = opcode_class(instruction);
+    start = ticks();
+}
+
+void LatencyProfiler::after(const Instruction& /*instruction*/, ADDRESS /*pc*/, const CPUState& /*cpu*/, int /*status*/) {
+    if(!sampling) return;
+
+    DWORD elapsed = ticks() - start;
+    sampling = false;
+    histograms[sampled].record(elapsed > overhead ? elapsed - overhead : 0);
+}
+
+void LatencyProfiler::write_json(FILE* out) const {
+    fprintf(out, "{\n  \"unit\": \"%s\",\n  \"sample_every\": %llu,\n  \"timer_overhead\": %llu,\n  \"classes\": {\n",
+            TICK_UNIT, sample_every, overhead);
+    bool first = true;
+    for(int c = 0; c < OPCODE_CLASSES; c++) {
+        if(histograms[c].count() == 0) continue;
+        fprintf(out, "%s    \"%s\": ", first ? "" : ",\n", opcode_class_name((OpcodeClass)c));
+        histograms[c].write_json(out);
+        first = false;
+    }
+    fprintf(out, "\n  }\n}\n");
+}
@@ -0,0 +1,90 @@
+#ifndef LATENCY_HPP
+#define LATENCY_HPP
+
+#include <cstdio>
+#include <vector>
+
+#include "Emulator.hpp"
+#include "Instruction.hpp"
+#include "Observer.hpp"
+
+enum OpcodeClass {
+    CLASS_ALU,
+    CLASS_SHIFT,
+    CLASS_MULTDIV,
+    CLASS_LOAD,
+    CLASS_STORE,
+    CLASS_BRANCH,
+    CLASS_JUMP,
+    CLASS_TRAP, // break, syscall, and anything step() does not implement
+    OPCODE_CLASSES
+};
+
+OpcodeClass opcode_class(const Instruction& instruction);
+const char* opcode_class_name(OpcodeClass c);
+
+// Log-linear histogram in the style of HdrHistogram: values below 64 get a bucket each, and every
+// power of two above that is split into 32 buckets, so any value is recorded within about 3%.
+class LatencyHistogram {
+    static const int SUB_BUCKET_BITS = 5;
+    static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+
+    std::vector<DWORD> counts;
+    DWORD total;
+    DWORD sum;
+    DWORD minimum;
+    DWORD maximum;
+
+    static size_t index_of(DWORD value);
+
+    public:
+    LatencyHistogram();
+
+    void record(DWORD value);
+    void clear();
+
+    DWORD count() const { return total; }
+    DWORD min() const { return total ? minimum : 0; }
+    DWORD max() const { return maximum; }
+    double mean() const { return total ? (double)sum / total : 0; }
+    // Highest value equivalent to the one at percentile p (0-100)
+    DWORD percentile(double p) const;
+
+    // Lowest and highest value recorded into a bucket
+    static DWORD bucket_low(size_t index);
+    static DWORD bucket_high(size_t index);
+
+    // {"count": .., "min": .., ..., "buckets": [[low, count], ...]}, non-empty buckets only
+    void write_json(FILE* out) const;
+};
+
+// Times step() with the TSC (or a nanosecond clock off x86) for every Nth instruction and records
+// the ticks in a histogram per opcode class. Runs as an observer of BasicEmulator::run(): the clock
+// is read at the end of before() and the start of after(), so samples also include returning
+// from one and calling the other. The timer overhead, calibrated at construction, is subtracted
+// from each sample.
+class LatencyProfiler final : public ExecutionObserver {
+    LatencyHistogram histograms[OPCODE_CLASSES];
+    DWORD sample_every;
+    DWORD countdown;
+    DWORD overhead;
+
+    // The instruction being timed, between before() and after()
+    bool sampling;
+    OpcodeClass sampled;
+    DWORD start;
+
+    public:
+    LatencyProfiler(DWORD sample_every);
+
+    void before(const Instruction& instruction, ADDRESS pc, const CPUState& cpu);
+    void after(const Instruction& instruction, ADDRESS pc, const CPUState& cpu, int status);
+
+    const LatencyHistogram& histogram(OpcodeClass c) const { return histograms[c]; }
+    DWORD timer_overhead() const { return overhead; }
+    void clear();
+
+    void write_json(FILE* out) const;
+};
+
+#endif
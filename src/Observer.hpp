@@ -0,0 +1,63 @@
+#ifndef OBSERVER_HPP
+#define OBSERVER_HPP
+
+#include <initializer_list>
+#include <vector>
+
+#include "Emulator.hpp"
+#include "Instruction.hpp"
+
+// Watches the instructions BasicEmulator::run() executes. before() sees each one decoded, at the
+// PC it was fetched from, with the state it will run on; after() sees what step() returned and
+// the state it left behind, so cpu.PC is where execution continues. after() is called for the
+// instruction that stops the run too. A fetch outside of memory is not shown to observers: step()
+// returns STEP_FAULT for it without executing anything.
+class ExecutionObserver {
+    public:
+    virtual ~ExecutionObserver() {}
+    virtual void before(const Instruction& /*instruction*/, ADDRESS /*pc*/, const CPUState& /*cpu*/) {}
+    virtual void after(const Instruction& /*instruction*/, ADDRESS /*pc*/, const CPUState& /*cpu*/, int /*status*/) {}
+};
+
+template<typename Policy>
+template<typename Observer>
+int BasicEmulator<Policy>::run(DWORD budget, DWORD& executed, Observer& observer) {
+    for(DWORD i = 0; i < budget; i++) {
+        ADDRESS pc = cpu.PC;
+        // Faults without fetching
+        if(Policy::bounds_checks && (size_t)pc + 4 > memory_size) {
+            executed += i + 1;
+            return step();
+        }
+
+        Instruction instruction(load_word(pc));
+        observer.before(instruction, pc, cpu);
+        int status = step();
+        observer.after(instruction, pc, cpu, status);
+        if(status != STEP_OK) {
+            executed += i + 1;
+            return status;
+        }
+    }
+    executed += budget;
+    return STEP_OK;
+}
+
+// Several observers on the same run, called in the order given
+class ObserverList : public ExecutionObserver {
+    std::vector<ExecutionObserver*> observers;
+
+    public:
+    ObserverList(std::initializer_list<ExecutionObserver*> observers) : observers(observers) {}
+
+    void add(ExecutionObserver* observer) { observers.push_back(observer); }
+
+    void before(const Instruction& instruction, ADDRESS pc, const CPUState& cpu) {
+        for(ExecutionObserver* o : observers) o->before(instruction, pc, cpu);
+    }
+    void after(const Instruction& instruction, ADDRESS pc, const CPUState& cpu, int status) {
+        for(ExecutionObserver* o : observers) o->after(instruction, pc, cpu, status);
+    }
+};
+
+#endif
@@ -0,0 +1,179 @@
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "Observer.hpp"
+#include "PerfCounters.hpp"
+
+using namespace std;
+
+const char* perf_event_name(PerfEvent event) {
+    static const char* names[PERF_EVENTS] = {"cycles", "instructions", "branch-misses", "L1-dcache-misses",
+                                             "L1-icache-misses"};
+    return names[event];
+}
+
+#ifdef __linux__
+
+static const DWORD CACHE_MISS = PERF_COUNT_HW_CACHE_OP_READ << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16;
+
+static int open_event(PerfEvent event) {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    switch(event) {
+        case PERF_CYCLES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case PERF_INSTRUCTIONS:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case PERF_BRANCH_MISSES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        case PERF_L1D_MISSES:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_L1D | CACHE_MISS;
+            break;
+        case PERF_L1I_MISSES:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_L1I | CACHE_MISS;
+            break;
+        default:
+            return -1;
+    }
+
+    return syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+PerfCounters::PerfCounters() {
+    for(int e = 0; e < PERF_EVENTS; e++) {
+        fds[e] = open_event((PerfEvent)e);
+        if(fds[e] < 0 && reason.empty())
+            reason = string("perf_event_open: ") + strerror(errno);
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    for(int e = 0; e < PERF_EVENTS; e++) {
+        if(fds[e] >= 0) close(fds[e]);
+    }
+}
+
+void PerfCounters::start() {
+    for(int e = 0; e < PERF_EVENTS; e++) {
+        if(fds[e] < 0) continue;
+        ioctl(fds[e], PERF_EVENT_IOC_RESET, 0);
+        ioctl(fds[e], PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+PerfSample PerfCounters::stop() {
+    PerfSample sample;
+    memset(&sample, 0, sizeof(sample));
+
+    for(int e = 0; e < PERF_EVENTS; e++) {
+        if(fds[e] >= 0) ioctl(fds[e], PERF_EVENT_IOC_DISABLE, 0);
+    }
+    for(int e = 0; e < PERF_EVENTS; e++) {
+        // value, time enabled, time running
+        DWORD values[3];
+        if(fds[e] < 0 || read(fds[e], values, sizeof(values)) != sizeof(values) || values[2] == 0) continue;
+        sample.available[e] = true;
+        sample.value[e] = values[2] < values[1] ? (DWORD)((double)values[0] * values[1] / values[2]) : values[0];
+    }
+    return sample;
+}
+
+#else
+
+PerfCounters::PerfCounters() : reason("perf_event_open: only available on Linux") {
+    for(int e = 0; e < PERF_EVENTS; e++) fds[e] = -1;
+}
+
+PerfCounters::~PerfCounters() {}
+
+void PerfCounters::start() {}
+
+PerfSample PerfCounters::stop() {
+    PerfSample sample;
+    memset(&sample, 0, sizeof(sample));
+    return sample;
+}
+
+#endif
+
+bool PerfCounters::available() {
+    for(int e = 0; e < PERF_EVENTS; e++) {
+        if(fds[e] >= 0) return true;
+    }
+    return false;
+}
+
+int perf_run(PerfCounters& perf, Emulator& emulator, DWORD budget, DWORD& executed, PerfSample& sample) {
+    int status = STEP_OK;
+    DWORD i;
+
+    auto begin = chrono::steady_clock::now();
+    perf.start();
+    for(i = 0; i < budget; i++) {
+        status = emulator.step();
+        if(status != STEP_OK) {
+            i++;
+            break;
+        }
+    }
+    sample = perf.stop();
+    sample.seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+    executed += i;
+    return status;
+}
+
+struct BranchCounter final : public ExecutionObserver {
+    DWORD branches = 0;
+
+    void before(const Instruction& instruction, ADDRESS, const CPUState&) {
+        branches += instruction.is_conditional_branch() || instruction.is_jump() || instruction.is_indirect();
+    }
+};
+
+DWORD count_guest_branches(Emulator& emulator, DWORD budget) {
+    BranchCounter counter;
+    DWORD executed = 0;
+    emulator.run(budget, executed, counter);
+    return counter.branches;
+}
+
+void print_perf(FILE* out, const PerfSample& sample, DWORD guest_instructions, DWORD guest_branches) {
+    fprintf(out, "Guest instructions: %llu (%llu branches)\n", guest_instructions, guest_branches);
+    fprintf(out, "Time: %.3f ms (%.1f MIPS)\n", sample.seconds * 1000,
+            sample.seconds > 0 ? guest_instructions / sample.seconds / 1e6 : 0);
+
+    for(int e = 0; e < PERF_EVENTS; e++) {
+        if(!sample.available[e]) {
+            fprintf(out, "  %-18s %14s\n", perf_event_name((PerfEvent)e), "n/a");
+            continue;
+        }
+        fprintf(out, "  %-18s %14llu  %8.3f per guest instruction", perf_event_name((PerfEvent)e), sample.value[e],
+                guest_instructions ? (double)sample.value[e] / guest_instructions : 0);
+        if(e == PERF_BRANCH_MISSES && guest_branches > 0)
+            fprintf(out, "  %8.3f per guest branch", (double)sample.value[e] / guest_branches);
+        fprintf(out, "\n");
+    }
+}
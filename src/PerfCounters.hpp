@@ -0,0 +1,51 @@
+#ifndef PERFCOUNTERS_HPP
+#define PERFCOUNTERS_HPP
+
+#include <cstdio>
+#include <string>
+
+#include "Emulator.hpp"
+
+enum PerfEvent { PERF_CYCLES, PERF_INSTRUCTIONS, PERF_BRANCH_MISSES, PERF_L1D_MISSES, PERF_L1I_MISSES, PERF_EVENTS };
+
+struct PerfSample {
+    bool available[PERF_EVENTS];
+    DWORD value[PERF_EVENTS];
+    double seconds;
+};
+
+// Host hardware counters of the calling thread, through Linux perf_event_open. Each event is
+// opened on its own, so one the CPU or the kernel lacks (or that perf_event_paranoid forbids)
+// only marks that value unavailable. Elsewhere every event is unavailable.
+class PerfCounters {
+    int fds[PERF_EVENTS];
+    std::string reason;
+
+    public:
+    PerfCounters();
+    ~PerfCounters();
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // Whether any event could be opened, and why not otherwise
+    bool available();
+    const std::string& error() { return reason; }
+
+    void start();
+    // Values since start(), scaled up if the kernel had to multiplex the counters
+    PerfSample stop();
+};
+
+const char* perf_event_name(PerfEvent event);
+
+// Steps like run_workload() with the counters around the loop, and nothing else inside it
+int perf_run(PerfCounters& perf, Emulator& emulator, DWORD budget, DWORD& executed, PerfSample& sample);
+
+// Branches and jumps a run executes, counted in a separate decoding pass so that perf_run()
+// measures the plain step() loop
+DWORD count_guest_branches(Emulator& emulator, DWORD budget);
+
+// Host events per guest instruction, and host branch misses per guest branch
+void print_perf(FILE* out, const PerfSample& sample, DWORD guest_instructions, DWORD guest_branches);
+
+#endif
@@ -0,0 +1,151 @@
+#include "Pipeline.hpp"
+
+using namespace std;
+
+// The first instruction is fetched in cycle 0 and decoded in cycle 1
+static const DWORD FIRST_EX = 2;
+
+const char* stall_name(StallKind kind) {
+    static const char* names[STALL_KINDS] = {"load-use", "data", "hi/lo", "branch", "jump"};
+    return names[kind];
+}
+
+PipelineModel::PipelineModel(const PipelineConfig& config, DirectionPredictor* predictor)
+    : config(config), predictor(predictor) {
+    clear();
+}
+
+void PipelineModel::clear() {
+    for(int r = 0; r < 32; r++) {
+        ready[r] = 0;
+        from_load[r] = false;
+    }
+    hilo_ready = 0;
+    next_ex = FIRST_EX;
+    last_ex = 0;
+    executed_instructions = 0;
+    for(int k = 0; k < STALL_KINDS; k++) stalls[k] = 0;
+}
+
+DWORD PipelineModel::cycles() {
+    // The last instruction still goes through MEM and WB
+    return executed_instructions ? last_ex + 3 : 0;
+}
+
+// Delays EX (cycle t) until reg is available `offset` cycles after it, e.g. store data in MEM
+void PipelineModel::wait_for(DWORD& t, int reg, int offset) {
+    if(reg == 0 || ready[reg] <= t + offset) return;
+    DWORD needed = ready[reg] - offset;
+    stalls[from_load[reg] && config.forwarding ? STALL_LOAD_USE : STALL_DATA] += needed - t;
+    t = needed;
+}
+
+void PipelineModel::model(const Instruction& instruction, ADDRESS pc, ADDRESS next_pc) {
+    int opcode = instruction.opcode;
+    int func = instruction.func;
+    int rs = instruction.rs;
+    int rt = instruction.rt;
+
+    DWORD t = next_ex;
+    int destination = 0;
+    bool load = false;
+    bool uses_hilo = false;
+    int hilo_latency = 0;
+    int penalty = 0;
+    StallKind control = STALL_JUMP;
+
+    if(opcode == OP_SPECIAL) {
+        switch(func) {
+            case FUNC_SLL: case FUNC_SRL: case FUNC_SRA:
+                wait_for(t, rt, 0);
+                destination = instruction.rd;
+                break;
+            case FUNC_JR: case FUNC_JALR:
+                wait_for(t, rs, 0);
+                destination = func == FUNC_JALR ? 31 : 0;
+                penalty = config.indirect_penalty;
+                break;
+            case FUNC_SYSCALL: case FUNC_BREAK:
+                break;
+            case FUNC_MFHI: case FUNC_MFLO:
+                uses_hilo = true;
+                destination = instruction.rd;
+                break;
+            case FUNC_MTHI: case FUNC_MTLO:
+                wait_for(t, rs, 0);
+                uses_hilo = true;
+                hilo_latency = 1;
+                break;
+            case FUNC_MULT: case FUNC_MULTU:
+            case FUNC_DIV: case FUNC_DIVU:
+                wait_for(t, rs, 0);
+                wait_for(t, rt, 0);
+                uses_hilo = true;
+                hilo_latency = func <= FUNC_MULTU ? config.mult_latency : config.div_latency;
+                break;
+            default: // two-operand ALU and variable shifts
+                wait_for(t, rs, 0);
+                wait_for(t, rt, 0);
+                destination = instruction.rd;
+                break;
+        }
+    } else if(instruction.is_jump()) {
+        destination = opcode == OP_JAL ? 31 : 0;
+        penalty = config.jump_penalty;
+    } else if(instruction.is_conditional_branch()) {
+        wait_for(t, rs, 0);
+        if(opcode == OP_BEQ || opcode == OP_BNE) wait_for(t, rt, 0);
+
+        bool taken = next_pc != pc + 4;
+        bool predicted = false;
+        if(predictor != NULL) {
+            predicted = predictor->predict(pc);
+            predictor->update(pc, taken);
+        }
+        penalty = taken != predicted ? config.branch_penalty : 0;
+        control = STALL_BRANCH;
+    } else if(instruction.is_load()) {
+        wait_for(t, rs, 0);
+        // lwl and lwr merge into the old value
+        if(opcode == OP_LWL || opcode == OP_LWR) wait_for(t, rt, 0);
+        destination = rt;
+        load = true;
+    } else if(instruction.is_store()) {
+        wait_for(t, rs, 0);
+        wait_for(t, rt, config.forwarding ? 1 : 0);
+    } else { // immediate ALU ops
+        wait_for(t, rs, 0);
+        destination = rt;
+    }
+
+    if(uses_hilo && hilo_ready > t) {
+        stalls[STALL_HILO] += hilo_ready - t;
+        t = hilo_ready;
+    }
+    if(hilo_latency > 0)
+        hilo_ready = t + hilo_latency;
+
+    if(destination != 0) {
+        // Forwarded from EX/MEM (ALU) or MEM/WB (loads); otherwise written in WB and read in ID
+        ready[destination] = !config.forwarding ? t + 3 : load ? t + 2 : t + 1;
+        from_load[destination] = load;
+    }
+
+    stalls[control] += penalty;
+    next_ex = t + 1 + penalty;
+    last_ex = t;
+    executed_instructions++;
+}
+
+void PipelineModel::report(FILE* out) {
+    DWORD total = cycles();
+    DWORD stalled = 0;
+    for(int k = 0; k < STALL_KINDS; k++) stalled += stalls[k];
+
+    fprintf(out, "Instructions: %llu\nCycles: %llu\nCPI: %.3f\n\n", executed_instructions, total, cpi());
+    fprintf(out, "  %-10s %12llu %7.2f%%\n", "stalls", stalled, total ? 100.0 * stalled / total : 0);
+    for(int k = 0; k < STALL_KINDS; k++) {
+        fprintf(out, "  %-10s %12llu %7.2f%%\n", stall_name((StallKind)k), stalls[k],
+                total ? 100.0 * stalls[k] / total : 0);
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef PIPELINE_HPP
+#define PIPELINE_HPP
+
+#include <cstdio>
+
+#include "BranchPredictor.hpp"
+#include "Emulator.hpp"
+#include "Instruction.hpp"
+#include "Observer.hpp"
+
+struct PipelineConfig {
+    // Results reach EX of the next instruction directly, instead of through the register file
+    bool forwarding = true;
+    // Cycles until HI/LO hold the result; mult/div wait for the previous one to finish
+    int mult_latency = 5;
+    int div_latency = 35;
+    // Bubbles after a taken (or, with a predictor, mispredicted) branch, resolved in EX
+    int branch_penalty = 2;
+    // Bubbles after j/jal, whose target is known in ID
+    int jump_penalty = 1;
+    // Bubbles after jr/jalr, whose target comes out of EX
+    int indirect_penalty = 2;
+};
+
+enum StallKind { STALL_LOAD_USE, STALL_DATA, STALL_HILO, STALL_BRANCH, STALL_JUMP, STALL_KINDS };
+
+const char* stall_name(StallKind kind);
+
+// Cycle estimate for a classic in-order IF/ID/EX/MEM/WB pipeline. Each instruction enters EX one
+// cycle after the previous one unless an operand, HI/LO, or the fetch of its own address is not
+// ready yet; the difference is accounted as stall cycles of that kind. The functional result
+// comes from step() as usual, and the model, observing BasicEmulator::run(), only looks at what
+// was decoded and where PC went.
+class PipelineModel final : public ExecutionObserver {
+    PipelineConfig config;
+    DirectionPredictor* predictor;
+
+    // Cycle from which each register can be read in EX, and whether a load produced it
+    DWORD ready[32];
+    bool from_load[32];
+    DWORD hilo_ready;
+    // Earliest cycle the next instruction can enter EX
+    DWORD next_ex;
+    DWORD last_ex;
+
+    DWORD executed_instructions;
+    DWORD stalls[STALL_KINDS];
+
+    void wait_for(DWORD& t, int reg, int offset);
+    void model(const Instruction& instruction, ADDRESS pc, ADDRESS next_pc);
+
+    public:
+    // Without a predictor, branches are predicted not taken
+    PipelineModel(const PipelineConfig& config = PipelineConfig(), DirectionPredictor* predictor = NULL);
+
+    void after(const Instruction& instruction, ADDRESS pc, const CPUState& cpu, int /*status*/) {
+        model(instruction, pc, cpu.PC);
+    }
+    void clear();
+
+    DWORD instructions() { return executed_instructions; }
+    // Including filling and draining the pipeline
+    DWORD cycles();
+    double cpi() { return executed_instructions ? (double)cycles() / executed_instructions : 0; }
+    DWORD stall_cycles(StallKind kind) { return stalls[kind]; }
+
+    void report(FILE* out);
+};
+
+#endif
@@ -0,0 +1,95 @@
+#include <atomic>
+#include <cstring>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+#include "Pool.hpp"
+
+using namespace std;
+
+static atomic<size_t> heap_allocations(0);
+
+static size_t round_up(size_t size) {
+    return (size + CACHE_LINE - 1) & ~(size_t)(CACHE_LINE - 1);
+}
+
+static BYTE* allocate(size_t size) {
+    heap_allocations.fetch_add(1, memory_order_relaxed);
+    return (BYTE*)::operator new(size, align_val_t(CACHE_LINE));
+}
+
+static void deallocate(BYTE* block) {
+    ::operator delete(block, align_val_t(CACHE_LINE));
+}
+
+struct Arena {
+    unordered_map<size_t, vector<BYTE*>> free_lists;
+    PoolStats stats;
+
+    Arena() : stats() {}
+
+    ~Arena() {
+        for(auto& list : free_lists) {
+            for(BYTE* block : list.second) {
+                deallocate(block);
+            }
+        }
+    }
+};
+
+static thread_local Arena arena;
+
+BYTE* Pool::acquire(size_t size) {
+    size = round_up(size);
+    vector<BYTE*>& list = arena.free_lists[size];
+
+    BYTE* block;
+    if(list.empty()) {
+        block = allocate(size);
+        arena.stats.allocations++;
+    } else {
+        block = list.back();
+        list.pop_back();
+        arena.stats.reuses++;
+        arena.stats.cached--;
+    }
+
+    memset(block, 0, size);
+    return block;
+}
+
+void Pool::release(BYTE* block, size_t size) {
+    arena.free_lists[round_up(size)].push_back(block);
+    arena.stats.releases++;
+    arena.stats.cached++;
+}
+
+void Pool::reserve(size_t size, size_t count) {
+    size = round_up(size);
+    vector<BYTE*>& list = arena.free_lists[size];
+
+    for(size_t i = 0; i < count; i++) {
+        list.push_back(allocate(size));
+        arena.stats.allocations++;
+        arena.stats.cached++;
+    }
+}
+
+void Pool::trim() {
+    for(auto& list : arena.free_lists) {
+        for(BYTE* block : list.second) {
+            deallocate(block);
+        }
+    }
+    arena.free_lists.clear();
+    arena.stats.cached = 0;
+}
+
+PoolStats Pool::stats() {
+    return arena.stats;
+}
+
+size_t Pool::total_allocations() {
+    return heap_allocations.load(memory_order_relaxed);
+}
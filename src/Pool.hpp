@@ -0,0 +1,36 @@
+#ifndef POOL_HPP
+#define POOL_HPP
+
+#include <cstddef>
+
+#include "Emulator.hpp"
+
+#define CACHE_LINE 64
+
+struct PoolStats {
+    size_t allocations; // blocks taken from the heap
+    size_t reuses;      // blocks handed out again from the free lists
+    size_t releases;    // blocks returned to the free lists
+    size_t cached;      // blocks currently sitting in the free lists
+};
+
+// Storage for Emulator instances. Every thread owns an arena of free lists keyed by block size,
+// so constructing and destroying emulators in batch never contends on the global allocator.
+// Blocks are cache-line aligned and always handed out zeroed. A block released on another
+// thread than the one that acquired it simply joins the releasing thread's arena.
+class Pool {
+    public:
+    static BYTE* acquire(size_t size);
+    static void release(BYTE* block, size_t size);
+
+    // Pre-populates the calling thread's arena with count blocks of the given size
+    static void reserve(size_t size, size_t count);
+    // Returns the calling thread's cached blocks to the heap
+    static void trim();
+
+    // Counters for the calling thread, and heap allocations made by all threads
+    static PoolStats stats();
+    static size_t total_allocations();
+};
+
+#endif
@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Profiler.hpp"
+
+using namespace std;
+
+SamplingProfiler::SamplingProfiler(unsigned interval_us)
+    : published_pc(0), active(false), stopping(false), interval_us(interval_us), samples(0) {
+    sampler = thread(&SamplingProfiler::sample_loop, this);
+}
+
+SamplingProfiler::~SamplingProfiler() {
+    stopping.store(true);
+    sampler.join();
+}
+
+void SamplingProfiler::sample_loop() {
+    while(!stopping.load(memory_order_relaxed)) {
+        this_thread::sleep_for(chrono::microseconds(interval_us));
+        if(active.load(memory_order_acquire))
+            add_sample(published_pc.load(memory_order_relaxed));
+    }
+}
+
+int SamplingProfiler::run(Emulator& emulator, DWORD budget, DWORD& executed) {
+    CPUState& cpu = emulator.state();
+    int status = STEP_OK;
+    DWORD i;
+
+    published_pc.store(cpu.PC, memory_order_relaxed);
+    active.store(true, memory_order_release);
+
+    for(i = 0; i < budget; i++) {
+        published_pc.store(cpu.PC, memory_order_relaxed);
+        status = emulator.step();
+        if(status != STEP_OK) {
+            i++;
+            break;
+        }
+    }
+
+    active.store(false, memory_order_release);
+    executed += i;
+    return status;
+}
+
+void SamplingProfiler::add_sample(ADDRESS pc) {
+    lock_guard<mutex> guard(lock);
+    histogram[pc]++;
+    samples++;
+}
+
+DWORD SamplingProfiler::total_samples() {
+    lock_guard<mutex> guard(lock);
+    return samples;
+}
+
+void SamplingProfiler::clear() {
+    lock_guard<mutex> guard(lock);
+    histogram.clear();
+    samples = 0;
+}
+
+static string function_of(const SymbolTable* symbols, ADDRESS pc) {
+    const Symbol* symbol = symbols != NULL ? symbols->lookup(pc) : NULL;
+    if(symbol != NULL) return symbol->name;
+
+    char buffer[16];
+    snprintf(buffer, sizeof(buffer), "0x%08x", pc);
+    return buffer;
+}
+
+template<typename K>
+static vector<pair<DWORD, K>> by_count(const map<K, DWORD>& counts) {
+    vector<pair<DWORD, K>> sorted;
+    for(auto& c : counts) sorted.push_back({c.second, c.first});
+    stable_sort(sorted.begin(), sorted.end(), [](auto& a, auto& b) { return a.first > b.first; });
+    return sorted;
+}
+
+void SamplingProfiler::report(FILE* out, const SymbolTable* symbols, size_t top) {
+    lock_guard<mutex> guard(lock);
+    map<ADDRESS, DWORD> addresses(histogram.begin(), histogram.end());
+    map<string, DWORD> functions;
+    for(auto& h : histogram) {
+        functions[function_of(symbols, h.first)] += h.second;
+    }
+
+    fprintf(out, "Samples: %llu\n\nHotspots by address:\n", samples);
+    auto sorted_addresses = by_count(addresses);
+    for(size_t i = 0; i < sorted_addresses.size() && i < top; i++) {
+        auto& a = sorted_addresses[i];
+        string name = symbols != NULL ? symbols->describe(a.second) : "";
+        fprintf(out, "  %10llu %6.2f%%  0x%08x  %s\n", a.first, 100.0 * a.first / samples, a.second, name.c_str());
+    }
+
+    fprintf(out, "\nHotspots by function:\n");
+    auto sorted_functions = by_count(functions);
+    for(size_t i = 0; i < sorted_functions.size() && i < top; i++) {
+        auto& f = sorted_functions[i];
+        fprintf(out, "  %10llu %6.2f%%  %s\n", f.first, 100.0 * f.first / samples, f.second.c_str());
+    }
+}
+
+void SamplingProfiler::folded(FILE* out, const SymbolTable* symbols) {
+    lock_guard<mutex> guard(lock);
+    map<ADDRESS, DWORD> addresses(histogram.begin(), histogram.end());
+
+    for(auto& a : addresses) {
+        string function = function_of(symbols, a.first);
+        string location = symbols != NULL ? symbols->describe(a.first) : function;
+        fprintf(out, "%s;%s %llu\n", function.c_str(), location.c_str(), a.second);
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "Emulator.hpp"
+#include "Symbols.hpp"
+
+// Sampling profiler. run() publishes the guest PC before every step with a relaxed atomic store
+// (a plain store on x86), and a sampler thread reads it every interval, so the guest pays almost
+// nothing no matter how often it is sampled.
+class SamplingProfiler {
+    std::atomic<ADDRESS> published_pc;
+    std::atomic<bool> active;
+    std::atomic<bool> stopping;
+    std::thread sampler;
+    unsigned interval_us;
+
+    std::mutex lock;
+    std::unordered_map<ADDRESS, DWORD> histogram;
+    DWORD samples;
+
+    void sample_loop();
+
+    public:
+    SamplingProfiler(unsigned interval_us);
+    ~SamplingProfiler();
+
+    // Steps like run_workload(), with the sampler watching
+    int run(Emulator& emulator, DWORD budget, DWORD& executed);
+
+    // Adds one sample by hand, e.g. from a SIGPROF handler of the embedder's own loop
+    void add_sample(ADDRESS pc);
+
+    DWORD total_samples();
+    void clear();
+
+    // Top addresses and functions by samples
+    void report(FILE* out, const SymbolTable* symbols, size_t top);
+    // One "function;function+offset count" line per sampled address, for flamegraph.pl
+    void folded(FILE* out, const SymbolTable* symbols);
+};
+
+#endif
@@ -0,0 +1,291 @@
+#include <cstring>
+
+#include "Replay.hpp"
+#include "Varint.hpp"
+
+using namespace std;
+
+#define EVENT_PCS 1
+#define EVENT_MEMORY 2
+#define EVENT_REGISTER 3
+#define EVENT_KEYFRAME 4
+#define EVENT_END 5
+
+#define REGISTER_PC 32
+#define REGISTER_HI 33
+#define REGISTER_LO 34
+
+static const char MAGIC[8] = {'M', 'I', 'P', 'S', 'R', 'P', 'L', '1'};
+
+static void put(FILE* out, DWORD value) {
+    BYTE buffer[10];
+    fwrite(buffer, 1, put_varint(buffer, value) - buffer, out);
+}
+
+static void set_state(Emulator& emulator, int number, WORD value) {
+    CPUState& cpu = emulator.state();
+    switch(number) {
+        case REGISTER_PC: cpu.PC = value; break;
+        case REGISTER_HI: cpu.HI = value; break;
+        case REGISTER_LO: cpu.LO = value; break;
+        default: emulator.set_register(number, value); break;
+    }
+}
+
+TraceRecorder::TraceRecorder(Emulator& emulator, FILE* out, DWORD interval)
+    : emulator(emulator), out(out), interval(interval), executed(0), pending(0) {
+    fwrite(MAGIC, 1, sizeof(MAGIC), out);
+    put(out, emulator.get_memory_size());
+    keyframe();
+}
+
+int TraceRecorder::step() {
+    ADDRESS pc = emulator.state().PC;
+    int status = emulator.step();
+    executed++;
+    pending++;
+
+    ADDRESS next = emulator.state().PC;
+    if(next != pc + 4) {
+        fputc(EVENT_PCS, out);
+        put(out, pending);
+        put(out, zigzag((int)(next - (pc + 4))));
+        pending = 0;
+    }
+
+    if(interval != 0 && executed % interval == 0)
+        keyframe();
+
+    return status;
+}
+
+// Closes the current run of sequential instructions
+void TraceRecorder::flush() {
+    if(pending == 0) return;
+    fputc(EVENT_PCS, out);
+    put(out, pending);
+    put(out, 0);
+    pending = 0;
+}
+
+void TraceRecorder::keyframe() {
+    flush();
+    keyframes.push_back(executed);
+    keyframes.push_back(ftell(out));
+
+    CPUState& cpu = emulator.state();
+    fputc(EVENT_KEYFRAME, out);
+    put(out, executed);
+    for(int i = 1; i < 32; i++) {
+        put(out, cpu.gpr[i]);
+    }
+    put(out, cpu.PC);
+    put(out, cpu.HI);
+    put(out, cpu.LO);
+
+    // Memory as (zeros, literal length, literal) runs; a literal ends at 4 or more zeros
+    BYTE* memory = emulator.get_memory();
+    size_t size = emulator.get_memory_size();
+    size_t i = 0;
+    while(i < size) {
+        size_t zeros = i;
+        while(zeros < size && memory[zeros] == 0) zeros++;
+
+        size_t end = zeros;
+        int run = 0;
+        while(end < size && run < 4) {
+            run = memory[end] == 0 ? run + 1 : 0;
+            end++;
+        }
+        if(run == 4) end -= 4;
+
+        put(out, zeros - i);
+        put(out, end - zeros);
+        fwrite(memory + zeros, 1, end - zeros, out);
+        i = end;
+    }
+}
+
+void TraceRecorder::write_memory(ADDRESS addr, const BYTE* data, size_t length) {
+    flush();
+    fputc(EVENT_MEMORY, out);
+    put(out, addr);
+    put(out, length);
+    fwrite(data, 1, length, out);
+
+    for(size_t i = 0; i < length; i++) {
+        emulator.store_byte(data[i], addr + i);
+    }
+}
+
+void TraceRecorder::set_register(int number, WORD value) {
+    flush();
+    fputc(EVENT_REGISTER, out);
+    put(out, number);
+    put(out, value);
+    set_state(emulator, number, value);
+}
+
+void TraceRecorder::finish() {
+    flush();
+    DWORD offset = ftell(out);
+
+    fputc(EVENT_END, out);
+    put(out, executed);
+    put(out, keyframes.size() / 2);
+    for(DWORD value : keyframes) {
+        put(out, value);
+    }
+
+    for(int i = 0; i < 8; i++) {
+        fputc((offset >> (8 * i)) & 0xff, out);
+    }
+    fflush(out);
+}
+
+TraceReplayer::TraceReplayer(FILE* in)
+    : in(in), replayed(NULL), executed(0), total(0), run_left(0), run_delta(0), mismatch(false) {
+    char magic[sizeof(MAGIC)];
+    DWORD memory_size, count, value;
+
+    if(fread(magic, 1, sizeof(magic), in) != sizeof(magic) || memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)
+        return;
+    if(!get_varint(in, memory_size))
+        return;
+    long start = ftell(in);
+
+    // Trailer points at the END event holding the keyframe index
+    DWORD offset = 0;
+    if(fseek(in, -8, SEEK_END) != 0)
+        return;
+    for(int i = 0; i < 8; i++) {
+        int c = fgetc(in);
+        if(c == EOF) return;
+        offset |= (DWORD)c << (8 * i);
+    }
+
+    fseek(in, offset, SEEK_SET);
+    if(fgetc(in) != EVENT_END || !get_varint(in, total) || !get_varint(in, count))
+        return;
+    for(DWORD i = 0; i < count * 2; i++) {
+        if(!get_varint(in, value)) return;
+        keyframes.push_back(value);
+    }
+
+    fseek(in, start, SEEK_SET);
+    replayed = new Emulator(memory_size);
+    fgetc(in);
+    load_keyframe();
+}
+
+TraceReplayer::~TraceReplayer() {
+    delete replayed;
+}
+
+// Reads a keyframe body into the emulator; with verify, only compares against it
+static bool read_keyframe(FILE* in, Emulator& emulator, DWORD& executed, bool verify) {
+    CPUState& cpu = emulator.state();
+    BYTE* memory = emulator.get_memory();
+    size_t size = emulator.get_memory_size();
+    bool same = true;
+    DWORD value;
+
+    get_varint(in, executed);
+    for(int i = 1; i < 35; i++) {
+        get_varint(in, value);
+        REGISTER current = i < 32 ? cpu.gpr[i] : i == REGISTER_PC ? cpu.PC : i == REGISTER_HI ? cpu.HI : cpu.LO;
+        if(verify) same = same && current == value;
+        else set_state(emulator, i, value);
+    }
+
+    size_t i = 0;
+    while(i < size) {
+        DWORD zeros, literal;
+        if(!get_varint(in, zeros) || !get_varint(in, literal)) return false;
+        for(DWORD j = 0; j < zeros + literal && i < size; j++, i++) {
+            BYTE byte = j < zeros ? 0 : fgetc(in);
+            if(verify) same = same && memory[i] == byte;
+            else memory[i] = byte;
+        }
+    }
+
+    return same;
+}
+
+void TraceReplayer::load_keyframe() {
+    read_keyframe(in, *replayed, executed, false);
+    run_left = 0;
+}
+
+// Applies events up to the next run of instructions; false at the end of the trace
+bool TraceReplayer::next_event() {
+    DWORD a, b;
+
+    switch(fgetc(in)) {
+        case EVENT_PCS:
+            get_varint(in, a);
+            get_varint(in, b);
+            run_left = a;
+            run_delta = unzigzag(b);
+            return true;
+        case EVENT_MEMORY:
+            get_varint(in, a);
+            get_varint(in, b);
+            for(DWORD i = 0; i < b; i++) {
+                replayed->store_byte(fgetc(in), a + i);
+            }
+            return true;
+        case EVENT_REGISTER:
+            get_varint(in, a);
+            get_varint(in, b);
+            set_state(*replayed, a, b);
+            return true;
+        case EVENT_KEYFRAME:
+            {
+                DWORD at;
+                if(!read_keyframe(in, *replayed, at, true) || at != executed)
+                    mismatch = true;
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool TraceReplayer::seek(DWORD instruction) {
+    if(replayed == NULL || instruction > total)
+        return false;
+
+    // Last keyframe at or before the target
+    size_t k = 0;
+    while(k + 2 < keyframes.size() && keyframes[k + 2] <= instruction) k += 2;
+
+    fseek(in, keyframes[k + 1], SEEK_SET);
+    fgetc(in);
+    load_keyframe();
+
+    while(executed < instruction && !mismatch) {
+        step();
+    }
+    return !mismatch;
+}
+
+int TraceReplayer::step() {
+    while(run_left == 0) {
+        if(!next_event()) {
+            mismatch = true;
+            return STEP_OK;
+        }
+    }
+
+    ADDRESS pc = replayed->state().PC;
+    int status = replayed->step();
+    executed++;
+    run_left--;
+
+    ADDRESS expected = pc + 4 + (run_left == 0 ? run_delta : 0);
+    if(replayed->state().PC != expected)
+        mismatch = true;
+
+    return status;
+}
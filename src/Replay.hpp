@@ -0,0 +1,86 @@
+#ifndef REPLAY_HPP
+#define REPLAY_HPP
+
+#include <cstdio>
+#include <vector>
+
+#include "Emulator.hpp"
+
+// Replayable execution trace.
+//
+// The file starts with the magic "MIPSRPL1" and the guest memory size as a varint, then a stream
+// of events, each a tag byte followed by varints:
+//   EVENT_PCS       count, zigzag delta: count instructions ran; each went on to PC + 4 except the
+//                   last, which went on to PC + 4 + delta
+//   EVENT_MEMORY    address, length, raw bytes: host wrote guest memory
+//   EVENT_REGISTER  number (32 = PC, 33 = HI, 34 = LO), value: host set a register
+//   EVENT_KEYFRAME  instruction count, $1-$31, PC, HI, LO, then memory as runs of
+//                   (zero bytes, literal length, literal bytes)
+//   EVENT_END       instruction count, keyframe count, (instruction count, file offset) pairs
+// and finally the 8-byte little-endian offset of EVENT_END.
+//
+// Everything step() computes is deterministic, so only the host's inputs have to be stored; the
+// PC stream is kept to detect divergence on replay.
+
+class TraceRecorder {
+    Emulator& emulator;
+    FILE* out;
+    DWORD interval;
+    DWORD executed;
+    DWORD pending;
+    std::vector<DWORD> keyframes; // instruction count, offset pairs
+
+    void flush();
+    void keyframe();
+
+    public:
+    // Writes a keyframe of the current state, then one every interval instructions
+    TraceRecorder(Emulator& emulator, FILE* out, DWORD interval);
+
+    int step();
+
+    // Host inputs have to go through the recorder to be replayed
+    void write_memory(ADDRESS addr, const BYTE* data, size_t length);
+    void set_register(int number, WORD value);
+
+    // Writes the keyframe index; the recorder must not be used afterwards
+    void finish();
+
+    DWORD instructions() { return executed; }
+};
+
+class TraceReplayer {
+    FILE* in;
+    Emulator* replayed;
+    DWORD executed;
+    DWORD total;
+    DWORD run_left;
+    long long run_delta;
+    bool mismatch;
+    std::vector<DWORD> keyframes;
+
+    bool next_event();
+    void load_keyframe();
+
+    public:
+    TraceReplayer(FILE* in);
+    ~TraceReplayer();
+
+    // False if the file is not a finished trace
+    bool valid() { return replayed != NULL; }
+
+    Emulator& emulator() { return *replayed; }
+
+    // Restores the nearest keyframe at or before instruction, then replays up to it
+    bool seek(DWORD instruction);
+    // Replays one instruction, applying the host inputs recorded before it
+    int step();
+
+    DWORD position() { return executed; }
+    DWORD length() { return total; }
+    bool done() { return executed >= total; }
+    // True once the replayed PC stream differed from the recorded one
+    bool diverged() { return mismatch; }
+};
+
+#endif
@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <cstring>
+
+#include "StateHash.hpp"
+
+using namespace std;
+
+#define HASH_PRIME 0x100000001b3ULL
+#define HASH_BASIS 0xcbf29ce484222325ULL
+
+// splitmix64 finaliser, so that summing page hashes does not cancel structure out
+static DWORD mix(DWORD x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+// FNV-1a over 8-byte chunks, then the trailing bytes
+static DWORD hash_bytes(DWORD hash, const BYTE* data, size_t size) {
+    size_t i = 0;
+    for(; i + 8 <= size; i += 8) {
+        DWORD chunk;
+        memcpy(&chunk, data + i, 8);
+        hash = (hash ^ chunk) * HASH_PRIME;
+    }
+    for(; i < size; i++) hash = (hash ^ data[i]) * HASH_PRIME;
+    return hash;
+}
+
+static DWORD register_hash(const CPUState& cpu) {
+    DWORD hash = hash_bytes(HASH_BASIS, (const BYTE*)cpu.gpr, DISCARD_SLOT * sizeof(REGISTER));
+    REGISTER special[3] = {cpu.PC, cpu.HI, cpu.LO};
+    return hash_bytes(hash, (const BYTE*)special, sizeof(special));
+}
+
+StateHasher::StateHasher(const BYTE* memory, size_t size)
+    : memory(memory), size(size), tracked(false), dirty((size + EMU_PAGE_SIZE - 1) / EMU_PAGE_SIZE, 1),
+      pages(dirty.size(), 0), memory_sum(0), rehashed(0) {}
+
+StateHasher::StateHasher(Emulator& emulator) : StateHasher(emulator.get_memory(), emulator.get_memory_size()) {
+    emulator.track_dirty(dirty.data());
+    tracked = true;
+}
+
+void StateHasher::rehash(size_t page) {
+    size_t start = page * EMU_PAGE_SIZE;
+    // Seeded with the page number, so that swapping two pages changes the digest
+    DWORD hash = mix(hash_bytes(HASH_BASIS ^ page, memory + start, min((size_t)EMU_PAGE_SIZE, size - start)));
+    memory_sum += hash - pages[page];
+    pages[page] = hash;
+    dirty[page] = 0;
+    rehashed++;
+}
+
+void StateHasher::touch(ADDRESS address, size_t length) {
+    if(length == 0 || address >= size) return;
+    size_t last = min((size_t)address + length - 1, size - 1);
+    for(size_t page = address >> EMU_PAGE_BITS; page <= last >> EMU_PAGE_BITS; page++) dirty[page] = 1;
+}
+
+void StateHasher::touch_all() {
+    fill(dirty.begin(), dirty.end(), 1);
+}
+
+DWORD StateHasher::memory_digest() {
+    for(size_t page = 0; page < dirty.size(); page++) {
+        if(dirty[page] || !tracked) rehash(page);
+    }
+    return memory_sum;
+}
+
+DWORD StateHasher::digest(const CPUState& cpu) {
+    return mix(register_hash(cpu) ^ mix(memory_digest() + size));
+}
+
+DWORD state_hash(const CPUState& cpu, const BYTE* memory, size_t memory_size) {
+    return StateHasher(memory, memory_size).digest(cpu);
+}
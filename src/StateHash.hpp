@@ -0,0 +1,52 @@
+#ifndef STATEHASH_HPP
+#define STATEHASH_HPP
+
+#include <vector>
+
+#include "Emulator.hpp"
+
+// Digest of the architectural state ($1-$31, PC, HI, LO and memory) that is cheap to keep up to
+// date. Memory is hashed a page at a time and the page hashes are summed, so a digest only
+// rehashes the pages stored to since the last one; the registers are hashed in full every time.
+//
+// Equal states give equal digests whatever produced them, so digests from different emulators,
+// engines or checkpoints can be compared directly.
+class StateHasher {
+    const BYTE* memory;
+    size_t size;
+    bool tracked;
+    std::vector<BYTE> dirty;
+    std::vector<DWORD> pages;
+    DWORD memory_sum;
+    DWORD rehashed;
+
+    void rehash(size_t page);
+
+    public:
+    // Untracked until set_tracked()
+    StateHasher(const BYTE* memory, size_t size);
+    // Tracks the stores of an emulator through Emulator::track_dirty(), replacing any other tracker;
+    // the emulator must stop tracking or go away first
+    StateHasher(Emulator& emulator);
+    StateHasher(const StateHasher&) = delete;
+    StateHasher& operator=(const StateHasher&) = delete;
+
+    // For whoever flags stores to the memory: one byte per page, as Emulator::track_dirty() takes
+    BYTE* dirty_pages() { return dirty.data(); }
+    // Whether something flags dirty_pages(); without it every digest rehashes all of memory
+    void set_tracked(bool tracked) { this->tracked = tracked; }
+    // Stores that went around the tracker, e.g. through Emulator::get_memory()
+    void touch(ADDRESS address, size_t length);
+    void touch_all();
+
+    DWORD digest(const CPUState& cpu);
+    DWORD memory_digest();
+
+    // Pages hashed so far, the first full pass included
+    DWORD pages_rehashed() { return rehashed; }
+};
+
+// One-off digest, equal to StateHasher::digest() over the same state
+DWORD state_hash(const CPUState& cpu, const BYTE* memory, size_t memory_size);
+
+#endif
@@ -0,0 +1,46 @@
+#include <algorithm>
+
+#include "Symbols.hpp"
+
+using namespace std;
+
+void SymbolTable::add(ADDRESS address, const string& name) {
+    if(!symbols.empty() && address < symbols.back().address) sorted = false;
+    symbols.push_back({address, name});
+}
+
+const Symbol* SymbolTable::lookup(ADDRESS address) const {
+    if(!sorted) {
+        stable_sort(symbols.begin(), symbols.end(), [](const Symbol& a, const Symbol& b) {
+            return a.address < b.address;
+        });
+        sorted = true;
+    }
+
+    auto it = upper_bound(symbols.begin(), symbols.end(), address, [](ADDRESS a, const Symbol& s) {
+        return a < s.address;
+    });
+    if(it == symbols.begin()) return NULL;
+    return &*(it - 1);
+}
+
+long long SymbolTable::find(const string& name) const {
+    for(Symbol& symbol : symbols) {
+        if(symbol.name == name) return symbol.address;
+    }
+    return -1;
+}
+
+string SymbolTable::describe(ADDRESS address) const {
+    char buffer[32];
+    const Symbol* symbol = lookup(address);
+
+    if(symbol == NULL) {
+        snprintf(buffer, sizeof(buffer), "0x%08x", address);
+        return buffer;
+    }
+    if(symbol->address == address) return symbol->name;
+
+    snprintf(buffer, sizeof(buffer), "+0x%x", address - symbol->address);
+    return symbol->name + buffer;
+}
@@ -0,0 +1,36 @@
+#ifndef SYMBOLS_HPP
+#define SYMBOLS_HPP
+
+#include <string>
+#include <vector>
+
+#include "Emulator.hpp"
+
+struct Symbol {
+    ADDRESS address;
+    std::string name;
+};
+
+// Names for guest addresses; an address belongs to the closest symbol at or below it
+class SymbolTable {
+    // Sorted lazily on the first lookup after an out-of-order add
+    mutable std::vector<Symbol> symbols;
+    mutable bool sorted;
+
+    public:
+    SymbolTable() : sorted(true) {}
+
+    void add(ADDRESS address, const std::string& name);
+    // NULL if the address is below every symbol
+    const Symbol* lookup(ADDRESS address) const;
+    // Address of a symbol by name, or -1 if there is none
+    long long find(const std::string& name) const;
+
+    size_t size() const { return symbols.size(); }
+    bool empty() const { return symbols.empty(); }
+
+    // Writes "name+0xoffset", or the bare address when nothing covers it
+    std::string describe(ADDRESS address) const;
+};
+
+#endif
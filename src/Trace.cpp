@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <chrono>
+
+#include "Trace.hpp"
+#include "Varint.hpp"
+
+using namespace std;
+
+#define TAG_JUMP 0x1
+#define TAG_LOAD 0x2
+#define TAG_STORE 0x4
+#define TAG_STATUS 0x8
+
+// Records drained per batch by the writer thread
+#define BATCH 1024
+
+// Empty polls the writer yields through before it starts sleeping, and the longest sleep
+#define IDLE_SPINS 64
+#define IDLE_SLEEP_MAX_US 1000
+
+TraceRing::TraceRing(size_t capacity) : head(0), cached_tail(0), dropped_records(0), tail(0) {
+    size_t size = 1;
+    while(size < capacity) size <<= 1;
+
+    records = new TraceRecord[size];
+    mask = size - 1;
+}
+
+TraceRing::~TraceRing() {
+    delete[] records;
+}
+
+bool TraceRing::push(const TraceRecord& record) {
+    size_t h = head.load(memory_order_relaxed);
+
+    // Only look at the consumer's index when the cached one says we are full
+    if(h - cached_tail > mask) {
+        cached_tail = tail.load(memory_order_acquire);
+        if(h - cached_tail > mask) {
+            dropped_records.store(dropped_records.load(memory_order_relaxed) + 1, memory_order_relaxed);
+            return false;
+        }
+    }
+
+    records[h & mask] = record;
+    head.store(h + 1, memory_order_release);
+    return true;
+}
+
+size_t TraceRing::pop(TraceRecord* out, size_t max) {
+    size_t t = tail.load(memory_order_relaxed);
+    size_t available = head.load(memory_order_acquire) - t;
+    size_t count = available < max ? available : max;
+
+    for(size_t i = 0; i < count; i++) {
+        out[i] = records[(t + i) & mask];
+    }
+
+    tail.store(t + count, memory_order_release);
+    return count;
+}
+
+TraceWriter::TraceWriter(TraceRing& ring, FILE* out)
+    : ring(ring), out(out), stopping(false), failed(false), records(0), bytes(0) {
+    worker = thread(&TraceWriter::drain, this);
+}
+
+TraceWriter::~TraceWriter() {
+    stop();
+}
+
+void TraceWriter::stop() {
+    if(!worker.joinable()) return;
+    stopping.store(true, memory_order_release);
+    worker.join();
+    if(fflush(out) != 0) failed.store(true, memory_order_relaxed);
+}
+
+void TraceWriter::drain() {
+    TraceRecord batch[BATCH];
+    // Worst case per record: tag + 5 varints of at most 10 bytes
+    BYTE buffer[BATCH * 51];
+    ADDRESS pc = -4;
+    ADDRESS address = 0;
+    int idle = 0; // empty polls in a row
+
+    while(true) {
+        // Check for stop before popping, so that the last batch is always drained
+        bool last = stopping.load(memory_order_acquire);
+        size_t count = ring.pop(batch, BATCH);
+
+        if(count == 0) {
+            if(last) break;
+            // Yield through short gaps, then sleep longer and longer so an idle guest costs no core
+            if(++idle <= IDLE_SPINS) this_thread::yield();
+            else this_thread::sleep_for(chrono::microseconds(min(1 << min(idle - IDLE_SPINS, 10), IDLE_SLEEP_MAX_US)));
+            continue;
+        }
+        idle = 0;
+
+        // After a failed write the file is incomplete; keep emptying the ring so the producer
+        // does not fill it, but write nothing more
+        if(failed.load(memory_order_relaxed)) continue;
+
+        BYTE* p = buffer;
+        for(size_t i = 0; i < count; i++) {
+            TraceRecord& r = batch[i];
+            BYTE tag = 0;
+            if(r.pc != pc + 4) tag |= TAG_JUMP;
+            if(r.flags & TRACE_LOAD) tag |= TAG_LOAD;
+            if(r.flags & TRACE_STORE) tag |= TAG_STORE;
+            if(r.status != 0) tag |= TAG_STATUS;
+
+            *p++ = tag;
+            p = put_varint(p, r.instruction);
+            if(tag & TAG_JUMP) p = put_varint(p, zigzag((int)(r.pc - (pc + 4))));
+            if(tag & (TAG_LOAD | TAG_STORE)) {
+                p = put_varint(p, zigzag((int)(r.address - address)));
+                p = put_varint(p, r.value);
+                address = r.address;
+            }
+            if(tag & TAG_STATUS) p = put_varint(p, r.status);
+            pc = r.pc;
+        }
+
+        if(fwrite(buffer, 1, p - buffer, out) != (size_t)(p - buffer)) {
+            failed.store(true, memory_order_relaxed);
+            continue;
+        }
+        records.store(records.load(memory_order_relaxed) + count, memory_order_relaxed);
+        bytes.store(bytes.load(memory_order_relaxed) + (p - buffer), memory_order_relaxed);
+    }
+}
+
+vector<TraceRecord> read_trace(FILE* in) {
+    vector<TraceRecord> result;
+    ADDRESS pc = -4;
+    ADDRESS address = 0;
+    int tag;
+
+    while((tag = fgetc(in)) != EOF) {
+        TraceRecord r = {};
+        DWORD value;
+
+        if(!get_varint(in, value)) break;
+        r.instruction = value;
+
+        r.pc = pc + 4;
+        if(tag & TAG_JUMP) {
+            if(!get_varint(in, value)) break;
+            r.pc += unzigzag(value);
+        }
+
+        if(tag & (TAG_LOAD | TAG_STORE)) {
+            if(!get_varint(in, value)) break;
+            address += unzigzag(value);
+            r.address = address;
+            if(!get_varint(in, value)) break;
+            r.value = value;
+            r.flags = (tag & TAG_LOAD) ? TRACE_LOAD : TRACE_STORE;
+        }
+
+        if(tag & TAG_STATUS) {
+            if(!get_varint(in, value)) break;
+            r.status = value;
+        }
+
+        pc = r.pc;
+        result.push_back(r);
+    }
+
+    return result;
+}
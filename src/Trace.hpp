@@ -0,0 +1,91 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "Emulator.hpp"
+
+#define TRACE_LOAD 0x1
+#define TRACE_STORE 0x2
+
+// One executed instruction, as written by the emulator thread
+struct TraceRecord {
+    ADDRESS pc;
+    WORD instruction;
+    ADDRESS address; // effective address of a load/store
+    WORD value;      // value loaded into rt, or stored from rt
+    WORD status;     // value returned by step()
+    WORD flags;      // TRACE_LOAD / TRACE_STORE
+};
+
+// Lock-free single-producer single-consumer ring of trace records. The producer never blocks:
+// when the ring is full the record is dropped and counted instead.
+class TraceRing {
+    TraceRecord* records;
+    size_t mask;
+
+    alignas(64) std::atomic<size_t> head; // next slot the producer writes
+    size_t cached_tail;
+    std::atomic<size_t> dropped_records;
+
+    alignas(64) std::atomic<size_t> tail; // next slot the consumer reads
+
+    public:
+    // capacity is rounded up to a power of two
+    TraceRing(size_t capacity);
+    ~TraceRing();
+
+    TraceRing(const TraceRing&) = delete;
+    TraceRing& operator=(const TraceRing&) = delete;
+
+    // Producer side
+    bool push(const TraceRecord& record);
+    // Consumer side: copies up to max records out, returns how many
+    size_t pop(TraceRecord* out, size_t max);
+
+    size_t dropped() { return dropped_records.load(std::memory_order_relaxed); }
+};
+
+// Drains a ring on its own thread, delta/varint-compressing the records into a file.
+//
+// Each record starts with a tag byte:
+//   bit 0: PC is not the previous PC + 4, a zigzag varint PC delta follows
+//   bit 1: load, bit 2: store (a zigzag varint address delta and a varint value follow)
+//   bit 3: non-zero status, a varint status follows
+// followed by the instruction word as a varint, and the optional fields in the order above.
+//
+// While the ring stays empty the thread backs off from yielding to sleeps of up to a millisecond,
+// so a ring should hold about that long a burst of records without dropping any.
+class TraceWriter {
+    TraceRing& ring;
+    FILE* out;
+    std::thread worker;
+    std::atomic<bool> stopping;
+    std::atomic<bool> failed;
+
+    // Written by the worker only, and read from any thread while it runs
+    std::atomic<size_t> records;
+    std::atomic<size_t> bytes;
+
+    void drain();
+
+    public:
+    TraceWriter(TraceRing& ring, FILE* out);
+    ~TraceWriter();
+
+    // Writes whatever is left in the ring and joins the thread
+    void stop();
+
+    size_t records_written() { return records.load(std::memory_order_relaxed); }
+    size_t bytes_written() { return bytes.load(std::memory_order_relaxed); }
+    // True once a write to the file has failed; records drained after that are discarded
+    bool write_failed() { return failed.load(std::memory_order_relaxed); }
+};
+
+// Decodes a file produced by TraceWriter
+std::vector<TraceRecord> read_trace(FILE* in);
+
+#endif
@@ -1,8 +1,46 @@
+#ifndef UTILITIES_HPP
+#define UTILITIES_HPP
+
 #include "Emulator.hpp"
+#include "Isa.hpp"
 
+// Instruction encoders. Fields are masked to their width, so that negative immediates and
+// offsets can be passed as they are; they can be used in constant expressions.
 class Utilities {
     public:
-    static WORD R_instruction(int opcode, int rd, int rs, int rt, int shamt, int func);
-    static WORD J_instruction(int opcode, int pseudo_addr);
-    static WORD I_instruction(int opcode, int rt, int rs, int imm);
+    // in assembly: OP rd, rs, rt
+    static constexpr WORD R_instruction(int opcode, int rd, int rs, int rt, int shamt, int func) {
+        WORD instruction = 0x0;
+
+        instruction |= (opcode & 0b111111) << 26;
+        instruction |= (rs & 0b11111) << 21;
+        instruction |= (rt & 0b11111) << 16;
+        instruction |= (rd & 0b11111) << 11;
+        instruction |= (shamt & 0b11111) << 6;
+        instruction |= func & 0b111111;
+
+        return instruction;
+    }
+
+    static constexpr WORD J_instruction(int opcode, int pseudo_addr) {
+        WORD instruction = 0x0;
+
+        instruction |= (opcode & 0b111111) << 26;
+        instruction |= pseudo_addr & 0x3FFFFFF;
+
+        return instruction;
+    }
+
+    static constexpr WORD I_instruction(int opcode, int rt, int rs, int imm) {
+        WORD instruction = 0x0;
+
+        instruction |= (opcode & 0b111111) << 26;
+        instruction |= (rs & 0b11111) << 21;
+        instruction |= (rt & 0b11111) << 16;
+        instruction |= imm & 0xffff;
+
+        return instruction;
+    }
 };
+
+#endif
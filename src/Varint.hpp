@@ -0,0 +1,40 @@
+#ifndef VARINT_HPP
+#define VARINT_HPP
+
+#include <cstdio>
+
+#include "Emulator.hpp"
+
+// LEB128 style variable-length integers, 7 bits per byte, low bits first
+
+inline BYTE* put_varint(BYTE* out, DWORD value) {
+    while(value >= 0x80) {
+        *out++ = (value & 0x7f) | 0x80;
+        value >>= 7;
+    }
+    *out++ = value;
+    return out;
+}
+
+// Returns false at end of file
+inline bool get_varint(FILE* in, DWORD& value) {
+    value = 0;
+    for(int shift = 0; shift < 64; shift += 7) {
+        int c = fgetc(in);
+        if(c == EOF) return false;
+        value |= (DWORD)(c & 0x7f) << shift;
+        if((c & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+// Maps signed deltas onto small unsigned values: 0, -1, 1, -2, ... -> 0, 1, 2, 3, ...
+inline DWORD zigzag(long long value) {
+    return ((DWORD)value << 1) ^ (DWORD)(value >> 63);
+}
+
+inline long long unzigzag(DWORD value) {
+    return (long long)(value >> 1) ^ -(long long)(value & 1);
+}
+
+#endif
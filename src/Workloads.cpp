@@ -0,0 +1,376 @@
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include "Workloads.hpp"
+#include "Asm.hpp"
+
+using namespace std;
+
+#define MEMORY_SIZE (64 * 1024)
+#define DATA 0x3000
+#define STACK_TOP 0xfff0
+
+enum {
+    ZERO = 0, V0 = 2, V1 = 3, A0 = 4, A1 = 5, A2 = 6, A3 = 7,
+    T0 = 8, T1 = 9, T2 = 10, T3 = 11, T4 = 12, T5 = 13, T6 = 14, T7 = 15,
+    S0 = 16, S1 = 17, S2 = 18, S3 = 19, T8 = 24, T9 = 25, SP = 29, RA = 31
+};
+
+// Deterministic pseudo-random data
+static WORD lcg(WORD& seed) {
+    seed = seed * 1103515245 + 12345;
+    return seed >> 8;
+}
+
+static Workload make(const char* name, const char* description, Asm& program) {
+    Workload w;
+    w.name = name;
+    w.description = description;
+    w.image = program.assemble();
+    program.each_label([&](string_view label, ADDRESS address) { w.symbols.add(address, string(label)); });
+    w.memory_size = MEMORY_SIZE;
+    w.registers.push_back({SP, STACK_TOP});
+    return w;
+}
+
+static void data_word(Workload& w, ADDRESS addr, WORD value) {
+    if(w.image.size() <= addr / 4) w.image.resize(addr / 4 + 1);
+    w.image[addr / 4] = value;
+}
+
+// Bytes are kept apart from the word image, which would fix their order within each word
+static void data_bytes(Workload& w, ADDRESS addr, const BYTE* bytes, size_t length) {
+    w.data.push_back({addr, vector<BYTE>(bytes, bytes + length)});
+}
+
+static Workload memcpy_workload() {
+    const ADDRESS set = DATA, src = DATA + 0x1000, dst = DATA + 0x2000;
+    const int words = 256;
+
+    Asm p;
+    p.li(T0, set);
+    p.li(T1, set + words * 4);
+    p.li(T2, 0x5a5a5a5a);
+    p.label("memset");
+    p.sw(T2, 0, T0);
+    p.addiu(T0, T0, 4);
+    p.bne(T0, T1, "memset");
+    p.li(T0, src);
+    p.li(T1, dst);
+    p.li(T3, src + words * 4);
+    p.label("memcpy");
+    p.lw(T2, 0, T0);
+    p.sw(T2, 0, T1);
+    p.addiu(T0, T0, 4);
+    p.addiu(T1, T1, 4);
+    p.bne(T0, T3, "memcpy");
+    p.brk(WORKLOAD_DONE);
+
+    Workload w = make("memcpy", "memset then memcpy of 1 KiB, a word at a time", p);
+    WORD seed = 1;
+    for(int i = 0; i < words; i++) {
+        WORD value = lcg(seed);
+        data_word(w, src + i * 4, value);
+        w.expected_memory.push_back({set + i * 4, 0x5a5a5a5a});
+        w.expected_memory.push_back({dst + i * 4, value});
+    }
+    return w;
+}
+
+static Workload crc32_workload() {
+    const int length = 256;
+
+    Asm p;
+    p.li(T0, DATA);
+    p.li(T1, DATA + length);
+    p.li(V0, 0xffffffff);
+    p.li(T4, 0xedb88320);
+    p.label("byte");
+    p.lbu(T2, 0, T0);
+    p.xor_(V0, V0, T2);
+    p.addiu(T3, ZERO, 8);
+    p.label("bit");
+    p.andi(T5, V0, 1);
+    p.srl(V0, V0, 1);
+    p.beq(T5, ZERO, "skip");
+    p.xor_(V0, V0, T4);
+    p.label("skip");
+    p.addiu(T3, T3, -1);
+    p.bgtz(T3, "bit");
+    p.addiu(T0, T0, 1);
+    p.bne(T0, T1, "byte");
+    p.nor(V0, V0, ZERO);
+    p.brk(WORKLOAD_DONE);
+
+    Workload w = make("crc32", "bitwise CRC-32 of 256 bytes with lbu", p);
+    BYTE bytes[length];
+    WORD seed = 2, crc = 0xffffffff;
+    for(int i = 0; i < length; i++) {
+        bytes[i] = lcg(seed);
+        crc ^= bytes[i];
+        for(int b = 0; b < 8; b++) crc = (crc >> 1) ^ ((crc & 1) ? 0xedb88320 : 0);
+    }
+    data_bytes(w, DATA, bytes, length);
+    w.expected.push_back({V0, ~crc});
+    return w;
+}
+
+static Workload sort_workload() {
+    const int count = 64;
+
+    Asm p;
+    p.li(A0, DATA);
+    p.addiu(T0, ZERO, 1);
+    p.addiu(T9, ZERO, count);
+    p.label("outer");
+    p.beq(T0, T9, "done");
+    p.sll(T1, T0, 2);
+    p.addu(T1, A0, T1);
+    p.lw(T2, 0, T1);
+    p.addu(T3, T1, ZERO);
+    p.label("inner");
+    p.beq(T3, A0, "place");
+    p.lw(T4, -4, T3);
+    p.slt(T5, T2, T4);
+    p.beq(T5, ZERO, "place");
+    p.sw(T4, 0, T3);
+    p.addiu(T3, T3, -4);
+    p.j("inner");
+    p.label("place");
+    p.sw(T2, 0, T3);
+    p.addiu(T0, T0, 1);
+    p.j("outer");
+    p.label("done");
+    p.brk(WORKLOAD_DONE);
+
+    Workload w = make("sort", "insertion sort of 64 signed words", p);
+    vector<int> values;
+    WORD seed = 3;
+    for(int i = 0; i < count; i++) {
+        int value = (int)lcg(seed) - (1 << 23);
+        values.push_back(value);
+        data_word(w, DATA + i * 4, value);
+    }
+    sort(values.begin(), values.end());
+    for(int i = 0; i < count; i++) {
+        w.expected_memory.push_back({DATA + i * 4, (WORD)values[i]});
+    }
+    return w;
+}
+
+static Workload matmul_workload() {
+    const int n = 8;
+    const ADDRESS a = DATA, b = DATA + 0x100, c = DATA + 0x200;
+
+    Asm p;
+    p.li(S0, a);
+    p.li(S1, b);
+    p.li(S2, c);
+    p.addiu(S3, ZERO, n);
+    p.addu(T0, ZERO, ZERO);
+    p.label("i");
+    p.addu(T1, ZERO, ZERO);
+    p.label("j");
+    p.addu(T2, ZERO, ZERO);
+    p.addu(T3, ZERO, ZERO);
+    p.label("k");
+    p.sll(T4, T0, 3); // A[i * 8 + k]
+    p.addu(T4, T4, T2);
+    p.sll(T4, T4, 2);
+    p.addu(T4, T4, S0);
+    p.lw(T5, 0, T4);
+    p.sll(T6, T2, 3); // B[k * 8 + j]
+    p.addu(T6, T6, T1);
+    p.sll(T6, T6, 2);
+    p.addu(T6, T6, S1);
+    p.lw(T7, 0, T6);
+    p.mult(T5, T7);
+    p.mflo(T8);
+    p.addu(T3, T3, T8);
+    p.addiu(T2, T2, 1);
+    p.bne(T2, S3, "k");
+    p.sll(T4, T0, 3); // C[i * 8 + j]
+    p.addu(T4, T4, T1);
+    p.sll(T4, T4, 2);
+    p.addu(T4, T4, S2);
+    p.sw(T3, 0, T4);
+    p.addiu(T1, T1, 1);
+    p.bne(T1, S3, "j");
+    p.addiu(T0, T0, 1);
+    p.bne(T0, S3, "i");
+    p.brk(WORKLOAD_DONE);
+
+    Workload w = make("matmul", "8x8 integer matrix multiply with mult/mflo", p);
+    int ma[n][n], mb[n][n];
+    WORD seed = 4;
+    for(int i = 0; i < n; i++) {
+        for(int j = 0; j < n; j++) {
+            ma[i][j] = (int)(lcg(seed) % 2001) - 1000;
+            mb[i][j] = (int)(lcg(seed) % 2001) - 1000;
+            data_word(w, a + (i * n + j) * 4, ma[i][j]);
+            data_word(w, b + (i * n + j) * 4, mb[i][j]);
+        }
+    }
+    for(int i = 0; i < n; i++) {
+        for(int j = 0; j < n; j++) {
+            WORD sum = 0;
+            for(int k = 0; k < n; k++) sum += (WORD)(ma[i][k] * mb[k][j]);
+            w.expected_memory.push_back({c + (i * n + j) * 4, sum});
+        }
+    }
+    return w;
+}
+
+static Workload strsearch_workload() {
+    const int length = 1024;
+    const char* needle = "abca";
+    const int m = strlen(needle);
+    const ADDRESS haystack = DATA, pattern = DATA + 0x800;
+
+    Asm p;
+    p.li(S0, haystack);
+    p.li(S1, haystack + length - m + 1);
+    p.li(S2, pattern);
+    p.addiu(S3, ZERO, m);
+    p.addu(V0, ZERO, ZERO);
+    p.addu(T0, S0, ZERO);
+    p.label("outer");
+    p.beq(T0, S1, "done");
+    p.addu(T1, ZERO, ZERO);
+    p.label("inner");
+    p.addu(T2, T0, T1);
+    p.lbu(T3, 0, T2);
+    p.addu(T4, S2, T1);
+    p.lb(T5, 0, T4);
+    p.bne(T3, T5, "next");
+    p.addiu(T1, T1, 1);
+    p.bne(T1, S3, "inner");
+    p.addiu(V0, V0, 1);
+    p.label("next");
+    p.addiu(T0, T0, 1);
+    p.j("outer");
+    p.label("done");
+    p.brk(WORKLOAD_DONE);
+
+    Workload w = make("strsearch", "counts occurrences of a 4-byte string in 1 KiB with lb/lbu", p);
+    BYTE text[length];
+    WORD seed = 5;
+    for(int i = 0; i < length; i++) text[i] = "abcd"[lcg(seed) % 4];
+    data_bytes(w, haystack, text, length);
+    data_bytes(w, pattern, (const BYTE*)needle, m);
+
+    WORD found = 0;
+    for(int i = 0; i + m <= length; i++) {
+        if(memcmp(text + i, needle, m) == 0) found++;
+    }
+    w.expected.push_back({V0, found});
+    return w;
+}
+
+static Workload fib_workload() {
+    const int n = 18;
+
+    Asm p;
+    p.addiu(A0, ZERO, n);
+    p.jal("fib");
+    p.brk(WORKLOAD_DONE);
+    p.label("fib");
+    p.slti(T0, A0, 2);
+    p.beq(T0, ZERO, "recurse");
+    p.addu(V0, A0, ZERO);
+    p.jr(RA);
+    p.label("recurse");
+    p.addiu(SP, SP, -12);
+    p.sw(RA, 0, SP);
+    p.sw(A0, 4, SP);
+    p.addiu(A0, A0, -1);
+    p.jal("fib");
+    p.sw(V0, 8, SP);
+    p.lw(A0, 4, SP);
+    p.addiu(A0, A0, -2);
+    p.jal("fib");
+    p.lw(T1, 8, SP);
+    p.addu(V0, V0, T1);
+    p.lw(RA, 0, SP);
+    p.addiu(SP, SP, 12);
+    p.jr(RA);
+
+    Workload w = make("fib", "recursive fib(18) through jal/jr with a stack frame per call", p);
+    WORD a = 0, b = 1;
+    for(int i = 0; i < n; i++) {
+        WORD t = a + b;
+        a = b;
+        b = t;
+    }
+    w.expected.push_back({V0, a});
+    w.expected.push_back({SP, STACK_TOP});
+    return w;
+}
+
+static Workload pointer_chase_workload() {
+    const int nodes = 256;
+    const int passes = 4;
+
+    // Nodes of {next, value} visited in a shuffled order
+    vector<int> order;
+    for(int i = 0; i < nodes; i++) order.push_back(i);
+    WORD seed = 6;
+    for(int i = nodes - 1; i > 0; i--) swap(order[i], order[lcg(seed) % (i + 1)]);
+
+    Asm p;
+    p.addiu(S1, ZERO, passes);
+    p.addu(V0, ZERO, ZERO);
+    p.label("pass");
+    p.li(T0, DATA + order[0] * 8);
+    p.label("walk");
+    p.lw(T1, 4, T0);
+    p.addu(V0, V0, T1);
+    p.lw(T0, 0, T0);
+    p.bne(T0, ZERO, "walk");
+    p.addiu(S1, S1, -1);
+    p.bgtz(S1, "pass");
+    p.brk(WORKLOAD_DONE);
+
+    Workload w = make("pointer-chase", "4 walks over a shuffled 256-node linked list", p);
+    WORD sum = 0;
+    for(int i = 0; i < nodes; i++) {
+        ADDRESS node = DATA + order[i] * 8;
+        WORD value = lcg(seed);
+        data_word(w, node, i + 1 < nodes ? DATA + order[i + 1] * 8 : 0);
+        data_word(w, node + 4, value);
+        sum += value;
+    }
+    w.expected.push_back({V0, sum * passes});
+    return w;
+}
+
+const vector<Workload>& workload_corpus() {
+    static vector<Workload> corpus = {
+        memcpy_workload(),
+        crc32_workload(),
+        sort_workload(),
+        matmul_workload(),
+        strsearch_workload(),
+        fib_workload(),
+        pointer_chase_workload(),
+    };
+    return corpus;
+}
+
+const Workload* find_workload(const char* name) {
+    for(const Workload& w : workload_corpus()) {
+        if(strcmp(w.name, name) == 0) return &w;
+    }
+    return NULL;
+}
+
+Emulator* Workload::load() const {
+    Emulator* emulator = new Emulator(memory_size, image.data(), image.size());
+    reset(*emulator);
+    return emulator;
+}
+
+int run_workload(Emulator& emulator, DWORD budget, DWORD& executed) {
+    return emulator.run(budget, executed);
+}
@@ -0,0 +1,57 @@
+#ifndef WORKLOADS_HPP
+#define WORKLOADS_HPP
+
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "Emulator.hpp"
+#include "Symbols.hpp"
+
+// break code every workload stops with
+#define WORKLOAD_DONE ((31 << 5) | 31)
+
+// A guest program image, loaded at address 0, with its expected final state. The expected
+// values are computed on the host by a reference implementation of each kernel.
+struct Workload {
+    const char* name;
+    const char* description;
+    std::vector<WORD> image;                             // instructions and word data, stored word by word
+    std::vector<std::pair<ADDRESS, std::vector<BYTE>>> data; // byte data, copied in byte by byte
+    size_t memory_size;
+    std::vector<std::pair<int, WORD>> registers;         // set before running
+    std::vector<std::pair<int, WORD>> expected;          // register values once done
+    std::vector<std::pair<ADDRESS, WORD>> expected_memory;
+    SymbolTable symbols;                                 // the labels of the program
+
+    Emulator* load() const;
+    // Copies the byte data in and sets the initial registers, on any emulator (Emulator, another
+    // BasicEmulator policy or AnyEmulator) the image has been loaded into. The image goes through
+    // store_word() in the emulator's byte order; the byte data has none, so it is copied as is.
+    template<typename E>
+    void reset(E& emulator) const {
+        for(auto& d : data) memcpy(emulator.get_memory() + d.first, d.second.data(), d.second.size());
+        for(auto& r : registers) emulator.set_register(r.first, r.second);
+    }
+    // True if the emulator holds the expected final state
+    template<typename E>
+    bool check(E& emulator) const {
+        for(auto& r : expected) {
+            if(emulator.get_register(r.first) != r.second) return false;
+        }
+        for(auto& m : expected_memory) {
+            if(emulator.load_word(m.first) != m.second) return false;
+        }
+        return true;
+    }
+};
+
+// memcpy, crc32, sort, matmul, strsearch, fib and pointer-chase kernels
+const std::vector<Workload>& workload_corpus();
+const Workload* find_workload(const char* name);
+
+// Steps until step() returns non-zero or budget instructions ran. Returns the last step() result
+// (STEP_OK when the budget ran out) and adds the instructions executed to executed.
+int run_workload(Emulator& emulator, DWORD budget, DWORD& executed);
+
+#endif
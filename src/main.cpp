@@ -1,11 +1,84 @@
 #include <stdio.h>
+#include <string.h>
 #include <iostream>
 
+#include "Assembler.hpp"
+#include "Disassembler.hpp"
 #include "Emulator.hpp"
+#include "Latency.hpp"
+#include "Workloads.hpp"
 
 using namespace std;
 
+// Writes latency histograms of one workload as JSON, timing every 16th instruction
+static int latency(const char* name) {
+    const Workload* w = find_workload(name);
+    if(w == NULL) {
+        fprintf(stderr, "unknown workload: %s\n", name);
+        return 1;
+    }
+
+    LatencyProfiler profiler(16);
+    Emulator* vm = w->load();
+    DWORD executed = 0;
+    vm->run(100000000, executed, profiler);
+    delete vm;
+
+    profiler.write_json(stdout);
+    return 0;
+}
+
+// Assembles a source file into a flat image loadable at address 0
+static int assemble_image(const char* source, const char* image) {
+    Assembler assembler;
+    if(!assembler.assemble_file(source)) {
+        for(const string& error : assembler.errors()) fprintf(stderr, "%s: %s\n", source, error.c_str());
+        return 1;
+    }
+
+    FILE* out = fopen(image, "wb");
+    if(out == NULL) {
+        perror(image);
+        return 1;
+    }
+    const vector<BYTE>& bytes = assembler.image();
+    fwrite(bytes.data(), 1, bytes.size(), out);
+    fclose(out);
+
+    printf("%zu bytes of text, %zu bytes of data at 0x%x, entry 0x%x\n", assembler.text_size(), assembler.data_size(),
+           assembler.data_address(), assembler.entry());
+    return 0;
+}
+
+// Lists a flat image loaded at address 0, one word per line
+static int disassemble_image(const char* image) {
+    FILE* in = fopen(image, "rb");
+    if(in == NULL) {
+        perror(image);
+        return 1;
+    }
+
+    BYTE bytes[4];
+    char text[DISASM_BUFFER];
+    ADDRESS address = 0;
+    while(fread(bytes, 1, 4, in) == 4) {
+        WORD word = bytes[0] | bytes[1] << 8 | bytes[2] << 16 | (WORD)bytes[3] << 24;
+        disassemble(word, address, text, sizeof(text));
+        printf("0x%08x  %08x  %s\n", address, word, text);
+        address += 4;
+    }
+    fclose(in);
+    return 0;
+}
+
 int main(int argc, char * argv[]) {
+    if(argc > 2 && strcmp(argv[1], "--latency") == 0)
+        return latency(argv[2]);
+    if(argc > 3 && strcmp(argv[1], "--assemble") == 0)
+        return assemble_image(argv[2], argv[3]);
+    if(argc > 2 && strcmp(argv[1], "--disassemble") == 0)
+        return disassemble_image(argv[2]);
+
     Emulator* vm = new Emulator(128);
 
     cout << "Store word test:" << endl;
@@ -8,7 +8,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
         WORD program[1];
 
         SECTION("functions as identity/NOP when shift is 0") {
-            program[0] = Utilities::R_instruction(0, 2, 0, 1, 0, 0); // sll r2, r1, 0
+            program[0] = Utilities::R_instruction(OP_SPECIAL, 2, 0, 1, 0, FUNC_SLL); // sll r2, r1, 0
             vm = new Emulator(128, program, 1);
             vm->set_register(1, 0b1111);
 
@@ -17,7 +17,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
         }
 
         SECTION("functions as expected") {
-            program[0] = Utilities::R_instruction(0, 2, 0, 1, 5, 0); // sll r2, r1, 5
+            program[0] = Utilities::R_instruction(OP_SPECIAL, 2, 0, 1, 5, FUNC_SLL); // sll r2, r1, 5
             vm = new Emulator(128, program, 1);
             vm->set_register(1, 0b1111);
 
@@ -30,7 +30,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
         WORD program[1];
 
         SECTION("functions as identity/NOP when shift is 0") {
-            program[0] = Utilities::R_instruction(0, 2, 0, 1, 0, 2); // srl r2, r1, 0
+            program[0] = Utilities::R_instruction(OP_SPECIAL, 2, 0, 1, 0, FUNC_SRL); // srl r2, r1, 0
             vm = new Emulator(128, program, 1);
             vm->set_register(1, 0b1111);
 
@@ -39,7 +39,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
         }
 
         SECTION("functions as expected") {
-            program[0] = Utilities::R_instruction(0, 2, 0, 1, 2, 2); // srl r2, r1, 2
+            program[0] = Utilities::R_instruction(OP_SPECIAL, 2, 0, 1, 2, FUNC_SRL); // srl r2, r1, 2
             vm = new Emulator(128, program, 1);
             vm->set_register(1, 0b1111);
 
@@ -48,7 +48,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
         }
 
         SECTION("does not sign-extend") {
-            program[0] = Utilities::R_instruction(0, 2, 0, 1, 4, 2); // srl r2, r1, 2
+            program[0] = Utilities::R_instruction(OP_SPECIAL, 2, 0, 1, 4, FUNC_SRL); // srl r2, r1, 2
             vm = new Emulator(128, program, 1);
             vm->set_register(1, 0xffffffff);
 
@@ -61,7 +61,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
         WORD program[1];
 
         SECTION("functions as identity/NOP when shift is 0") {
-            program[0] = Utilities::R_instruction(0, 2, 0, 1, 0, 3); // sra r2, r1, 0
+            program[0] = Utilities::R_instruction(OP_SPECIAL, 2, 0, 1, 0, FUNC_SRA); // sra r2, r1, 0
             vm = new Emulator(128, program, 1);
             vm->set_register(1, 0b1111);
 
@@ -70,7 +70,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
         }
 
         SECTION("functions as expected") {
-            program[0] = Utilities::R_instruction(0, 2, 0, 1, 2, 3); // sra r2, r1, 2
+            program[0] = Utilities::R_instruction(OP_SPECIAL, 2, 0, 1, 2, FUNC_SRA); // sra r2, r1, 2
             vm = new Emulator(128, program, 1);
             vm->set_register(1, 0b1111);
 
@@ -79,7 +79,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
         }
 
         SECTION("does sign-extend") {
-            program[0] = Utilities::R_instruction(0, 2, 0, 1, 4, 3); // sra r2, r1, 2
+            program[0] = Utilities::R_instruction(OP_SPECIAL, 2, 0, 1, 4, FUNC_SRA); // sra r2, r1, 2
             vm = new Emulator(128, program, 1);
             vm->set_register(1, 0xffffffff);
 
@@ -92,7 +92,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
         WORD program[1];
 
         SECTION("functions as identity/NOP when register value is 0") {
-            program[0] = Utilities::R_instruction(0, 2, 0, 1, 0, 4); // sllv r2, r1, r0
+            program[0] = Utilities::R_instruction(OP_SPECIAL, 2, 0, 1, 0, FUNC_SLLV); // sllv r2, r1, r0
             vm = new Emulator(128, program, 1);
             vm->set_register(1, 0b1111);
 
@@ -101,7 +101,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
         }
 
         SECTION("functions as expected") {
-            program[0] = Utilities::R_instruction(0, 2, 3, 1, 0, 4); // sllv r2, r1, r3
+            program[0] = Utilities::R_instruction(OP_SPECIAL, 2, 3, 1, 0, FUNC_SLLV); // sllv r2, r1, r3
             vm = new Emulator(128, program, 1);
             vm->set_register(1, 0b1111);
             vm->set_register(3, 2);
@@ -111,7 +111,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
         }
 
         SECTION("uses only lowest 5 least-significant register bits") {
-            program[0] = Utilities::R_instruction(0, 2, 3, 1, 0, 4); // sllv r2, r1, r3
+            program[0] = Utilities::R_instruction(OP_SPECIAL, 2, 3, 1, 0, FUNC_SLLV); // sllv r2, r1, r3
             vm = new Emulator(128, program, 1);
             vm->set_register(1, 0xffffffff);
             vm->set_register(3, 0b100100); // should interpret as 4 and not 68
@@ -125,7 +125,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
         WORD program[1];
 
         SECTION("functions as identity/NOP when shift is 0") {
-            program[0] = Utilities::R_instruction(0, 2, 0, 1, 0, 6); // srlv r2, r1, r3
+            program[0] = Utilities::R_instruction(OP_SPECIAL, 2, 0, 1, 0, FUNC_SRLV); // srlv r2, r1, r3
             vm = new Emulator(128, program, 1);
             vm->set_register(1, 0b1111);
 
@@ -134,7 +134,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
         }
 
         SECTION("functions as expected") {
-            program[0] = Utilities::R_instruction(0, 2, 3, 1, 0, 6); // srlv r2, r1, r3
+            program[0] = Utilities::R_instruction(OP_SPECIAL, 2, 3, 1, 0, FUNC_SRLV); // srlv r2, r1, r3
             vm = new Emulator(128, program, 1);
             vm->set_register(1, 0b1111);
             vm->set_register(3, 2);
@@ -144,7 +144,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
         }
 
         SECTION("does not sign-extend") {
-            program[0] = Utilities::R_instruction(0, 2, 3, 1, 0, 6); // srlv r2, r1, r3
+            program[0] = Utilities::R_instruction(OP_SPECIAL, 2, 3, 1, 0, FUNC_SRLV); // srlv r2, r1, r3
             vm = new Emulator(128, program, 1);
             vm->set_register(1, 0xffffffff);
             vm->set_register(3, 4);
@@ -154,7 +154,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
         }
 
         SECTION("uses only lowest 5 least-significant register bits") {
-            program[0] = Utilities::R_instruction(0, 2, 3, 1, 0, 6); // srlv r2, r1, r3
+            program[0] = Utilities::R_instruction(OP_SPECIAL, 2, 3, 1, 0, FUNC_SRLV); // srlv r2, r1, r3
             vm = new Emulator(128, program, 1);
             vm->set_register(1, 0xffffffff);
             vm->set_register(3, 0b100100); // should interpret as 4 and not 68
@@ -168,7 +168,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
         WORD program[1];
 
         SECTION("functions as identity/NOP when shift is 0") {
-            program[0] = Utilities::R_instruction(0, 2, 0, 1, 0, 7); // srav r2, r1, r3
+            program[0] = Utilities::R_instruction(OP_SPECIAL, 2, 0, 1, 0, FUNC_SRAV); // srav r2, r1, r3
             vm = new Emulator(128, program, 1);
             vm->set_register(1, 0b1111);
 
@@ -177,7 +177,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
         }
 
         SECTION("functions as expected") {
-            program[0] = Utilities::R_instruction(0, 2, 3, 1, 0, 7); // srav r2, r1, r3
+            program[0] = Utilities::R_instruction(OP_SPECIAL, 2, 3, 1, 0, FUNC_SRAV); // srav r2, r1, r3
             vm = new Emulator(128, program, 1);
             vm->set_register(1, 0b1111);
             vm->set_register(3, 2);
@@ -187,7 +187,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
         }
 
         SECTION("does sign-extend") {
-            program[0] = Utilities::R_instruction(0, 2, 3, 1, 0, 7); // srav r2, r1, r3
+            program[0] = Utilities::R_instruction(OP_SPECIAL, 2, 3, 1, 0, FUNC_SRAV); // srav r2, r1, r3
             vm = new Emulator(128, program, 1);
             vm->set_register(1, 0xffffffff);
             vm->set_register(3, 4);
@@ -197,7 +197,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
         }
 
         SECTION("uses only lowest 5 least-significant register bits") {
-            program[0] = Utilities::R_instruction(0, 2, 3, 1, 0, 7); // srav r2, r1, r3
+            program[0] = Utilities::R_instruction(OP_SPECIAL, 2, 3, 1, 0, FUNC_SRAV); // srav r2, r1, r3
             vm = new Emulator(128, program, 1);
             vm->set_register(1, 0xf0ffffff);
             vm->set_register(3, 0b100100); // should interpret as 4 and not 68
@@ -209,9 +209,9 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
 
     SECTION("jr") {
         WORD program[3];
-        program[0] = Utilities::R_instruction(0, 0, 1, 0, 0, 8); // jr r1
-        program[1] = Utilities::R_instruction(0, 1, 1, 2, 0, 32); // add r1, r1, r2
-        program[2] = Utilities::R_instruction(0, 1, 1, 3, 0, 32); // add r1, r1, r3
+        program[0] = Utilities::R_instruction(OP_SPECIAL, 0, 1, 0, 0, FUNC_JR); // jr r1
+        program[1] = Utilities::R_instruction(OP_SPECIAL, 1, 1, 2, 0, FUNC_ADD); // add r1, r1, r2
+        program[2] = Utilities::R_instruction(OP_SPECIAL, 1, 1, 3, 0, FUNC_ADD); // add r1, r1, r3
 
         vm = new Emulator(128, program, 3);
         vm->set_register(1, 8);
@@ -227,9 +227,9 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
 
     SECTION("jalr") {
         WORD program[3];
-        program[0] = Utilities::R_instruction(0, 0, 1, 0, 0, 9); // jalr r1
-        program[1] = Utilities::R_instruction(0, 1, 1, 2, 0, 32); // add r1, r1, r2
-        program[2] = Utilities::R_instruction(0, 1, 1, 3, 0, 32); // add r1, r1, r3
+        program[0] = Utilities::R_instruction(OP_SPECIAL, 0, 1, 0, 0, FUNC_JALR); // jalr r1
+        program[1] = Utilities::R_instruction(OP_SPECIAL, 1, 1, 2, 0, FUNC_ADD); // add r1, r1, r2
+        program[2] = Utilities::R_instruction(OP_SPECIAL, 1, 1, 3, 0, FUNC_ADD); // add r1, r1, r3
 
         vm = new Emulator(128, program, 3);
         vm->set_register(1, 8);
@@ -248,7 +248,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
         WORD program[1];
 
         SECTION("executes when condition is zero") {
-            program[0] = Utilities::R_instruction(0, 1, 2, 0, 0, 10); // movz r1, r2, r0
+            program[0] = Utilities::R_instruction(OP_SPECIAL, 1, 2, 0, 0, FUNC_MOVZ); // movz r1, r2, r0
             vm = new Emulator(128, program, 1);
             vm->set_register(2, 10);
 
@@ -257,7 +257,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
         }
 
         SECTION("does not execute when condition is non-zero") {
-            program[0] = Utilities::R_instruction(0, 1, 2, 2, 0, 10); // movz r1, r2, r2
+            program[0] = Utilities::R_instruction(OP_SPECIAL, 1, 2, 2, 0, FUNC_MOVZ); // movz r1, r2, r2
             vm = new Emulator(128, program, 1);
             vm->set_register(2, 10);
 
@@ -270,7 +270,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
         WORD program[1];
 
         SECTION("does not execute when condition is zero") {
-            program[0] = Utilities::R_instruction(0, 1, 2, 0, 0, 11); // movn r1, r2, r0
+            program[0] = Utilities::R_instruction(OP_SPECIAL, 1, 2, 0, 0, FUNC_MOVN); // movn r1, r2, r0
             vm = new Emulator(128, program, 1);
             vm->set_register(2, 10);
 
@@ -279,7 +279,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
         }
 
         SECTION("executes when condition is non-zero") {
-            program[0] = Utilities::R_instruction(0, 1, 2, 2, 0, 11); // movn r1, r2, r2
+            program[0] = Utilities::R_instruction(OP_SPECIAL, 1, 2, 2, 0, FUNC_MOVN); // movn r1, r2, r2
             vm = new Emulator(128, program, 1);
             vm->set_register(2, 10);
 
@@ -290,7 +290,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
 
     SECTION("break") {
         WORD program[1];
-        program[0] = Utilities::R_instruction(0, 0, 0b10000, 0, 0b10010, 13); // break 0x80012
+        program[0] = Utilities::R_instruction(OP_SPECIAL, 0, 0b10000, 0, 0b10010, FUNC_BREAK); // break 0x80012
         vm = new Emulator(128, program, 1);
 
         SECTION("functions as expected") {
@@ -300,8 +300,8 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
 
     SECTION("mfhi and mthi") {
         WORD program[2];
-        program[0] = Utilities::R_instruction(0, 0, 1, 0, 0, 17); // mthi r1
-        program[1] = Utilities::R_instruction(0, 2, 0, 0, 0, 16); // mfhi r2
+        program[0] = Utilities::R_instruction(OP_SPECIAL, 0, 1, 0, 0, FUNC_MTHI); // mthi r1
+        program[1] = Utilities::R_instruction(OP_SPECIAL, 2, 0, 0, 0, FUNC_MFHI); // mfhi r2
         vm = new Emulator(128, program, 2);
         vm->set_register(1, 10);
 
@@ -314,8 +314,8 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
 
     SECTION("mflo and mtlo") {
         WORD program[2];
-        program[0] = Utilities::R_instruction(0, 0, 1, 0, 0, 19); // mtlo r1
-        program[1] = Utilities::R_instruction(0, 2, 0, 0, 0, 18); // mflo r2
+        program[0] = Utilities::R_instruction(OP_SPECIAL, 0, 1, 0, 0, FUNC_MTLO); // mtlo r1
+        program[1] = Utilities::R_instruction(OP_SPECIAL, 2, 0, 0, 0, FUNC_MFLO); // mflo r2
         vm = new Emulator(128, program, 2);
         vm->set_register(1, 10);
 
@@ -328,9 +328,9 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
 
     SECTION("mult") {
         WORD program[3];
-        program[0] = Utilities::R_instruction(0, 0, 1, 2, 0, 24); // mult r1, r2
-        program[1] = Utilities::R_instruction(0, 3, 0, 0, 0, 16); // mfhi r3
-        program[2] = Utilities::R_instruction(0, 4, 0, 0, 0, 18); // mflo r4
+        program[0] = Utilities::R_instruction(OP_SPECIAL, 0, 1, 2, 0, FUNC_MULT); // mult r1, r2
+        program[1] = Utilities::R_instruction(OP_SPECIAL, 3, 0, 0, 0, FUNC_MFHI); // mfhi r3
+        program[2] = Utilities::R_instruction(OP_SPECIAL, 4, 0, 0, 0, FUNC_MFLO); // mflo r4
 
         SECTION("two positive numbers multiplication works correctly") {
             vm = new Emulator(128, program, 3);
@@ -389,9 +389,9 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
 
     SECTION("multu") {
         WORD program[3];
-        program[0] = Utilities::R_instruction(0, 0, 1, 2, 0, 25); // mult r1, r2
-        program[1] = Utilities::R_instruction(0, 3, 0, 0, 0, 16); // mfhi r3
-        program[2] = Utilities::R_instruction(0, 4, 0, 0, 0, 18); // mflo r4
+        program[0] = Utilities::R_instruction(OP_SPECIAL, 0, 1, 2, 0, FUNC_MULTU); // mult r1, r2
+        program[1] = Utilities::R_instruction(OP_SPECIAL, 3, 0, 0, 0, FUNC_MFHI); // mfhi r3
+        program[2] = Utilities::R_instruction(OP_SPECIAL, 4, 0, 0, 0, FUNC_MFLO); // mflo r4
 
         SECTION("two positive numbers multiplication works correctly") {
             vm = new Emulator(128, program, 3);
@@ -432,9 +432,9 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
 
     SECTION("div") {
         WORD program[3];
-        program[0] = Utilities::R_instruction(0, 0, 1, 2, 0, 26); // div r1, r2
-        program[1] = Utilities::R_instruction(0, 3, 0, 0, 0, 16); // mfhi r3
-        program[2] = Utilities::R_instruction(0, 4, 0, 0, 0, 18); // mflo r4
+        program[0] = Utilities::R_instruction(OP_SPECIAL, 0, 1, 2, 0, FUNC_DIV); // div r1, r2
+        program[1] = Utilities::R_instruction(OP_SPECIAL, 3, 0, 0, 0, FUNC_MFHI); // mfhi r3
+        program[2] = Utilities::R_instruction(OP_SPECIAL, 4, 0, 0, 0, FUNC_MFLO); // mflo r4
 
         SECTION("divide two positive numbers") {
             SECTION("no remainder") {
@@ -591,9 +591,9 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
 
     SECTION("divu") {
         WORD program[3];
-        program[0] = Utilities::R_instruction(0, 0, 1, 2, 0, 27); // divu r1, r2
-        program[1] = Utilities::R_instruction(0, 3, 0, 0, 0, 16); // mfhi r3
-        program[2] = Utilities::R_instruction(0, 4, 0, 0, 0, 18); // mflo r4
+        program[0] = Utilities::R_instruction(OP_SPECIAL, 0, 1, 2, 0, FUNC_DIVU); // divu r1, r2
+        program[1] = Utilities::R_instruction(OP_SPECIAL, 3, 0, 0, 0, FUNC_MFHI); // mfhi r3
+        program[2] = Utilities::R_instruction(OP_SPECIAL, 4, 0, 0, 0, FUNC_MFLO); // mflo r4
 
         SECTION("divide two positive numbers") {
             SECTION("no remainder") {
@@ -694,7 +694,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
 
     SECTION("add") {
         WORD program[1];
-        program[0] = Utilities::R_instruction(0, 3, 1, 2, 0, 32); // add r3, r1, r2
+        program[0] = Utilities::R_instruction(OP_SPECIAL, 3, 1, 2, 0, FUNC_ADD); // add r3, r1, r2
         vm = new Emulator(128, program, 1);
 
         SECTION("functions as expected with positive, normal input") {
@@ -752,7 +752,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
 
     SECTION("addu") {
         WORD program[1];
-        program[0] = Utilities::R_instruction(0, 3, 1, 2, 0, 33); // addu r3, r1, r2
+        program[0] = Utilities::R_instruction(OP_SPECIAL, 3, 1, 2, 0, FUNC_ADDU); // addu r3, r1, r2
         vm = new Emulator(128, program, 1);
 
         SECTION("functions as expected with positive, normal input") {
@@ -798,7 +798,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
 
     SECTION("sub") {
         WORD program[1];
-        program[0] = Utilities::R_instruction(0, 3, 1, 2, 0, 34); // sub r3, r1, r2
+        program[0] = Utilities::R_instruction(OP_SPECIAL, 3, 1, 2, 0, FUNC_SUB); // sub r3, r1, r2
         vm = new Emulator(128, program, 1);
 
         SECTION("functions as expected with positive, normal input") {
@@ -856,7 +856,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
 
     SECTION("subu") {
         WORD program[1];
-        program[0] = Utilities::R_instruction(0, 3, 1, 2, 0, 35); // subu r3, r1, r2
+        program[0] = Utilities::R_instruction(OP_SPECIAL, 3, 1, 2, 0, FUNC_SUBU); // subu r3, r1, r2
         vm = new Emulator(128, program, 1);
 
         SECTION("functions as expected with positive, normal input") {
@@ -902,7 +902,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
 
     SECTION("and") {
         WORD program[1];
-        program[0] = Utilities::R_instruction(0, 3, 1, 2, 0, 36); // and r3, r1, r2
+        program[0] = Utilities::R_instruction(OP_SPECIAL, 3, 1, 2, 0, FUNC_AND); // and r3, r1, r2
         vm = new Emulator(128, program, 1);
 
         SECTION("functions as expected") {
@@ -916,7 +916,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
 
     SECTION("or") {
         WORD program[1];
-        program[0] = Utilities::R_instruction(0, 3, 1, 2, 0, 37); // or r3, r1, r2
+        program[0] = Utilities::R_instruction(OP_SPECIAL, 3, 1, 2, 0, FUNC_OR); // or r3, r1, r2
         vm = new Emulator(128, program, 1);
 
         SECTION("functions as expected") {
@@ -930,7 +930,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
 
     SECTION("xor") {
         WORD program[1];
-        program[0] = Utilities::R_instruction(0, 3, 1, 2, 0, 38); // xor r3, r1, r2
+        program[0] = Utilities::R_instruction(OP_SPECIAL, 3, 1, 2, 0, FUNC_XOR); // xor r3, r1, r2
         vm = new Emulator(128, program, 1);
 
         SECTION("functions as expected") {
@@ -944,7 +944,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
 
     SECTION("nor") {
         WORD program[1];
-        program[0] = Utilities::R_instruction(0, 3, 1, 2, 0, 39); // nor r3, r1, r2
+        program[0] = Utilities::R_instruction(OP_SPECIAL, 3, 1, 2, 0, FUNC_NOR); // nor r3, r1, r2
         vm = new Emulator(128, program, 1);
 
         SECTION("functions as expected") {
@@ -958,7 +958,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
 
     SECTION("slt") {
         WORD program[1];
-        program[0] = Utilities::R_instruction(0, 3, 1, 2, 0, 42); // slt r3, r1, r2
+        program[0] = Utilities::R_instruction(OP_SPECIAL, 3, 1, 2, 0, FUNC_SLT); // slt r3, r1, r2
         vm = new Emulator(128, program, 1);
 
         SECTION("sets when appropriate (2 +ve values)") {
@@ -989,7 +989,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
 
     SECTION("sltu") {
         WORD program[1];
-        program[0] = Utilities::R_instruction(0, 3, 1, 2, 0, 43); // sltu r3, r1, r2
+        program[0] = Utilities::R_instruction(OP_SPECIAL, 3, 1, 2, 0, FUNC_SLTU); // sltu r3, r1, r2
         vm = new Emulator(128, program, 1);
 
         SECTION("sets when appropriate (2 +ve values)") {
@@ -1021,7 +1021,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
 
     SECTION("tge") {
         WORD program[1];
-        program[0] = Utilities::R_instruction(0, 0, 1, 2, 0, 48); // tge r1, r2
+        program[0] = Utilities::R_instruction(OP_SPECIAL, 0, 1, 2, 0, FUNC_TGE); // tge r1, r2
         vm = new Emulator(128, program, 1);
 
         SECTION("traps when greater") {
@@ -1055,7 +1055,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
 
     SECTION("tgeu") {
         WORD program[1];
-        program[0] = Utilities::R_instruction(0, 0, 1, 2, 0, 49); // tgeu r1, r2
+        program[0] = Utilities::R_instruction(OP_SPECIAL, 0, 1, 2, 0, FUNC_TGEU); // tgeu r1, r2
         vm = new Emulator(128, program, 1);
 
         SECTION("traps when greater") {
@@ -1089,7 +1089,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
 
     SECTION("tlt") {
         WORD program[1];
-        program[0] = Utilities::R_instruction(0, 0, 1, 2, 0, 50); // tlt r1, r2
+        program[0] = Utilities::R_instruction(OP_SPECIAL, 0, 1, 2, 0, FUNC_TLT); // tlt r1, r2
         vm = new Emulator(128, program, 1);
 
         SECTION("traps when less than") {
@@ -1123,7 +1123,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
 
     SECTION("tltu") {
         WORD program[1];
-        program[0] = Utilities::R_instruction(0, 0, 1, 2, 0, 51); // tltu r1, r2
+        program[0] = Utilities::R_instruction(OP_SPECIAL, 0, 1, 2, 0, FUNC_TLTU); // tltu r1, r2
         vm = new Emulator(128, program, 1);
 
         SECTION("traps when less than") {
@@ -1157,7 +1157,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
 
     SECTION("teq") {
         WORD program[1];
-        program[0] = Utilities::R_instruction(0, 0, 1, 2, 0, 52); // teq r1, r2
+        program[0] = Utilities::R_instruction(OP_SPECIAL, 0, 1, 2, 0, FUNC_TEQ); // teq r1, r2
         vm = new Emulator(128, program, 1);
 
         SECTION("doesn't trap when less than") {
@@ -1184,7 +1184,7 @@ TEST_CASE("Test ALU operations", "[step][ALU]") {
 
     SECTION("tne") {
         WORD program[1];
-        program[0] = Utilities::R_instruction(0, 0, 1, 2, 0, 54); // tne r1, r2
+        program[0] = Utilities::R_instruction(OP_SPECIAL, 0, 1, 2, 0, FUNC_TNE); // tne r1, r2
         vm = new Emulator(128, program, 1);
 
         SECTION("traps when less than") {
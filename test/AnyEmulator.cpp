@@ -0,0 +1,104 @@
+#include <memory>
+
+#include "../include/catch.hpp"
+#include "../src/AnyEmulator.hpp"
+#include "../src/Trace.hpp"
+#include "../src/Utilities.hpp"
+#include "../src/Workloads.hpp"
+
+template<typename E>
+concept Counting = requires(E& vm) { vm.counters(); };
+template<typename E>
+concept Tracing = requires(E& vm, TraceRing* ring) { vm.trace_to(ring); };
+
+TEST_CASE("Policies leave out what they do not select", "[AnyEmulator][step]") {
+    typedef BasicEmulator<EmulatorPolicy<EMU_BOUNDS_CHECKS>> Lenient;
+    typedef BasicEmulator<EmulatorPolicy<EMU_BOUNDS_CHECKS | EMU_STRICT_TRAPS | EMU_BIG_ENDIAN>> BigEndian;
+    // Accessors of features a policy lacks are not declared at all
+    static_assert(!Counting<Lenient> && !Tracing<Lenient>);
+    static_assert(Tracing<Emulator>);
+
+    SECTION("add, sub and addi wrap and misaligned accesses go through without strict traps") {
+        WORD program[5];
+        program[0] = Utilities::R_instruction(OP_SPECIAL, 3, 1, 2, 0, FUNC_ADD); // add r3, r1, r2
+        program[1] = Utilities::R_instruction(OP_SPECIAL, 4, 5, 2, 0, FUNC_SUB); // sub r4, r5, r2
+        program[2] = Utilities::I_instruction(OP_ADDI, 6, 1, 1);                // addi r6, r1, 1
+        program[3] = Utilities::I_instruction(OP_SW, 1, 0, 33);                 // sw r1, 33(r0)
+        program[4] = Utilities::I_instruction(OP_LW, 7, 0, 33);                 // lw r7, 33(r0)
+
+        Lenient lenient(64, program, 5);
+        Emulator strict(64, program, 5);
+        for(int r = 1; r <= 2; r++) {
+            lenient.set_register(r, r == 1 ? 0x7fffffff : 1), strict.set_register(r, r == 1 ? 0x7fffffff : 1);
+        }
+        lenient.set_register(5, 0x80000000), strict.set_register(5, 0x80000000);
+
+        for(int i = 0; i < 5; i++) REQUIRE(lenient.step() == STEP_OK);
+        REQUIRE(lenient.get_register(3) == 0x80000000);
+        REQUIRE(lenient.get_register(4) == 0x7fffffff);
+        REQUIRE(lenient.get_register(6) == 0x80000000);
+        REQUIRE(lenient.get_register(7) == 0x7fffffff);
+
+        REQUIRE(strict.step() == STEP_TRAP);
+        strict.state().PC = 12;
+        REQUIRE(strict.step() == STEP_TRAP);
+    }
+
+    SECTION("Big-endian memory stores the most significant byte first") {
+        WORD program[6];
+        program[0] = Utilities::I_instruction(OP_SW, 1, 0, 32);  // sw r1, 32(r0)
+        program[1] = Utilities::I_instruction(OP_LBU, 2, 0, 32); // lbu r2, 32(r0)
+        program[2] = Utilities::I_instruction(OP_LHU, 3, 0, 34); // lhu r3, 34(r0)
+        program[3] = Utilities::I_instruction(OP_SH, 1, 0, 36);  // sh r1, 36(r0)
+        program[4] = Utilities::I_instruction(OP_LWL, 4, 0, 33); // lwl r4, 33(r0)
+        program[5] = Utilities::I_instruction(OP_LWR, 5, 0, 33); // lwr r5, 33(r0)
+
+        BigEndian vm(64, program, 6);
+        vm.set_register(1, 0x11223344);
+        for(int i = 0; i < 6; i++) REQUIRE(vm.step() == STEP_OK);
+
+        REQUIRE(vm.load_byte(32) == 0x11);
+        REQUIRE(vm.load_byte(35) == 0x44);
+        REQUIRE(vm.get_register(2) == 0x11);
+        REQUIRE(vm.get_register(3) == 0x3344);
+        REQUIRE(vm.load_byte(36) == 0x33);
+        REQUIRE(vm.load_byte(37) == 0x44);
+        REQUIRE(vm.get_register(4) == 0x22334400);
+        REQUIRE(vm.get_register(5) == 0x1122);
+        // Instructions are words too, so the program still runs
+        REQUIRE(vm.load_word(0) == program[0]);
+    }
+}
+
+TEST_CASE("AnyEmulator runs workloads with every feature set", "[AnyEmulator][Workloads]") {
+    for(const Workload& w : workload_corpus()) {
+        // Every feature set runs the same instructions
+        std::unique_ptr<Emulator> reference(w.load());
+        DWORD expected = 0;
+        run_workload(*reference, 10000000, expected);
+
+        for(unsigned features = 0; features < EMU_FEATURE_SETS; features++) {
+            INFO(w.name << " with features " << features);
+            AnyEmulator vm(features, w.memory_size, w.image.data(), w.image.size());
+            REQUIRE(vm.features() == features);
+            w.reset(vm);
+
+            DWORD executed = 0;
+            REQUIRE(vm.run(10000000, executed) == WORKLOAD_DONE);
+            REQUIRE(w.check(vm));
+            REQUIRE(executed == expected);
+
+            REQUIRE((vm.counters() != NULL) == ((features & EMU_COUNTING) != 0));
+            TraceRing ring(16);
+            REQUIRE(vm.trace_to(&ring) == ((features & EMU_TRACING) != 0));
+            REQUIRE(vm.track_dirty(NULL) == ((features & EMU_DIRTY_TRACKING) != 0));
+        }
+    }
+
+    AnyEmulator counting(EMU_COUNTING | EMU_FEATURE_SETS, 64);
+    REQUIRE(counting.features() == EMU_COUNTING);
+    counting.store_word(Utilities::R_instruction(OP_SPECIAL, 1, 0, 0, 0, FUNC_BREAK), 0);
+    REQUIRE(counting.step() == 32);
+    REQUIRE(counting.counters()->breaks == 1);
+    REQUIRE(counting.state().PC == 0);
+}
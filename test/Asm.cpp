@@ -0,0 +1,90 @@
+#include "../include/catch.hpp"
+#include "../src/Asm.hpp"
+#include "../src/Utilities.hpp"
+
+// Sums the words of a table found through `la`, then stores the sum after it
+static constexpr auto sum_program = assemble<[](Asm& a) {
+    a.la(4, "table");
+    a.li(5, 4);
+    a.move(2, 0);
+    a.label("loop");
+    a.lw(6, 0, 4);
+    a.addu(2, 2, 6);
+    a.addiu(4, 4, 4);
+    a.addiu(5, 5, -1);
+    a.bgtz(5, "loop");
+    a.sw(2, 0, 4);
+    a.nop();
+    a.j("done");
+    a.brk(2);
+    a.label("done");
+    a.brk(1);
+    a.label("table");
+    a.word(10);
+    a.word(200);
+    a.word(3000);
+    a.word(40000);
+    a.word(0);
+}>();
+
+// Encoded, placed and resolved by the compiler
+static_assert(sum_program.size() == 19);
+static_assert(sum_program[0] == Utilities::I_instruction(OP_LUI, 4, 0, 0));
+static_assert(sum_program[1] == Utilities::I_instruction(OP_ORI, 4, 4, 14 * 4));
+static_assert(sum_program[8] == Utilities::I_instruction(OP_BGTZ, 0, 5, -4));
+static_assert(sum_program[11] == Utilities::J_instruction(OP_J, 13));
+static_assert(sum_program[14] == 10);
+
+TEST_CASE("Compile-time programs run", "[Asm]") {
+    Emulator vm(0x100, sum_program.data(), sum_program.size());
+    int status = STEP_OK;
+    for(int i = 0; i < 100 && status == STEP_OK; i++) status = vm.step();
+
+    REQUIRE(status == 1);
+    REQUIRE(vm.get_register(2) == 43210);
+    REQUIRE(vm.load_word(18 * 4) == 43210);
+}
+
+TEST_CASE("li picks the shortest encoding", "[Asm]") {
+    constexpr auto program = assemble<[](Asm& a) {
+        a.li(1, 5);
+        a.li(2, (WORD)-5);
+        a.li(3, 0x12345678);
+        a.li(4, 0x8000);
+    }>();
+    static_assert(program.size() == 6);
+
+    Emulator vm(0x100, program.data(), program.size());
+    for(size_t i = 0; i < program.size(); i++) REQUIRE(vm.step() == STEP_OK);
+    REQUIRE(vm.get_register(1) == 5);
+    REQUIRE(vm.get_register(2) == (WORD)-5);
+    REQUIRE(vm.get_register(3) == 0x12345678);
+    REQUIRE(vm.get_register(4) == 0x8000);
+}
+
+TEST_CASE("Asm also assembles at run time", "[Asm]") {
+    Asm a;
+    a.label("top");
+    a.addiu(1, 1, 1);
+    a.bne(1, 2, "top");
+    a.brk(WORD(1) << 19 | 5);
+    std::vector<WORD> code = a.assemble();
+
+    REQUIRE(code.size() == 3);
+    REQUIRE(code[1] == Utilities::I_instruction(OP_BNE, 2, 1, -1));
+
+    Emulator vm(0x100, code.data(), code.size());
+    vm.set_register(2, 3);
+    int status = STEP_OK;
+    while(status == STEP_OK) status = vm.step();
+    REQUIRE(status == (1 << 19 | 5));
+    REQUIRE(vm.get_register(1) == 3);
+
+    int labels = 0;
+    a.each_label([&](std::string_view name, ADDRESS address) {
+        REQUIRE(name == "top");
+        REQUIRE(address == 0);
+        labels++;
+    });
+    REQUIRE(labels == 1);
+}
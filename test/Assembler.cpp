@@ -0,0 +1,184 @@
+#include <string>
+
+#include "../include/catch.hpp"
+#include "../src/Assembler.hpp"
+#include "../src/Utilities.hpp"
+#include "../src/Workloads.hpp"
+
+static WORD word_at(const std::vector<BYTE>& image, ADDRESS address) {
+    return image[address] | image[address + 1] << 8 | image[address + 2] << 16 | (WORD)image[address + 3] << 24;
+}
+
+TEST_CASE("Assembler matches hand-encoded instructions", "[Assembler]") {
+    Assembler assembler;
+    REQUIRE(assembler.assemble("lui $1, 0xaabb\n"
+                               "ori $9, $1, 0xccdd   # comment\n"
+                               "  sw $t1, 4($sp)\n"
+                               "addi $29, $29, 4\n"
+                               "lwl $10, 1($29)\n"
+                               "lwr $11, 1($29)\n"
+                               "lb $12, ($29)\n"
+                               "sll $3, $4, 5\n"
+                               "srlv $3, $4, $5\n"
+                               "mult $a0, $a1\n"
+                               "jalr $ra\n"
+                               "break 0x3ff\n"));
+
+    const WORD expected[] = {0x3c01aabb,
+                             0x3429ccdd,
+                             0xafa90004,
+                             0x23bd0004,
+                             0x8baa0001,
+                             0x9bab0001,
+                             0x83ac0000,
+                             Utilities::R_instruction(OP_SPECIAL, 3, 0, 4, 5, FUNC_SLL),
+                             Utilities::R_instruction(OP_SPECIAL, 3, 5, 4, 0, FUNC_SRLV),
+                             Utilities::R_instruction(OP_SPECIAL, 0, 4, 5, 0, FUNC_MULT),
+                             Utilities::R_instruction(OP_SPECIAL, 31, 31, 0, 0, FUNC_JALR),
+                             Utilities::R_instruction(OP_SPECIAL, 31, 0, 0, 31, FUNC_BREAK)};
+    const size_t count = sizeof(expected) / sizeof(expected[0]);
+    REQUIRE(assembler.text_size() == count * 4);
+    REQUIRE(assembler.image().size() == count * 4);
+    for(size_t i = 0; i < count; i++) REQUIRE(word_at(assembler.image(), i * 4) == expected[i]);
+}
+
+TEST_CASE("Assembled programs run", "[Assembler]") {
+    // Fibonacci numbers into a table, then their sum through blt/bnez loops
+    const char* source = "        .text\n"
+                         "        .globl main\n"
+                         "start:  break 1            # skipped: main is the entry\n"
+                         "main:   la $s0, table\n"
+                         "        li $t0, 1\n"
+                         "        li $t1, 1\n"
+                         "        li $s1, 0\n"
+                         "        li $s2, count\n"
+                         "fill:   sw $t0, 0($s0)\n"
+                         "        addu $t2, $t0, $t1\n"
+                         "        move $t0, $t1\n"
+                         "        move $t1, $t2\n"
+                         "        addiu $s0, $s0, 4\n"
+                         "        addiu $s1, $s1, 1\n"
+                         "        blt $s1, $s2, fill\n"
+                         "        la $s0, table\n"
+                         "        li $v0, 0\n"
+                         "sum:    lw $t0, 0($s0)\n"
+                         "        addu $v0, $v0, $t0\n"
+                         "        addiu $s0, $s0, 4\n"
+                         "        addiu $s2, $s2, -1\n"
+                         "        bnez $s2, sum\n"
+                         "        la $t3, result\n"
+                         "        sw $v0, 0($t3)\n"
+                         "        neg $v1, $v0\n"
+                         "        li $a0, 0x12345678\n"
+                         "        li $a1, 0x8000\n"
+                         "        li $a2, 0x70000\n"
+                         "        jal done\n"
+                         "        break 2\n"
+                         "done:   break 0x3ff\n"
+                         "        .data\n"
+                         "result: .word 0\n"
+                         "table:  .space 40\n";
+
+    // li needs a constant, not a label
+    Assembler bad;
+    REQUIRE_FALSE(bad.assemble(source));
+    REQUIRE(bad.errors()[0] == "line 8: 'count' is not a constant");
+
+    std::string fixed(source);
+    fixed.replace(fixed.find("count"), 5, "10");
+    Assembler assembler;
+    REQUIRE(assembler.assemble(fixed));
+    REQUIRE(assembler.entry() == 4);
+    REQUIRE(assembler.data_address() == EMU_PAGE_SIZE);
+    REQUIRE(assembler.data_size() == 44);
+    REQUIRE(assembler.symbols().find("table") == EMU_PAGE_SIZE + 4);
+
+    Emulator* vm = assembler.load(2 * EMU_PAGE_SIZE);
+    REQUIRE(vm != NULL);
+    DWORD executed = 0;
+    REQUIRE(run_workload(*vm, 1000, executed) == WORKLOAD_DONE);
+
+    // 1 + 1 + 2 + ... + 55
+    REQUIRE(vm->get_register(2) == 143);
+    REQUIRE(vm->load_word(EMU_PAGE_SIZE) == 143);
+    REQUIRE(vm->load_word(EMU_PAGE_SIZE + 4 + 9 * 4) == 55);
+    REQUIRE(vm->get_register(3) == (WORD)-143);
+    REQUIRE(vm->get_register(4) == 0x12345678);
+    REQUIRE(vm->get_register(5) == 0x8000);
+    REQUIRE(vm->get_register(6) == 0x70000);
+    REQUIRE(vm->get_register(31) == assembler.symbols().find("done") - 4);
+    delete vm;
+
+    REQUIRE(assembler.load(EMU_PAGE_SIZE) == NULL);
+}
+
+TEST_CASE("Assembler lays out data directives", "[Assembler]") {
+    AssemblerConfig config;
+    config.data_address = 0x100;
+    Assembler assembler(config);
+    REQUIRE(assembler.assemble(".data\n"
+                               "bytes: .byte 1, -1, 'a', ','\n"
+                               "words: .word 0xdeadbeef, bytes + 2, -1\n"
+                               "half:  .half 0x1234\n"
+                               "text:  .asciiz \"hi, \\\"you\\\"\\n\" # not a comment\n"
+                               "       .align 3\n"
+                               "end:   .ascii \"x\"\n"
+                               ".text\n"
+                               "       lw $1, words($0)\n"
+                               "       la $2, end + 1\n"));
+
+    const std::vector<BYTE>& image = assembler.image();
+    REQUIRE(assembler.text_size() == 12);
+    REQUIRE(image.size() == 0x100 + 0x21);
+    REQUIRE(image[0x100] == 1);
+    REQUIRE(image[0x101] == 0xff);
+    REQUIRE(image[0x102] == 'a');
+    REQUIRE(image[0x103] == ',');
+    // .word aligns itself
+    REQUIRE(word_at(image, 0x104) == 0xdeadbeef);
+    REQUIRE(word_at(image, 0x108) == 0x102);
+    REQUIRE(word_at(image, 0x10c) == 0xffffffff);
+    REQUIRE((image[0x110] | image[0x111] << 8) == 0x1234);
+    REQUIRE(std::string((const char*)&image[0x112]) == "hi, \"you\"\n");
+    REQUIRE(image[0x120] == 'x');
+    REQUIRE(assembler.symbols().find("end") == 0x120);
+
+    REQUIRE(word_at(image, 0) == Utilities::I_instruction(OP_LW, 1, 0, 0x104));
+    REQUIRE(word_at(image, 8) == Utilities::I_instruction(OP_ORI, 2, 2, 0x121));
+}
+
+TEST_CASE("Assembler reports errors by line", "[Assembler]") {
+    Assembler assembler;
+    REQUIRE_FALSE(assembler.assemble("top: addiu $1, $1, 40000\n"
+                                     "     frob $1\n"
+                                     "     lw $1, 4\n"
+                                     "     beq $1, $2, nowhere\n"
+                                     "top: add $1, $2\n"
+                                     "     or $1, $2, $32\n"
+                                     "     .data\n"
+                                     "     nop\n"));
+
+    const std::vector<std::string>& errors = assembler.errors();
+    // Pass 1 stops the assembly before anything is encoded
+    REQUIRE(errors.size() == 3);
+    REQUIRE(errors[0] == "line 2: unknown instruction 'frob'");
+    REQUIRE(errors[1] == "line 8: instruction in .data");
+    REQUIRE(errors[2] == "line 5: label 'top' defined twice");
+
+    REQUIRE_FALSE(assembler.assemble("     addiu $1, $1, 40000\n"
+                                     "     lw $1, 4\n"
+                                     "     beq $1, $2, nowhere\n"
+                                     "     add $1, $2\n"
+                                     "     or $1, $2, $32\n"
+                                     "     sll $1, $2, 32\n"));
+    REQUIRE(errors.size() == 6);
+    REQUIRE(errors[0] == "line 1: immediate out of range");
+    REQUIRE(errors[1] == "line 2: expected offset(base), got '4'");
+    REQUIRE(errors[2] == "line 3: undefined label 'nowhere'");
+    REQUIRE(errors[3] == "line 4: add takes 3 operands");
+    REQUIRE(errors[4] == "line 5: bad register '$32'");
+    REQUIRE(errors[5] == "line 6: immediate out of range");
+
+    REQUIRE_FALSE(assembler.assemble_file("/nonexistent/source.s"));
+    REQUIRE(errors.size() == 1);
+}
@@ -0,0 +1,111 @@
+#include <vector>
+
+#include "../include/catch.hpp"
+#include "../src/Utilities.hpp"
+#include "../src/Async.hpp"
+
+static Task guest(AsyncEmulator& emu, size_t slice, std::vector<int>& log, int id) {
+    while(true) {
+        Slice s = co_await emu.run_for(slice);
+        log.push_back(id);
+        if(s.status != STEP_OK) break;
+    }
+}
+
+TEST_CASE("Guests run as coroutines", "[Async][run_for]") {
+    Scheduler scheduler;
+    std::vector<int> log;
+
+    WORD program[6];
+    program[0] = Utilities::I_instruction(OP_ADDIU, 1, 1, 1); // addiu r1, r1, 1
+    program[1] = Utilities::I_instruction(OP_ADDIU, 1, 1, 1); // addiu r1, r1, 1
+    program[2] = Utilities::I_instruction(OP_ADDIU, 1, 1, 1); // addiu r1, r1, 1
+    program[3] = Utilities::I_instruction(OP_ADDIU, 1, 1, 1); // addiu r1, r1, 1
+    program[4] = Utilities::R_instruction(OP_SPECIAL, 1, 0, 0, 0, FUNC_BREAK); // break 32
+
+    SECTION("slices of different guests are interleaved") {
+        AsyncEmulator* a = new AsyncEmulator(scheduler, 128, program, 5);
+        AsyncEmulator* b = new AsyncEmulator(scheduler, 128, program, 5);
+
+        scheduler.spawn(guest(*a, 2, log, 1));
+        scheduler.spawn(guest(*b, 2, log, 2));
+        scheduler.run();
+
+        REQUIRE(log == std::vector<int>({1, 2, 1, 2, 1, 2}));
+        REQUIRE(a->get_register(1) == 4);
+        REQUIRE(b->get_register(1) == 4);
+        REQUIRE(scheduler.active_tasks() == 0);
+    }
+
+    SECTION("slice reports the break code and instructions executed") {
+        AsyncEmulator* a = new AsyncEmulator(scheduler, 128, program, 5);
+        Slice result;
+
+        auto run = [](AsyncEmulator& emu, Slice& result) -> Task {
+            result = co_await emu.run_for(100);
+        };
+        scheduler.spawn(run(*a, result));
+        scheduler.run();
+
+        REQUIRE(result.status == 32);
+        REQUIRE(result.executed == 5);
+    }
+}
+
+TEST_CASE("Syscalls suspend the guest until the host completes them", "[Async][syscall]") {
+    Scheduler scheduler;
+    std::vector<int> log;
+    std::vector<HostCall*> calls;
+
+    WORD program[5];
+    program[0] = Utilities::I_instruction(OP_ADDIU, 2, 0, 7); // addiu r2, r0, 7
+    program[1] = Utilities::I_instruction(OP_ADDIU, 4, 0, 5); // addiu r4, r0, 5
+    program[2] = Utilities::R_instruction(OP_SPECIAL, 0, 0, 0, 0, FUNC_SYSCALL); // syscall
+    program[3] = Utilities::R_instruction(OP_SPECIAL, 9, 2, 0, 0, FUNC_ADDU); // addu r9, r2, r0
+    program[4] = Utilities::R_instruction(OP_SPECIAL, 1, 0, 0, 0, FUNC_BREAK); // break 32
+
+    SECTION("without a handler the slice stops at the syscall") {
+        AsyncEmulator* a = new AsyncEmulator(scheduler, 128, program, 5);
+        Slice result;
+
+        auto run = [](AsyncEmulator& emu, Slice& result) -> Task {
+            result = co_await emu.run_for(100);
+        };
+        scheduler.spawn(run(*a, result));
+        scheduler.run();
+
+        REQUIRE(result.status == STEP_SYSCALL);
+        REQUIRE(result.executed == 3);
+    }
+
+    SECTION("host calls are serviced asynchronously") {
+        scheduler.on_host_call = [&](HostCall& call) { calls.push_back(&call); };
+
+        AsyncEmulator* a = new AsyncEmulator(scheduler, 128, program, 5);
+        AsyncEmulator* b = new AsyncEmulator(scheduler, 128, program, 5);
+        scheduler.spawn(guest(*a, 100, log, 1));
+        scheduler.spawn(guest(*b, 100, log, 2));
+        scheduler.run();
+
+        // Both guests are parked on their syscall
+        REQUIRE(log.empty());
+        REQUIRE(calls.size() == 2);
+        REQUIRE(scheduler.pending_calls() == 2);
+        REQUIRE(calls[0]->number == 7);
+        REQUIRE(calls[0]->args[0] == 5);
+
+        // Complete them out of order
+        scheduler.complete(*calls[1], 200);
+        scheduler.run();
+        // One entry for the slice ending at the syscall, one for the slice ending at the break
+        REQUIRE(log == std::vector<int>({2, 2}));
+        REQUIRE(b->get_register(9) == 200);
+
+        scheduler.complete(*calls[0], 100);
+        scheduler.run();
+        REQUIRE(log == std::vector<int>({2, 2, 1, 1}));
+        REQUIRE(a->get_register(9) == 100);
+        REQUIRE(scheduler.pending_calls() == 0);
+        REQUIRE(scheduler.active_tasks() == 0);
+    }
+}
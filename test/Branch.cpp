@@ -6,9 +6,9 @@ TEST_CASE("Test Branch instructions", "[step][Branch]") {
 
     SECTION("beq") {
         WORD program[1];
-        program[0] = Utilities::I_instruction(4, 1, 2, 0b10); // beq r1, r2, 2(+8)
-        program[1] = Utilities::R_instruction(0, 1, 0, 1, 0, 32); // add r1, r0, r1
-        program[2] = Utilities::R_instruction(0, 1, 1, 2, 0, 32); // add r1, r1, r2
+        program[0] = Utilities::I_instruction(OP_BEQ, 1, 2, 0b10); // beq r1, r2, 2(+8)
+        program[1] = Utilities::R_instruction(OP_SPECIAL, 1, 0, 1, 0, FUNC_ADD); // add r1, r0, r1
+        program[2] = Utilities::R_instruction(OP_SPECIAL, 1, 1, 2, 0, FUNC_ADD); // add r1, r1, r2
 
         SECTION("branches if registers are equal") {
             vm = new Emulator(128, program, 3);
@@ -32,10 +32,10 @@ TEST_CASE("Test Branch instructions", "[step][Branch]") {
 
         SECTION("immediate is sign-extended") {
             WORD program[4];
-            program[0] = Utilities::J_instruction(2, 2); // j 2(12)
-            program[1] = Utilities::R_instruction(0, 1, 1, 2, 0, 32); // add r1, r1, r2
-            program[2] = Utilities::I_instruction(4, 1, 2, 0xffff); // beq r1, -1(-4)
-            program[3] = Utilities::R_instruction(0, 1, 0, 1, 0, 32); // add r1, r0, r1
+            program[0] = Utilities::J_instruction(OP_J, 2); // j 2(12)
+            program[1] = Utilities::R_instruction(OP_SPECIAL, 1, 1, 2, 0, FUNC_ADD); // add r1, r1, r2
+            program[2] = Utilities::I_instruction(OP_BEQ, 1, 2, 0xffff); // beq r1, -1(-4)
+            program[3] = Utilities::R_instruction(OP_SPECIAL, 1, 0, 1, 0, FUNC_ADD); // add r1, r0, r1
 
             vm = new Emulator(128, program, 3);
             vm->set_register(1, 8);
@@ -50,9 +50,9 @@ TEST_CASE("Test Branch instructions", "[step][Branch]") {
 
     SECTION("bne") {
         WORD program[1];
-        program[0] = Utilities::I_instruction(5, 1, 2, 0b10); // bne r1, r2, 2(+8)
-        program[1] = Utilities::R_instruction(0, 1, 0, 1, 0, 32); // add r1, r0, r1
-        program[2] = Utilities::R_instruction(0, 1, 1, 2, 0, 32); // add r1, r1, r2
+        program[0] = Utilities::I_instruction(OP_BNE, 1, 2, 0b10); // bne r1, r2, 2(+8)
+        program[1] = Utilities::R_instruction(OP_SPECIAL, 1, 0, 1, 0, FUNC_ADD); // add r1, r0, r1
+        program[2] = Utilities::R_instruction(OP_SPECIAL, 1, 1, 2, 0, FUNC_ADD); // add r1, r1, r2
 
         SECTION("branches if registers are not equal") {
             vm = new Emulator(128, program, 3);
@@ -76,10 +76,10 @@ TEST_CASE("Test Branch instructions", "[step][Branch]") {
 
         SECTION("immediate is sign-extended") {
             WORD program[4];
-            program[0] = Utilities::J_instruction(2, 2); // j 2(12)
-            program[1] = Utilities::R_instruction(0, 1, 1, 2, 0, 32); // add r1, r1, r2
-            program[2] = Utilities::I_instruction(5, 1, 2, 0xffff); // bne r1, -1(-4)
-            program[3] = Utilities::R_instruction(0, 1, 0, 1, 0, 32); // add r1, r0, r1
+            program[0] = Utilities::J_instruction(OP_J, 2); // j 2(12)
+            program[1] = Utilities::R_instruction(OP_SPECIAL, 1, 1, 2, 0, FUNC_ADD); // add r1, r1, r2
+            program[2] = Utilities::I_instruction(OP_BNE, 1, 2, 0xffff); // bne r1, -1(-4)
+            program[3] = Utilities::R_instruction(OP_SPECIAL, 1, 0, 1, 0, FUNC_ADD); // add r1, r0, r1
 
             vm = new Emulator(128, program, 3);
             vm->set_register(1, -3);
@@ -94,9 +94,9 @@ TEST_CASE("Test Branch instructions", "[step][Branch]") {
 
     SECTION("blez") {
         WORD program[1];
-        program[0] = Utilities::I_instruction(6, 0, 1, 0b10); // blez r1, 2(+8)
-        program[1] = Utilities::R_instruction(0, 1, 0, 1, 0, 32); // add r1, r0, r1
-        program[2] = Utilities::R_instruction(0, 1, 1, 2, 0, 32); // add r1, r1, r2
+        program[0] = Utilities::I_instruction(OP_BLEZ, 0, 1, 0b10); // blez r1, 2(+8)
+        program[1] = Utilities::R_instruction(OP_SPECIAL, 1, 0, 1, 0, FUNC_ADD); // add r1, r0, r1
+        program[2] = Utilities::R_instruction(OP_SPECIAL, 1, 1, 2, 0, FUNC_ADD); // add r1, r1, r2
 
         SECTION("branches if register is equal to 0") {
             vm = new Emulator(128, program, 3);
@@ -130,10 +130,10 @@ TEST_CASE("Test Branch instructions", "[step][Branch]") {
 
         SECTION("immediate is sign-extended") {
             WORD program[4];
-            program[0] = Utilities::J_instruction(2, 2); // j 2(12)
-            program[1] = Utilities::R_instruction(0, 1, 1, 2, 0, 32); // add r1, r1, r2
-            program[2] = Utilities::I_instruction(6, 0, 1, 0xffff); // blez r1, -1(-4)
-            program[3] = Utilities::R_instruction(0, 1, 0, 1, 0, 32); // add r1, r0, r1
+            program[0] = Utilities::J_instruction(OP_J, 2); // j 2(12)
+            program[1] = Utilities::R_instruction(OP_SPECIAL, 1, 1, 2, 0, FUNC_ADD); // add r1, r1, r2
+            program[2] = Utilities::I_instruction(OP_BLEZ, 0, 1, 0xffff); // blez r1, -1(-4)
+            program[3] = Utilities::R_instruction(OP_SPECIAL, 1, 0, 1, 0, FUNC_ADD); // add r1, r0, r1
 
             vm = new Emulator(128, program, 3);
             vm->set_register(1, -3);
@@ -148,9 +148,9 @@ TEST_CASE("Test Branch instructions", "[step][Branch]") {
 
     SECTION("bgtz") {
         WORD program[1];
-        program[0] = Utilities::I_instruction(7, 0, 1, 0b10); // bgtz r1, 2(+8)
-        program[1] = Utilities::R_instruction(0, 1, 0, 1, 0, 32); // add r1, r0, r1
-        program[2] = Utilities::R_instruction(0, 1, 1, 2, 0, 32); // add r1, r1, r2
+        program[0] = Utilities::I_instruction(OP_BGTZ, 0, 1, 0b10); // bgtz r1, 2(+8)
+        program[1] = Utilities::R_instruction(OP_SPECIAL, 1, 0, 1, 0, FUNC_ADD); // add r1, r0, r1
+        program[2] = Utilities::R_instruction(OP_SPECIAL, 1, 1, 2, 0, FUNC_ADD); // add r1, r1, r2
 
         SECTION("does not branch if register is equal to 0") {
             vm = new Emulator(128, program, 3);
@@ -184,10 +184,10 @@ TEST_CASE("Test Branch instructions", "[step][Branch]") {
 
         SECTION("immediate is sign-extended") {
             WORD program[4];
-            program[0] = Utilities::J_instruction(2, 2); // j 2(12)
-            program[1] = Utilities::R_instruction(0, 1, 1, 2, 0, 32); // add r1, r1, r2
-            program[2] = Utilities::I_instruction(7, 0, 1, 0xffff); // blez r1, -1(-4)
-            program[3] = Utilities::R_instruction(0, 1, 0, 1, 0, 32); // add r1, r0, r1
+            program[0] = Utilities::J_instruction(OP_J, 2); // j 2(12)
+            program[1] = Utilities::R_instruction(OP_SPECIAL, 1, 1, 2, 0, FUNC_ADD); // add r1, r1, r2
+            program[2] = Utilities::I_instruction(OP_BGTZ, 0, 1, 0xffff); // blez r1, -1(-4)
+            program[3] = Utilities::R_instruction(OP_SPECIAL, 1, 0, 1, 0, FUNC_ADD); // add r1, r0, r1
 
             vm = new Emulator(128, program, 3);
             vm->set_register(1, 3);
@@ -0,0 +1,89 @@
+#include <stdexcept>
+
+#include "../include/catch.hpp"
+#include "../src/BranchPredictor.hpp"
+#include "../src/Utilities.hpp"
+#include "../src/Workloads.hpp"
+
+// A loop of 1000 iterations whose inner branch alternates between taken and not taken
+static WORD alternating[] = {
+    Utilities::I_instruction(OP_ADDIU, 1, 0, 1000),     // 0x00: addiu $1, $0, 1000
+    Utilities::I_instruction(OP_ANDI, 2, 1, 1),       // 0x04: andi $2, $1, 1
+    Utilities::I_instruction(OP_BEQ, 0, 2, 2),        // 0x08: beq $2, $0, 0x10
+    Utilities::R_instruction(OP_SPECIAL, 0, 0, 0, 0, FUNC_ADDU), // 0x0c: addu $0, $0, $0
+    Utilities::I_instruction(OP_ADDIU, 1, 1, -1),       // 0x10: addiu $1, $1, -1
+    Utilities::I_instruction(OP_BGTZ, 0, 1, -4),       // 0x14: bgtz $1, 0x04
+    Utilities::R_instruction(OP_SPECIAL, 0, 0, 0, 1, FUNC_BREAK), // 0x18: break 1
+};
+
+static DWORD alternating_mispredictions(DirectionPredictor& predictor) {
+    Emulator vm(0x100, alternating, sizeof(alternating) / sizeof(WORD));
+    BranchSimulator simulator(&predictor);
+    DWORD executed = 0;
+    REQUIRE(vm.run(100000, executed, simulator) == STEP_TRAP);
+    REQUIRE(simulator.branches_of(BRANCH_CONDITIONAL) == 2000);
+    return simulator.mispredictions_at(0x08);
+}
+
+TEST_CASE("Direction predictors on an alternating branch", "[BranchPredictor]") {
+    SECTION("bimodal cannot follow it") {
+        BimodalPredictor predictor;
+        REQUIRE(alternating_mispredictions(predictor) >= 500);
+    }
+
+    SECTION("gshare learns it from history") {
+        GsharePredictor predictor;
+        REQUIRE(alternating_mispredictions(predictor) < 20);
+    }
+
+    SECTION("tage learns it from history") {
+        TagePredictor predictor;
+        REQUIRE(alternating_mispredictions(predictor) < 20);
+    }
+}
+
+TEST_CASE("Invalid branch simulator sizes are rejected", "[BranchPredictor]") {
+    GsharePredictor predictor;
+    REQUIRE_NOTHROW(BranchSimulator(&predictor, 1, 1));
+    REQUIRE_THROWS_AS(BranchSimulator(&predictor, 0, 16), const std::invalid_argument&);
+    REQUIRE_THROWS_AS(BranchSimulator(&predictor, 384, 16), const std::invalid_argument&);
+    REQUIRE_THROWS_AS(BranchSimulator(&predictor, 512, 0), const std::invalid_argument&);
+}
+
+TEST_CASE("Return-address stack predicts fib returns", "[BranchPredictor][Workloads]") {
+    const Workload* fib = find_workload("fib");
+    Emulator* vm = fib->load();
+    GsharePredictor predictor;
+
+    SECTION("when it is deep enough") {
+        BranchSimulator simulator(&predictor, 512, 32);
+        DWORD executed = 0;
+        REQUIRE(vm->run(10000000, executed, simulator) == WORKLOAD_DONE);
+        REQUIRE(simulator.total_instructions() == executed);
+        REQUIRE(simulator.branches_of(BRANCH_CALL) == 2 * 4181 - 1);
+        REQUIRE(simulator.branches_of(BRANCH_RETURN) == 2 * 4181 - 1);
+        REQUIRE(simulator.mispredictions_of(BRANCH_RETURN) == 0);
+        REQUIRE(simulator.mpki() < 100);
+    }
+
+    SECTION("with overflows when it is not") {
+        BranchSimulator simulator(&predictor, 512, 4);
+        DWORD executed = 0;
+        REQUIRE(vm->run(10000000, executed, simulator) == WORKLOAD_DONE);
+        REQUIRE(simulator.mispredictions_of(BRANCH_RETURN) > 0);
+
+        FILE* file = tmpfile();
+        simulator.report(file, &fib->symbols, 3);
+        char buffer[4096] = {};
+        rewind(file);
+        fread(buffer, 1, sizeof(buffer) - 1, file);
+        fclose(file);
+        std::string report = buffer;
+        REQUIRE(report.find("Predictor: gshare") != std::string::npos);
+        REQUIRE(report.find("return") != std::string::npos);
+        REQUIRE(report.find("recurse+0x") != std::string::npos);
+    }
+
+    REQUIRE(fib->check(*vm));
+    delete vm;
+}
@@ -0,0 +1,156 @@
+#include <stdexcept>
+
+#include "../include/catch.hpp"
+#include "../src/Cache.hpp"
+#include "../src/Workloads.hpp"
+
+static CacheConfig tiny(int ways, Replacement replacement = REPLACE_LRU) {
+    CacheConfig config;
+    config.size = 256;
+    config.ways = ways;
+    config.line = 16;
+    config.replacement = replacement;
+    return config;
+}
+
+TEST_CASE("Cache hits, misses and conflicts", "[Cache]") {
+    SECTION("a line is filled once") {
+        Cache cache("L1", tiny(1));
+        REQUIRE(!cache.access(0x100, false));
+        REQUIRE(cache.access(0x104, false));
+        REQUIRE(cache.access(0x10f, true));
+        REQUIRE(!cache.access(0x110, false));
+        REQUIRE(cache.stats().reads == 3);
+        REQUIRE(cache.stats().read_misses == 2);
+        REQUIRE(cache.stats().write_misses == 0);
+    }
+
+    SECTION("direct-mapped addresses 256 bytes apart conflict") {
+        Cache cache("L1", tiny(1));
+        for(int i = 0; i < 4; i++) {
+            REQUIRE(!cache.access(0x000, false));
+            REQUIRE(!cache.access(0x100, false));
+        }
+        REQUIRE(cache.miss_rate() == 1.0);
+    }
+
+    SECTION("two ways hold both") {
+        Cache cache("L1", tiny(2));
+        cache.access(0x000, false);
+        cache.access(0x100, false);
+        REQUIRE(cache.access(0x000, false));
+        REQUIRE(cache.access(0x100, false));
+    }
+
+    SECTION("accesses spanning two lines touch both") {
+        Cache cache("L1", tiny(1));
+        REQUIRE(!cache.access(0x0e, 4, false));
+        REQUIRE(cache.stats().reads == 2);
+        REQUIRE(cache.access(0x10, false));
+    }
+}
+
+TEST_CASE("Cache replacement policies", "[Cache]") {
+    // Three lines into one two-way set, reusing the first before bringing in the third
+    auto run = [](Replacement replacement) {
+        Cache cache("L1", tiny(2, replacement));
+        cache.access(0x000, false);
+        cache.access(0x080, false);
+        cache.access(0x000, false);
+        cache.access(0x100, false);
+        return cache.access(0x000, false);
+    };
+
+    REQUIRE(run(REPLACE_LRU));
+    REQUIRE(!run(REPLACE_FIFO));
+}
+
+TEST_CASE("Cache write policies", "[Cache]") {
+    CacheConfig next_config = tiny(4);
+    next_config.size = 1024;
+
+    SECTION("write-back writes dirty lines on eviction") {
+        Cache l2("L2", next_config);
+        Cache l1("L1", tiny(1), &l2);
+        l1.access(0x000, true);
+        l1.access(0x004, true);
+        REQUIRE(l2.stats().writes == 0);
+        l1.access(0x100, false);
+        REQUIRE(l1.stats().writebacks == 1);
+        REQUIRE(l2.stats().writes == 1);
+        REQUIRE(l2.stats().reads == 2);
+
+        l1.access(0x100, true);
+        l1.flush();
+        REQUIRE(l1.stats().writebacks == 2);
+        REQUIRE(!l1.access(0x100, false));
+    }
+
+    SECTION("write-through without allocation goes straight to the next level") {
+        CacheConfig config = tiny(1);
+        config.write = WRITE_THROUGH;
+        config.write_allocate = false;
+        Cache l2("L2", next_config);
+        Cache l1("L1", config, &l2);
+
+        REQUIRE(!l1.access(0x000, true));
+        REQUIRE(!l1.access(0x000, false));
+        REQUIRE(l1.access(0x000, true));
+        REQUIRE(l2.stats().writes == 2);
+        REQUIRE(l1.stats().writebacks == 0);
+    }
+}
+
+TEST_CASE("Invalid cache geometries are rejected", "[Cache]") {
+    // 16 lines of 16 bytes
+    REQUIRE_NOTHROW(Cache("L1", tiny(16)));
+    REQUIRE_THROWS_AS(Cache("L1", tiny(0)), const std::invalid_argument&);
+    REQUIRE_THROWS_AS(Cache("L1", tiny(32)), const std::invalid_argument&);
+    // 16 lines do not split into 3 ways, and 8 ways make 2 sets
+    REQUIRE_THROWS_AS(Cache("L1", tiny(3)), const std::invalid_argument&);
+    REQUIRE_NOTHROW(Cache("L1", tiny(8)));
+
+    CacheConfig config = tiny(1);
+    config.line = 24;
+    REQUIRE_THROWS_AS(Cache("L1", config), const std::invalid_argument&);
+    config.line = 16;
+    config.size = 240;
+    config.ways = 5;
+    // 15 lines over 5 ways make 3 sets
+    REQUIRE_THROWS_AS(Cache("L1", config), const std::invalid_argument&);
+}
+
+TEST_CASE("Cache simulator on memcpy", "[Cache][Workloads]") {
+    const Workload* w = find_workload("memcpy");
+    Emulator* vm = w->load();
+    CacheSimulator simulator;
+    DWORD executed = 0;
+    REQUIRE(vm->run(1000000, executed, simulator) == WORKLOAD_DONE);
+    REQUIRE(w->check(*vm));
+    delete vm;
+
+    // 1 KiB set, read and written in 32-byte lines, all compulsory misses
+    REQUIRE(simulator.l1d().stats().reads == 256);
+    REQUIRE(simulator.l1d().stats().writes == 512);
+    REQUIRE(simulator.l1d().stats().read_misses + simulator.l1d().stats().write_misses == 3 * 1024 / 32);
+    REQUIRE(simulator.l1i().stats().reads == executed);
+    REQUIRE(simulator.l1i().stats().read_misses < 5);
+    // L2 lines are twice as big, and code and data do not share any
+    DWORD l2_code_misses = simulator.l2().stats().read_misses - 3 * 1024 / 64;
+    REQUIRE(l2_code_misses > 0);
+    REQUIRE(l2_code_misses <= simulator.l1i().stats().read_misses);
+    REQUIRE(simulator.l2().stats().writes == 0);
+
+    ADDRESS copy_load = w->symbols.find("memcpy");
+    REQUIRE(simulator.data_misses_at(copy_load) == 1024 / 32);
+
+    FILE* file = tmpfile();
+    simulator.report(file, &w->symbols, 2);
+    char buffer[4096] = {};
+    rewind(file);
+    fread(buffer, 1, sizeof(buffer) - 1, file);
+    fclose(file);
+    std::string report = buffer;
+    REQUIRE(report.find("16 KiB  4-way  32B lines") != std::string::npos);
+    REQUIRE(report.find("  memcpy\n") != std::string::npos);
+}
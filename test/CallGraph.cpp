@@ -0,0 +1,122 @@
+#include "../include/catch.hpp"
+#include "../src/CallGraph.hpp"
+#include "../src/Utilities.hpp"
+#include "../src/Workloads.hpp"
+
+static std::string contents(FILE* file) {
+    std::string text;
+    char buffer[4096];
+    size_t n;
+    rewind(file);
+    while((n = fread(buffer, 1, sizeof(buffer), file)) > 0) text.append(buffer, n);
+    fclose(file);
+    return text;
+}
+
+TEST_CASE("Call graph attributes recursive fib", "[CallGraph][Workloads]") {
+    const Workload* fib = find_workload("fib");
+    Emulator* vm = fib->load();
+    CallGraphProfiler profiler(&fib->symbols);
+
+    DWORD executed = 0;
+    REQUIRE(vm->run(10000000, executed, profiler) == WORKLOAD_DONE);
+    REQUIRE(fib->check(*vm));
+    profiler.finish();
+    delete vm;
+
+    REQUIRE(profiler.instructions() == executed);
+    // addiu, jal and break run outside fib
+    REQUIRE(profiler.exclusive("0x00000000") == 3);
+    REQUIRE(profiler.inclusive("0x00000000") == executed);
+    REQUIRE(profiler.exclusive("fib") == executed - 3);
+    REQUIRE(profiler.inclusive("fib") == executed - 3);
+
+    // fib(18) makes 2 * fib(19) - 1 calls
+    REQUIRE(profiler.call_count("0x00000000", "fib") == 1);
+    REQUIRE(profiler.call_count("fib", "fib") == 2 * 4181 - 2);
+
+    FILE* file = tmpfile();
+    profiler.write_callgrind(file);
+    std::string out = contents(file);
+    REQUIRE(out.find("events: Ir\nsummary: " + std::to_string(executed) + "\n") != std::string::npos);
+    REQUIRE(out.find("\nfn=(1) 0x00000000\n") != std::string::npos);
+    REQUIRE(out.find("cfn=(2) fib\ncalls=1 0x") != std::string::npos);
+    REQUIRE(out.find("\nfn=(2)\n") != std::string::npos);
+    // One edge per recursive call site
+    size_t first = out.find("cfn=(2)\ncalls=4180 0x");
+    REQUIRE(first != std::string::npos);
+    REQUIRE(out.find("cfn=(2)\ncalls=4180 0x", first + 1) != std::string::npos);
+}
+
+TEST_CASE("Call graph follows jalr and finish() closes open frames", "[CallGraph]") {
+    SymbolTable symbols;
+    symbols.add(0x10, "outer");
+    symbols.add(0x20, "inner");
+
+    WORD program[] = {
+        Utilities::I_instruction(OP_ADDIU, 8, 0, 0x20),     // 0x00: addiu $8, $0, 0x20
+        Utilities::J_instruction(OP_JAL, 0x10 / 4),       // 0x04: jal outer
+        Utilities::R_instruction(OP_SPECIAL, 0, 0, 0, 2, FUNC_BREAK), // 0x08: break 2
+        0,
+        Utilities::R_instruction(OP_SPECIAL, 9, 31, 0, 0, FUNC_ADDU), // 0x10: addu $9, $31, $0
+        Utilities::R_instruction(OP_SPECIAL, 31, 8, 0, 0, FUNC_JALR),  // 0x14: jalr $8
+        Utilities::R_instruction(OP_SPECIAL, 0, 9, 0, 0, FUNC_JR),   // 0x18: jr $9, back to the root without jr $31
+        0,
+        0,                                            // 0x20: nop
+        Utilities::R_instruction(OP_SPECIAL, 0, 31, 0, 0, FUNC_JR),  // 0x24: jr $31
+    };
+
+    Emulator vm(0x100, program, sizeof(program) / sizeof(WORD));
+    CallGraphProfiler profiler(&symbols);
+    DWORD executed = 0;
+    REQUIRE(vm.run(100, executed, profiler) == 2);
+    REQUIRE(executed == 8);
+
+    // outer is still open on the shadow stack when the program stops
+    profiler.finish();
+    REQUIRE(profiler.call_count("outer", "inner") == 1);
+    REQUIRE(profiler.exclusive("inner") == 2);
+    REQUIRE(profiler.inclusive("inner") == 2);
+    REQUIRE(profiler.exclusive("0x00000000") == 2);
+    REQUIRE(profiler.exclusive("outer") == 4);
+    REQUIRE(profiler.inclusive("outer") == 6);
+    REQUIRE(profiler.inclusive("0x00000000") == 8);
+}
+
+TEST_CASE("Call graph unwinds frames whose return was skipped", "[CallGraph]") {
+    SymbolTable symbols;
+    symbols.add(0x10, "outer");
+    symbols.add(0x20, "inner");
+
+    WORD program[] = {
+        Utilities::J_instruction(OP_JAL, 0x10 / 4),                    // 0x00: jal outer
+        Utilities::R_instruction(OP_SPECIAL, 0, 0, 0, 2, FUNC_BREAK),  // 0x04: break 2
+        0,
+        0,
+        Utilities::R_instruction(OP_SPECIAL, 9, 31, 0, 0, FUNC_ADDU),  // 0x10: addu $9, $31, $0
+        Utilities::J_instruction(OP_JAL, 0x20 / 4),                    // 0x14: jal inner
+        Utilities::R_instruction(OP_SPECIAL, 0, 0, 0, 3, FUNC_BREAK),  // 0x18: break 3, never reached
+        0,
+        Utilities::R_instruction(OP_SPECIAL, 31, 9, 0, 0, FUNC_ADDU),  // 0x20: addu $31, $9, $0
+        Utilities::R_instruction(OP_SPECIAL, 0, 31, 0, 0, FUNC_JR),    // 0x24: jr $31, straight to outer's caller
+    };
+
+    Emulator vm(0x100, program, sizeof(program) / sizeof(WORD));
+    CallGraphProfiler profiler(&symbols);
+    DWORD executed = 0;
+    REQUIRE(vm.run(100, executed, profiler) == 2);
+    REQUIRE(executed == 6);
+
+    // The jr $31 in inner matches outer's frame, so both are closed before finish()
+    REQUIRE(profiler.exclusive("inner") == 2);
+    REQUIRE(profiler.inclusive("inner") == 2);
+    REQUIRE(profiler.exclusive("outer") == 2);
+    REQUIRE(profiler.inclusive("outer") == 4);
+    REQUIRE(profiler.call_count("0x00000000", "outer") == 1);
+    REQUIRE(profiler.call_count("outer", "inner") == 1);
+    REQUIRE(profiler.exclusive("0x00000000") == 2);
+    REQUIRE(profiler.inclusive("0x00000000") == 0);
+
+    profiler.finish();
+    REQUIRE(profiler.inclusive("0x00000000") == 6);
+}
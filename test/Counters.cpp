@@ -0,0 +1,76 @@
+#include <cstring>
+
+#include "../include/catch.hpp"
+#include "../src/Utilities.hpp"
+#include "../src/Counters.hpp"
+
+// Counting whether or not the build defines EMU_COUNTERS
+typedef BasicEmulator<EmulatorPolicy<EMU_DEFAULT_FEATURES | EMU_COUNTING>> CountingEmulator;
+
+TEST_CASE("Executed opcodes are counted", "[Counters][step]") {
+    WORD program[7];
+    program[0] = Utilities::I_instruction(OP_ADDIU, 1, 1, 1); // addiu r1, r1, 1
+    program[1] = Utilities::I_instruction(OP_SW, 1, 0, 64); // sw r1, 64(r0)
+    program[2] = Utilities::I_instruction(OP_LBU, 3, 0, 64); // lbu r3, 64(r0)
+    program[3] = Utilities::I_instruction(OP_BNE, 2, 1, -3); // bne r1, r2, -3(-12)
+    program[4] = Utilities::R_instruction(OP_SPECIAL, 4, 1, 2, 0, FUNC_ADDU); // addu r4, r1, r2
+    program[5] = Utilities::I_instruction(OP_LH, 5, 0, 1); // lh r5, 1(r0)
+    program[6] = Utilities::R_instruction(OP_SPECIAL, 1, 0, 0, 0, FUNC_BREAK); // break 32
+
+    CountingEmulator* vm = new CountingEmulator(128, program, 7);
+    vm->set_register(2, 3);
+
+    for(int i = 0; i < 13; i++) {
+        REQUIRE(vm->step() == 0);
+    }
+    REQUIRE(vm->step() == STEP_TRAP);
+    vm->state().PC = 24;
+    REQUIRE(vm->step() == 32);
+    vm->state().PC = 128;
+    REQUIRE(vm->step() == STEP_FAULT);
+
+    Counters& counters = vm->counters();
+
+    SECTION("by opcode and func") {
+        REQUIRE(counters.opcode[9] == 3);
+        REQUIRE(counters.opcode[43] == 3);
+        REQUIRE(counters.opcode[36] == 3);
+        REQUIRE(counters.opcode[33] == 1);
+        REQUIRE(counters.func[33] == 1);
+        REQUIRE(counters.func[13] == 1);
+        REQUIRE(total_instructions(counters) == 15);
+    }
+
+    SECTION("branch outcomes") {
+        REQUIRE(counters.branch[5][1] == 2);
+        REQUIRE(counters.branch[5][0] == 1);
+    }
+
+    SECTION("traps and breaks") {
+        REQUIRE(counters.traps == 1);
+        REQUIRE(counters.breaks == 1);
+        REQUIRE(counters.syscalls == 0);
+        REQUIRE(counters.faults == 1);
+    }
+
+    SECTION("report") {
+        FILE* file = tmpfile();
+        print_counters(counters, file);
+        rewind(file);
+
+        char buffer[4096] = {};
+        fread(buffer, 1, sizeof(buffer) - 1, file);
+        fclose(file);
+
+        REQUIRE(strstr(buffer, "Instructions executed: 15") != NULL);
+        REQUIRE(strstr(buffer, "bne        taken            2 ( 66.67%)  not taken            1") != NULL);
+        REQUIRE(strstr(buffer, "Traps: 1  Breaks: 1  Syscalls: 0  Faults: 1") != NULL);
+        REQUIRE(strstr(buffer, "Loads:             4  byte  75.00%  half  25.00%  word   0.00%") != NULL);
+        REQUIRE(strstr(buffer, "Stores:            3  byte   0.00%  half   0.00%  word 100.00%") != NULL);
+    }
+
+    SECTION("reset") {
+        vm->reset_counters();
+        REQUIRE(total_instructions(vm->counters()) == 0);
+    }
+}
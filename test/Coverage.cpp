@@ -0,0 +1,107 @@
+#include <cstring>
+#include <vector>
+
+#include "../include/catch.hpp"
+#include "../src/Coverage.hpp"
+#include "../src/Utilities.hpp"
+#include "../src/Workloads.hpp"
+
+// if(input == 7) $2 = 1 else $2 = 2, with the input at 0x40
+static WORD branchy[] = {
+    Utilities::I_instruction(OP_LW, 1, 0, 0x40),    // 0x00: lw $1, 0x40($0)
+    Utilities::I_instruction(OP_ADDIU, 3, 0, 7),        // 0x04: addiu $3, $0, 7
+    Utilities::I_instruction(OP_BNE, 3, 1, 3),        // 0x08: bne $1, $3, 0x14
+    Utilities::I_instruction(OP_ADDIU, 2, 0, 1),        // 0x0c: addiu $2, $0, 1
+    Utilities::J_instruction(OP_J, 6),              // 0x10: j 0x18
+    Utilities::I_instruction(OP_ADDIU, 2, 0, 2),        // 0x14: addiu $2, $0, 2
+    Utilities::R_instruction(OP_SPECIAL, 0, 0, 0, 1, FUNC_BREAK), // 0x18: break 1
+};
+
+static void run_input(EdgeCoverage& coverage, WORD input) {
+    Emulator vm(0x100, branchy, sizeof(branchy) / sizeof(WORD));
+    vm.store_word(input, 0x40);
+    DWORD executed = 0;
+    coverage.reset();
+    REQUIRE(vm.run(100, executed, coverage) == STEP_TRAP);
+    REQUIRE(vm.get_register(2) == (input == 7 ? 1u : 2u));
+}
+
+TEST_CASE("Edge coverage finds new paths", "[Coverage]") {
+    EdgeCoverage coverage;
+    REQUIRE(coverage.valid());
+    std::vector<BYTE> virgin(COVERAGE_MAP_SIZE, 0xff);
+
+    run_input(coverage, 1);
+    REQUIRE(coverage.edges() == 1);
+    REQUIRE(coverage.merge_into(virgin.data()));
+
+    // Same path, nothing new
+    run_input(coverage, 2);
+    REQUIRE(!coverage.merge_into(virgin.data()));
+
+    // The other side of the branch, then the jump over the else
+    run_input(coverage, 7);
+    REQUIRE(coverage.edges() == 2);
+    REQUIRE(coverage.merge_into(virgin.data()));
+    REQUIRE(!coverage.merge_into(virgin.data()));
+}
+
+TEST_CASE("Edge coverage buckets hit counts", "[Coverage][Workloads]") {
+    const Workload* w = find_workload("memcpy");
+    EdgeCoverage coverage;
+    std::vector<BYTE> virgin(COVERAGE_MAP_SIZE, 0xff);
+
+    Emulator* vm = w->load();
+    DWORD executed = 0;
+    REQUIRE(vm->run(1000000, executed, coverage) == WORKLOAD_DONE);
+    delete vm;
+
+    // Each loop enters its body from outside once, goes around it 254 times, and exits once
+    size_t hot = 0;
+    for(size_t i = 0; i < COVERAGE_MAP_SIZE; i++) hot += coverage.map()[i] == 254;
+    REQUIRE(hot == 2);
+    REQUIRE(coverage.edges() == 6);
+    REQUIRE(coverage.merge_into(virgin.data()));
+
+    // A count moving to a new bucket is new coverage, any other count in the same one is not
+    coverage.reset();
+    for(BYTE hits : {1, 2, 3, 4}) {
+        coverage.map()[42] = hits;
+        REQUIRE(coverage.merge_into(virgin.data()));
+    }
+    for(BYTE hits : {1, 2, 3, 5, 7}) {
+        coverage.map()[42] = hits;
+        REQUIRE(!coverage.merge_into(virgin.data()));
+    }
+}
+
+TEST_CASE("Edge coverage in shared memory", "[Coverage]") {
+    int segment = EdgeCoverage::create_segment();
+    if(segment < 0) {
+        WARN("System V shared memory is unavailable");
+        return;
+    }
+
+    EdgeCoverage writer(segment);
+    EdgeCoverage reader(segment);
+    REQUIRE(writer.valid());
+    REQUIRE(reader.valid());
+    EdgeCoverage::remove_segment(segment);
+
+    run_input(writer, 7);
+    REQUIRE(reader.edges() == 2);
+    REQUIRE(memcmp(reader.map(), writer.map(), COVERAGE_MAP_SIZE) == 0);
+}
+
+TEST_CASE("Edge coverage runs stop cleanly on wild jumps", "[Coverage][step]") {
+    WORD program[1];
+    program[0] = Utilities::R_instruction(OP_SPECIAL, 0, 1, 0, 0, FUNC_JR); // jr r1
+
+    Emulator vm(64, program, 1);
+    vm.set_register(1, 0x100000);
+    EdgeCoverage coverage;
+    DWORD executed = 0;
+    REQUIRE(vm.run(100, executed, coverage) == STEP_FAULT);
+    REQUIRE(executed == 2);
+    REQUIRE(coverage.edges() == 1);
+}
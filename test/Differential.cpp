@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "../include/catch.hpp"
+#include "../src/Differential.hpp"
+#include "../src/Generator.hpp"
+#include "../src/Utilities.hpp"
+#include "../src/Workloads.hpp"
+
+// Flips a bit of a register or a memory byte once `corrupt_at` instructions have run; the byte is
+// either stored through the emulator or written behind its dirty tracking
+class FaultyBackend : public InterpreterBackend {
+    DWORD count;
+    DWORD corrupt_at;
+    int reg;
+    ADDRESS address;
+    bool flagged;
+
+    public:
+    FaultyBackend(Emulator* emulator, DWORD corrupt_at, int reg, ADDRESS address = 0, bool flagged = true)
+        : InterpreterBackend(emulator), count(0), corrupt_at(corrupt_at), reg(reg), address(address),
+          flagged(flagged) {}
+    const char* name() { return "faulty"; }
+
+    int run_block(DWORD budget, DWORD& executed) {
+        if(count < corrupt_at) budget = std::min(budget, corrupt_at - count);
+        DWORD n = 0;
+        int status = InterpreterBackend::run_block(budget, n);
+        count += n;
+        executed += n;
+        if(n > 0 && count == corrupt_at) {
+            if(reg > 0) emulator->state().gpr[reg] ^= 1;
+            else if(flagged) emulator->store_byte(emulator->load_byte(address) ^ 1, address);
+            else emulator->get_memory()[address] ^= 1;
+        }
+        return status;
+    }
+};
+
+TEST_CASE("Workloads agree between the interpreter and the tracing path", "[Differential][system-tests]") {
+    for(const Workload& w : workload_corpus()) {
+        SECTION(w.name) {
+            LockstepChecker checker([&] { return new InterpreterBackend(w.load()); },
+                                    [&] { return new TracingBackend(w.load()); });
+            DiffResult result = checker.run(10000000);
+            REQUIRE(!result.diverged);
+            REQUIRE(result.reference_status == WORKLOAD_DONE);
+            REQUIRE(result.candidate_status == WORKLOAD_DONE);
+            REQUIRE(result.executed > 1000);
+        }
+    }
+}
+
+TEST_CASE("Random programs agree", "[Differential]") {
+    GeneratorConfig config;
+    unsigned weights[GEN_CLASSES] = {4, 4, 2, 2, 3, 3, 2, 1, 1};
+    memcpy(config.weights, weights, sizeof(weights));
+    config.length = 500;
+
+    ProgramGenerator generator(config, 1);
+    for(int n = 0; n < 20; n++) {
+        GeneratedProgram program = generator.generate();
+        LockstepChecker checker([&] { return new InterpreterBackend(program.load()); },
+                                [&] { return new TracingBackend(program.load()); }, 4);
+        DiffResult result = checker.run(program.max_instructions);
+        REQUIRE(!result.diverged);
+        REQUIRE(result.reference_status == WORKLOAD_DONE);
+    }
+}
+
+// Every row of the ISA tables, between a pair of operands, then a break. The per-instruction test
+// cases build one-instruction programs like these by hand; this runs the same instructions in
+// lockstep over operands that hit the carries, sign bits and shift edges they test.
+TEST_CASE("Every instruction agrees on edge operands", "[Differential][Isa]") {
+    const WORD values[] = {0, 1, 5, 0xffffffff, 0x7fffffff, 0x80000000, 0x12345678, 0x40};
+    const WORD done = Utilities::R_instruction(OP_SPECIAL, 0, 0, 0, 0, FUNC_BREAK) | WORKLOAD_DONE << 6;
+
+    for(int table = 0; table < 2; table++) {
+        for(int number = 0; number < 64; number++) {
+            const IsaEntry& entry = table == 0 ? isa_opcodes[number] : isa_funcs[number];
+            if(entry.name == NULL) continue;
+
+            // $3 = $1 op $2, with a shift of 5 and an offset of 8 from $1; jumps stay in memory
+            WORD word = table == 1 ? Utilities::R_instruction(OP_SPECIAL, 3, 1, 2, 5, number)
+                        : entry.kind == KIND_JUMP ? Utilities::J_instruction(number, 2)
+                                                  : Utilities::I_instruction(number, 2, 1, 8);
+            WORD program[3] = {word, done, done};
+
+            for(WORD a : values) {
+                for(WORD b : values) {
+                    auto load = [&] {
+                        Emulator* emulator = new Emulator(256, program, 3);
+                        emulator->set_register(1, a);
+                        emulator->set_register(2, b);
+                        return emulator;
+                    };
+                    LockstepChecker checker([&] { return new InterpreterBackend(load()); },
+                                            [&] { return new TracingBackend(load()); }, 1);
+                    DiffResult result = checker.run(8);
+                    INFO(entry.name << " with $1 = " << a << ", $2 = " << b);
+                    REQUIRE(!result.diverged);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Divergence is bisected to the first differing instruction", "[Differential]") {
+    const Workload* w = find_workload("fib");
+    REQUIRE(w != NULL);
+
+    SECTION("in a register") {
+        LockstepChecker checker([&] { return new InterpreterBackend(w->load()); },
+                                [&] { return new FaultyBackend(w->load(), 1234, 26); });
+        DiffResult result = checker.run(10000000);
+        REQUIRE(result.diverged);
+        REQUIRE(result.executed == 1234);
+
+        // The PC of instruction 1234 on the reference
+        InterpreterBackend replay(w->load());
+        DWORD executed = 0;
+        run_exactly(replay, 1233, executed);
+        REQUIRE(result.pc == replay.state().PC);
+
+        FILE* out = tmpfile();
+        checker.report(out);
+        rewind(out);
+        char buffer[4096] = {};
+        fread(buffer, 1, sizeof(buffer) - 1, out);
+        fclose(out);
+        std::string text = buffer;
+        REQUIRE(text.find("diverge at instruction 1234") != std::string::npos);
+        REQUIRE(text.find("*  $26") != std::string::npos);
+        REQUIRE(text.find("*  $25") == std::string::npos);
+    }
+
+    SECTION("in memory, seen only by the periodic hash") {
+        LockstepChecker checker([&] { return new InterpreterBackend(w->load()); },
+                                [&] { return new FaultyBackend(w->load(), 777, 0, 0x8000); });
+        DiffResult result = checker.run(10000000);
+        REQUIRE(result.diverged);
+        REQUIRE(result.executed == 777);
+        REQUIRE(result.reference_status == result.candidate_status);
+    }
+}
+
+TEST_CASE("Stores a backend does not flag are caught once it stops", "[Differential]") {
+    const Workload* w = find_workload("fib");
+    REQUIRE(w != NULL);
+
+    LockstepChecker checker([&] { return new InterpreterBackend(w->load()); },
+                            [&] { return new FaultyBackend(w->load(), 777, 0, 0x8000, false); });
+    DiffResult result = checker.run(10000000);
+    REQUIRE(result.diverged);
+    REQUIRE(result.executed == 777);
+}
+
+TEST_CASE("Blocks starting outside of memory fault", "[Differential]") {
+    WORD program[1] = {Utilities::R_instruction(OP_SPECIAL, 0, 0, 0, 0, FUNC_ADDU)};
+    InterpreterBackend backend(new Emulator(64, program, 1));
+    backend.state().PC = 64;
+
+    DWORD executed = 0;
+    REQUIRE(backend.run_block(10, executed) == STEP_FAULT);
+    REQUIRE(executed == 1);
+    REQUIRE(backend.state().PC == 64);
+}
@@ -0,0 +1,87 @@
+#include <cstring>
+#include <string>
+
+#include "../include/catch.hpp"
+#include "../src/Assembler.hpp"
+#include "../src/Disassembler.hpp"
+#include "../src/Generator.hpp"
+#include "../src/Utilities.hpp"
+
+static std::string text(WORD word, ADDRESS pc = 0, const SymbolTable* symbols = NULL, int flags = 0) {
+    char buffer[DISASM_BUFFER];
+    size_t length = disassemble(word, pc, buffer, sizeof(buffer), symbols, flags);
+    REQUIRE(length == strlen(buffer));
+    return buffer;
+}
+
+TEST_CASE("Disassembler formats each instruction format", "[Disassembler]") {
+    REQUIRE(text(0) == "nop");
+    REQUIRE(text(0x3c01aabb) == "lui $at, 0xaabb");
+    REQUIRE(text(0x3429ccdd) == "ori $t1, $at, 0xccdd");
+    REQUIRE(text(0xafa90004) == "sw $t1, 4($sp)");
+    REQUIRE(text(Utilities::I_instruction(OP_LB, 12, 29, -8)) == "lb $t4, -8($sp)");
+    REQUIRE(text(Utilities::I_instruction(OP_ADDIU, 2, 0, -5)) == "addiu $v0, $zero, -5");
+    REQUIRE(text(Utilities::R_instruction(OP_SPECIAL, 3, 0, 4, 5, FUNC_SLL)) == "sll $v1, $a0, 5");
+    REQUIRE(text(Utilities::R_instruction(OP_SPECIAL, 3, 5, 4, 0, FUNC_SRLV)) == "srlv $v1, $a0, $a1");
+    REQUIRE(text(Utilities::R_instruction(OP_SPECIAL, 8, 9, 10, 0, FUNC_ADDU)) == "addu $t0, $t1, $t2");
+    REQUIRE(text(Utilities::R_instruction(OP_SPECIAL, 8, 9, 10, 0, FUNC_ADDU), 0, NULL, DISASM_NUMERIC_REGISTERS) == "addu $8, $9, $10");
+    REQUIRE(text(Utilities::R_instruction(OP_SPECIAL, 0, 4, 5, 0, FUNC_DIV)) == "div $a0, $a1");
+    REQUIRE(text(Utilities::R_instruction(OP_SPECIAL, 31, 31, 0, 0, FUNC_JALR)) == "jalr $ra");
+    REQUIRE(text(Utilities::R_instruction(OP_SPECIAL, 16, 0, 0, 0, FUNC_MFLO)) == "mflo $s0");
+    REQUIRE(text(Utilities::R_instruction(OP_SPECIAL, 0, 0, 0, 0, FUNC_SYSCALL)) == "syscall");
+    REQUIRE(text(Utilities::R_instruction(OP_SPECIAL, 0, 0, 0, 0, FUNC_BREAK)) == "break");
+    REQUIRE(text(Utilities::R_instruction(OP_SPECIAL, 31, 0, 0, 31, FUNC_BREAK)) == "break 0x3ff");
+
+    // Targets as step() computes them: no delay slots, jumps keep the top bits of pc
+    REQUIRE(text(Utilities::I_instruction(OP_BNE, 2, 1, -1), 0x100) == "bne $at, $v0, 0xfc");
+    REQUIRE(text(Utilities::I_instruction(OP_BGTZ, 0, 5, 3), 0x100) == "bgtz $a1, 0x10c");
+    REQUIRE(text(Utilities::J_instruction(OP_JAL, 0x40), 0x10000000) == "jal 0x10000100");
+
+    REQUIRE(text(0xfc000000) == ".word 0xfc000000");
+    REQUIRE(text(Utilities::R_instruction(0, 1, 2, 3, 0, 63)) == ".word 0x43083f");
+}
+
+TEST_CASE("Disassembler names targets and stays in its buffer", "[Disassembler]") {
+    SymbolTable symbols;
+    symbols.add(0x40, "loop");
+    symbols.add(0x80, "a_rather_long_function_name");
+
+    WORD branch = Utilities::I_instruction(OP_BEQ, 0, 0, 1);
+    REQUIRE(text(branch, 0x3c, &symbols) == "beq $zero, $zero, 0x40  # loop");
+    REQUIRE(text(branch, 0x48, &symbols) == "beq $zero, $zero, 0x4c  # loop+0xc");
+    REQUIRE(text(branch, 0x0, &symbols) == "beq $zero, $zero, 0x4");
+    REQUIRE(text(Utilities::J_instruction(OP_J, 0x21), 0, &symbols) == "j 0x84  # a_rather_long_function_name+0x4");
+
+    char small[12];
+    memset(small, 'x', sizeof(small));
+    REQUIRE(disassemble(branch, 0x3c, small, 10, &symbols) == 9);
+    REQUIRE(std::string(small) == "beq $zero");
+    REQUIRE(small[10] == 'x');
+    REQUIRE(disassemble(branch, 0, small, 0) == 0);
+    REQUIRE(small[0] == 'b');
+}
+
+TEST_CASE("Disassembled programs assemble back to the same words", "[Disassembler]") {
+    GeneratorConfig config;
+    unsigned weights[GEN_CLASSES] = {4, 4, 2, 2, 3, 3, 2, 1, 1};
+    memcpy(config.weights, weights, sizeof(weights));
+    config.length = 500;
+    config.trapping = true;
+
+    char buffer[DISASM_BUFFER];
+    for(WORD seed = 1; seed <= 20; seed++) {
+        GeneratedProgram program = ProgramGenerator(config, seed).generate();
+        std::string source;
+        for(size_t i = 0; i < program.code.size(); i++) {
+            disassemble(program.code[i], i * 4, buffer, sizeof(buffer), NULL, seed % 2 ? DISASM_NUMERIC_REGISTERS : 0);
+            source += buffer;
+            source += '\n';
+        }
+
+        Assembler assembler;
+        REQUIRE(assembler.assemble(source));
+        const std::vector<BYTE>& image = assembler.image();
+        REQUIRE(image.size() == program.code.size() * 4);
+        REQUIRE(memcmp(image.data(), program.code.data(), image.size()) == 0);
+    }
+}
@@ -83,3 +83,34 @@ TEST_CASE("Memory operations are functioning properly", "[load_byte][store_byte]
         REQUIRE(vm->load_word(0) == 0x01020304);
     }
 }
+
+TEST_CASE("CPU state is kept inline at fixed offsets", "[Emulator][state]") {
+    Emulator* vm = new Emulator(128);
+    CPUState& cpu = vm->state();
+
+    SECTION("CPU state is cache-line aligned") {
+        REQUIRE((size_t)&cpu % 64 == 0);
+    }
+
+    SECTION("Registers are read straight from the state") {
+        cpu.gpr[7] = 42;
+        REQUIRE(vm->get_register(7) == 42);
+    }
+
+    SECTION("Writes to register 0 are discarded") {
+        vm->set_register(0, 5);
+        REQUIRE(cpu.gpr[0] == 0);
+        REQUIRE(cpu.gpr[DISCARD_SLOT] == 5);
+    }
+
+    SECTION("Traps are recorded in the status word") {
+        WORD program[2];
+        program[0] = Utilities::I_instruction(OP_LW, 1, 0, 2); // lw r1, 2(r0)
+        program[1] = Utilities::R_instruction(OP_SPECIAL, 0, 0, 0, 0, FUNC_SLL); // sll r0, r0, 0
+        vm = new Emulator(128, program, 2);
+
+        REQUIRE(vm->step() == STEP_TRAP);
+        REQUIRE(vm->state().status == STEP_TRAP);
+        REQUIRE(vm->state().PC == 0);
+    }
+}
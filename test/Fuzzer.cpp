@@ -0,0 +1,151 @@
+#include <cstring>
+
+#include "../include/catch.hpp"
+#include "../src/Asm.hpp"
+#include "../src/Fuzzer.hpp"
+#include "../src/Utilities.hpp"
+#include "../src/Workloads.hpp"
+
+// Reads the input at 0x1000: "L..." hangs, "FZ!" stores out of memory, anything else exits.
+// The first byte is always stored at 0x3000.
+static constexpr auto target_program = assemble<[](Asm& a) {
+    a.addiu(5, 0, 0x1000);     // 0x00
+    a.addiu(6, 0, 'L');        // 0x04: snapshot
+    a.lbu(7, 0, 5);            // 0x08
+    a.beq(7, 6, "hang");       // 0x0c
+    a.sw(7, 0x3000, 0);        // 0x10
+    a.addiu(6, 0, 'F');        // 0x14
+    a.bne(7, 6, "exit");       // 0x18
+    a.addiu(6, 0, 'Z');        // 0x1c
+    a.lbu(7, 1, 5);            // 0x20
+    a.bne(7, 6, "exit");       // 0x24
+    a.addiu(6, 0, '!');        // 0x28
+    a.lbu(7, 2, 5);            // 0x2c
+    a.bne(7, 6, "exit");       // 0x30
+    a.lui(8, 0x7fff);          // 0x34
+    a.sw(0, 0, 8);             // 0x38: out of memory
+    a.brk(1);                  // 0x3c
+    a.label("exit");
+    a.brk(WORKLOAD_DONE);      // 0x40
+    a.label("hang");
+    a.b("hang");               // 0x44
+}>();
+
+static Emulator* load_target() {
+    return new Emulator(0x4000, target_program.data(), target_program.size());
+}
+
+static FuzzConfig target_config() {
+    FuzzConfig config;
+    config.snapshot_pc = 0x04;
+    config.input_address = 0x1000;
+    config.input_capacity = 16;
+    config.length_register = 4;
+    config.budget = 1000;
+    return config;
+}
+
+TEST_CASE("Emulator faults on accesses outside of memory", "[Fuzzer][Emulator]") {
+    WORD program[] = {
+        Utilities::I_instruction(OP_ADDIU, 1, 0, 0xfe),    // addiu $1, $0, 0xfe
+        Utilities::I_instruction(OP_LBU, 2, 1, 1),      // lbu $2, 1($1)
+        Utilities::I_instruction(OP_LBU, 2, 1, 2),      // lbu $2, 2($1)
+    };
+    Emulator vm(0x100, program, 3);
+    REQUIRE(vm.step() == STEP_OK);
+    REQUIRE(vm.step() == STEP_OK);
+    REQUIRE(vm.step() == STEP_FAULT);
+    REQUIRE(vm.state().PC == 8);
+
+    SECTION("and on fetches") {
+        vm.state().PC = 0x100;
+        REQUIRE(vm.step() == STEP_FAULT);
+        vm.state().PC = 0xfffffffc;
+        REQUIRE(vm.step() == STEP_FAULT);
+    }
+}
+
+TEST_CASE("Division by zero leaves HI and LO alone", "[Emulator]") {
+    WORD program[] = {
+        Utilities::I_instruction(OP_ADDIU, 1, 0, 7),        // addiu $1, $0, 7
+        Utilities::R_instruction(OP_SPECIAL, 0, 1, 0, 0, FUNC_DIV), // div $1, $0
+        Utilities::R_instruction(OP_SPECIAL, 0, 1, 0, 0, FUNC_DIVU), // divu $1, $0
+        Utilities::I_instruction(OP_LUI, 2, 0, 0x8000),  // lui $2, 0x8000
+        Utilities::I_instruction(OP_ADDIU, 3, 0, -1),       // addiu $3, $0, -1
+        Utilities::R_instruction(OP_SPECIAL, 0, 2, 3, 0, FUNC_DIV), // div $2, $3
+    };
+    Emulator vm(0x100, program, 6);
+    vm.state().HI = 11;
+    vm.state().LO = 12;
+    for(int i = 0; i < 3; i++) REQUIRE(vm.step() == STEP_OK);
+    REQUIRE(vm.state().HI == 11);
+    REQUIRE(vm.state().LO == 12);
+
+    for(int i = 0; i < 3; i++) REQUIRE(vm.step() == STEP_OK);
+    REQUIRE(vm.state().LO == 0x80000000);
+    REQUIRE(vm.state().HI == 0);
+}
+
+TEST_CASE("Fuzz target classifies and restores", "[Fuzzer]") {
+    FuzzTarget target(load_target, target_config());
+    REQUIRE(target.ready());
+
+    std::vector<BYTE> before(target.emulator_state().get_memory(), target.emulator_state().get_memory() + 0x4000);
+    auto run = [&](const char* input) {
+        FuzzResult result = target.execute((const BYTE*)input, strlen(input));
+        // Back to the snapshot
+        REQUIRE(memcmp(before.data(), target.emulator_state().get_memory(), before.size()) == 0);
+        REQUIRE(target.emulator_state().state().PC == 0x04);
+        return result;
+    };
+
+    FuzzResult result = run("abc");
+    REQUIRE(result.outcome == FUZZ_EXIT);
+    REQUIRE(result.status == WORKLOAD_DONE);
+    // The input page and the page stored to
+    REQUIRE(target.pages_restored() == 2);
+
+    result = run("FZ!");
+    REQUIRE(result.outcome == FUZZ_FAULT);
+    REQUIRE(result.pc == 0x38);
+
+    result = run("L");
+    REQUIRE(result.outcome == FUZZ_TIMEOUT);
+    REQUIRE(result.executed == 1000);
+    REQUIRE(target.pages_restored() == 2 + 2 + 1);
+
+    result = run("FZ");
+    REQUIRE(result.outcome == FUZZ_EXIT);
+}
+
+TEST_CASE("Fuzz target needs to reach its snapshot", "[Fuzzer]") {
+    FuzzConfig config = target_config();
+    config.snapshot_pc = 0x400;
+    config.snapshot_budget = 100;
+    FuzzTarget target(load_target, config);
+    REQUIRE(!target.ready());
+}
+
+TEST_CASE("Fuzzer finds the magic input with coverage", "[Fuzzer]") {
+    Fuzzer fuzzer(load_target, target_config());
+    fuzzer.add_seed({'a', 'b', 'c'});
+    FuzzStats stats = fuzzer.run(4, 100000);
+
+    REQUIRE(stats.executions == 100000);
+    DWORD total = 0;
+    for(int o = 0; o < FUZZ_OUTCOMES; o++) total += stats.outcomes[o];
+    REQUIRE(total == stats.executions);
+
+    bool fault = false, timeout = false;
+    for(const FuzzCrash& crash : fuzzer.crashes()) {
+        if(crash.result.outcome == FUZZ_FAULT) {
+            fault = true;
+            REQUIRE(memcmp(crash.input.data(), "FZ!", 3) == 0);
+        }
+        timeout |= crash.result.outcome == FUZZ_TIMEOUT;
+    }
+    REQUIRE(fault);
+    REQUIRE(timeout);
+    // abc, F, FZ, FZ!, L
+    REQUIRE(fuzzer.corpus().size() >= 5);
+}
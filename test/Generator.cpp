@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "../include/catch.hpp"
+#include "../src/Generator.hpp"
+#include "../src/Instruction.hpp"
+#include "../src/Workloads.hpp"
+
+static GeneratorConfig everything() {
+    GeneratorConfig config;
+    unsigned weights[GEN_CLASSES] = {4, 4, 2, 2, 3, 3, 2, 1, 1};
+    memcpy(config.weights, weights, sizeof(weights));
+    config.length = 300;
+    config.footprint = 256;
+    return config;
+}
+
+TEST_CASE("Generated programs terminate within their bound", "[Generator]") {
+    GeneratorConfig config = everything();
+
+    for(WORD seed = 1; seed <= 200; seed++) {
+        ProgramGenerator generator(config, seed);
+        GeneratedProgram program = generator.generate();
+        Emulator* vm = program.load();
+
+        DWORD executed = 0;
+        int status = run_workload(*vm, program.max_instructions, executed);
+        REQUIRE(status == WORKLOAD_DONE);
+        REQUIRE(executed <= program.max_instructions);
+
+        // Code and everything past the footprint are left alone
+        REQUIRE(memcmp(vm->get_memory(), program.code.data(), program.code.size() * 4) == 0);
+        BYTE* past = vm->get_memory() + program.data_address + config.footprint;
+        REQUIRE(std::all_of(past, vm->get_memory() + program.memory_size, [](BYTE b) { return b == 0; }));
+        for(int r = 24; r <= 30; r++) {
+            if(r == 27 || r == 28) continue;
+            REQUIRE(vm->get_register(r) == 0);
+        }
+        REQUIRE(vm->get_register(28) == program.data_address);
+        delete vm;
+    }
+}
+
+TEST_CASE("Trapping programs stop with an exit or a trap", "[Generator]") {
+    GeneratorConfig config = everything();
+    config.trapping = true;
+
+    int traps = 0;
+    for(WORD seed = 1; seed <= 100; seed++) {
+        GeneratedProgram program = ProgramGenerator(config, seed).generate();
+        Emulator* vm = program.load();
+        DWORD executed = 0;
+        int status = run_workload(*vm, program.max_instructions, executed);
+        REQUIRE((status == WORKLOAD_DONE || status == STEP_TRAP));
+        traps += status == STEP_TRAP;
+        delete vm;
+    }
+    REQUIRE(traps > 0);
+}
+
+TEST_CASE("Generator follows the opcode mix", "[Generator]") {
+    GeneratorConfig config;
+    unsigned weights[GEN_CLASSES] = {0, 0, 0, 0, 1, 3, 0, 0, 0};
+    memcpy(config.weights, weights, sizeof(weights));
+    config.length = 4000;
+    config.seed_registers = false;
+
+    GeneratedProgram program = ProgramGenerator(config, 7).generate();
+    // lui, ori for $28, the body, break
+    REQUIRE(program.code.size() == 2 + 4000 + 1);
+    REQUIRE(program.max_instructions == program.code.size());
+
+    int loads = 0, stores = 0;
+    for(size_t i = 2; i < program.code.size() - 1; i++) {
+        Instruction instruction(program.code[i]);
+        loads += instruction.is_load();
+        stores += instruction.is_store();
+        REQUIRE(instruction.rs == 28);
+        REQUIRE(instruction.imm % instruction.access_size() == 0);
+        REQUIRE(instruction.imm + instruction.access_size() <= (int)config.footprint);
+    }
+    REQUIRE(loads + stores == 4000);
+    REQUIRE(stores > 2 * loads);
+    REQUIRE(stores < 4 * loads);
+}
+
+TEST_CASE("Generator is deterministic per seed", "[Generator]") {
+    GeneratorConfig config = everything();
+    GeneratedProgram a = ProgramGenerator(config, 42).generate();
+    GeneratedProgram b = ProgramGenerator(config, 42).generate();
+    GeneratedProgram c = ProgramGenerator(config, 43).generate();
+    REQUIRE(a.code == b.code);
+    REQUIRE(a.code != c.code);
+
+    // Successive programs from one generator differ too
+    ProgramGenerator generator(config, 42);
+    generator.generate();
+    REQUIRE(generator.generate().code != a.code);
+}
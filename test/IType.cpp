@@ -6,7 +6,7 @@ TEST_CASE("Test I-Type instructions", "[step][I-type]") {
 
     SECTION("addi") {
         WORD program[1];
-        program[0] = Utilities::I_instruction(8, 1, 2, 30); // addi r1, r2, 30
+        program[0] = Utilities::I_instruction(OP_ADDI, 1, 2, 30); // addi r1, r2, 30
         vm = new Emulator(128, program, 1);
 
         SECTION("functions as expected with positive, normal input") {
@@ -36,7 +36,7 @@ TEST_CASE("Test I-Type instructions", "[step][I-type]") {
         }
 
         SECTION("traps on underflow") {
-            program[0] = Utilities::I_instruction(8, 1, 2, -1); // addi r1, r2, -1
+            program[0] = Utilities::I_instruction(OP_ADDI, 1, 2, -1); // addi r1, r2, -1
             vm = new Emulator(128, program, 1);
             vm->set_register(2, 0x80000000);
 
@@ -44,7 +44,7 @@ TEST_CASE("Test I-Type instructions", "[step][I-type]") {
         }
 
         SECTION("doesn't trap on underflow bound") {
-            program[0] = Utilities::I_instruction(8, 1, 2, 0); // addi r1, r2, 0
+            program[0] = Utilities::I_instruction(OP_ADDI, 1, 2, 0); // addi r1, r2, 0
             vm = new Emulator(128, program, 1);
             vm->set_register(2, 0x80000000);
 
@@ -54,7 +54,7 @@ TEST_CASE("Test I-Type instructions", "[step][I-type]") {
 
     SECTION("addiu") {
         WORD program[1];
-        program[0] = Utilities::I_instruction(9, 1, 2, 30); // addiu r1, r2, 30
+        program[0] = Utilities::I_instruction(OP_ADDIU, 1, 2, 30); // addiu r1, r2, 30
         vm = new Emulator(128, program, 1);
 
         SECTION("functions as expected with positive, normal input") {
@@ -74,7 +74,7 @@ TEST_CASE("Test I-Type instructions", "[step][I-type]") {
 
     SECTION("slti") {
         WORD program[1];
-        program[0] = Utilities::I_instruction(10, 2, 1, 30); // slti r2, r1, 30
+        program[0] = Utilities::I_instruction(OP_SLTI, 2, 1, 30); // slti r2, r1, 30
         vm = new Emulator(128, program, 1);
 
         SECTION("sets when appropriate (2 +ve values)") {
@@ -100,7 +100,7 @@ TEST_CASE("Test I-Type instructions", "[step][I-type]") {
         }
 
         SECTION("immediate is sign-extended") {
-            program[0] = Utilities::I_instruction(10, 2, 1, 0xffff); // slti r1, -1(-4)
+            program[0] = Utilities::I_instruction(OP_SLTI, 2, 1, 0xffff); // slti r1, -1(-4)
 
             vm = new Emulator(128, program, 1);
             vm->set_register(1, -2000);
@@ -112,7 +112,7 @@ TEST_CASE("Test I-Type instructions", "[step][I-type]") {
 
     SECTION("sltiu") {
         WORD program[1];
-        program[0] = Utilities::I_instruction(10, 2, 1, 30); // sltiu r2, r1, 30
+        program[0] = Utilities::I_instruction(OP_SLTI, 2, 1, 30); // sltiu r2, r1, 30
         vm = new Emulator(128, program, 1);
 
         SECTION("sets when appropriate (2 +ve values)") {
@@ -131,7 +131,7 @@ TEST_CASE("Test I-Type instructions", "[step][I-type]") {
         }
 
         SECTION("immediate is zero-extended") {
-            program[0] = Utilities::I_instruction(10, 2, 1, 0xffff); // slti r1, -1(-4)
+            program[0] = Utilities::I_instruction(OP_SLTI, 2, 1, 0xffff); // slti r1, -1(-4)
 
             vm = new Emulator(128, program, 1);
             vm->set_register(2, 1);
@@ -144,7 +144,7 @@ TEST_CASE("Test I-Type instructions", "[step][I-type]") {
 
     SECTION("andi") {
         WORD program[1];
-        program[0] = Utilities::I_instruction(12, 2, 1, 0xaaaa); // andi r2, r1, 0xaaaa
+        program[0] = Utilities::I_instruction(OP_ANDI, 2, 1, 0xaaaa); // andi r2, r1, 0xaaaa
         vm = new Emulator(128, program, 1);
 
         SECTION("functions as expected") {
@@ -157,7 +157,7 @@ TEST_CASE("Test I-Type instructions", "[step][I-type]") {
 
     SECTION("ori") {
         WORD program[1];
-        program[0] = Utilities::I_instruction(13, 2, 1, 0xaaaa); // ori r2, r1, 0xaaaa
+        program[0] = Utilities::I_instruction(OP_ORI, 2, 1, 0xaaaa); // ori r2, r1, 0xaaaa
         vm = new Emulator(128, program, 1);
 
         SECTION("functions as expected") {
@@ -170,7 +170,7 @@ TEST_CASE("Test I-Type instructions", "[step][I-type]") {
 
     SECTION("xori") {
         WORD program[1];
-        program[0] = Utilities::I_instruction(14, 2, 1, 0xaaaa); // xori r2, r1, 0xaaaa
+        program[0] = Utilities::I_instruction(OP_XORI, 2, 1, 0xaaaa); // xori r2, r1, 0xaaaa
         vm = new Emulator(128, program, 1);
 
         SECTION("functions as expected") {
@@ -183,7 +183,7 @@ TEST_CASE("Test I-Type instructions", "[step][I-type]") {
 
     SECTION("lui") {
         WORD program[1];
-        program[0] = Utilities::I_instruction(15, 2, 1, 0xaaaa); // lui r2, r1, 0xaaaa
+        program[0] = Utilities::I_instruction(OP_LUI, 2, 1, 0xaaaa); // lui r2, r1, 0xaaaa
         vm = new Emulator(128, program, 1);
 
         SECTION("functions as expected") {
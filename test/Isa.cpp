@@ -0,0 +1,85 @@
+#include <cstring>
+#include <string>
+
+#include "../include/catch.hpp"
+#include "../src/Assembler.hpp"
+#include "../src/Disassembler.hpp"
+#include "../src/Instruction.hpp"
+#include "../src/Latency.hpp"
+#include "../src/Utilities.hpp"
+
+// An instance of every layout, with distinct fields
+static WORD sample(int opcode, int func, IsaFormat format) {
+    switch(format) {
+        case FMT_RD_RS_RT: return Utilities::R_instruction(OP_SPECIAL, 3, 1, 2, 0, func);
+        case FMT_RD_RT_SA: return Utilities::R_instruction(OP_SPECIAL, 3, 0, 2, 5, func);
+        case FMT_RD_RT_RS: return Utilities::R_instruction(OP_SPECIAL, 3, 1, 2, 0, func);
+        case FMT_RS_RT: return Utilities::R_instruction(OP_SPECIAL, 0, 1, 2, 0, func);
+        case FMT_RS: return Utilities::R_instruction(OP_SPECIAL, 0, 1, 0, 0, func);
+        case FMT_RD: return Utilities::R_instruction(OP_SPECIAL, 3, 0, 0, 0, func);
+        case FMT_JALR: return Utilities::R_instruction(OP_SPECIAL, 31, 1, 0, 0, func);
+        case FMT_NONE: return Utilities::R_instruction(OP_SPECIAL, 0, 0, 0, 0, func);
+        case FMT_BREAK: return Utilities::R_instruction(OP_SPECIAL, 1, 0, 0, 5, func);
+        case FMT_IMM: return Utilities::I_instruction(opcode, 2, 1, -7);
+        case FMT_UIMM: return Utilities::I_instruction(opcode, 2, 1, 0x8001);
+        case FMT_LUI: return Utilities::I_instruction(opcode, 2, 0, 0x1234);
+        case FMT_MEMORY: return Utilities::I_instruction(opcode, 2, 1, -8);
+        case FMT_BRANCH2: return Utilities::I_instruction(opcode, 2, 1, 3);
+        case FMT_BRANCH1: return Utilities::I_instruction(opcode, 0, 1, 3);
+        case FMT_JUMP: return Utilities::J_instruction(opcode, 0x40);
+        default: return 0;
+    }
+}
+
+TEST_CASE("Every ISA row assembles, disassembles and decodes consistently", "[Isa]") {
+    int rows = 0;
+    for(int table = 0; table < 2; table++) {
+        for(int i = 0; i < 64; i++) {
+            const IsaEntry& entry = table == 0 ? isa_opcodes[i] : isa_funcs[i];
+            if(entry.name == NULL) continue;
+            rows++;
+
+            int opcode = table == 0 ? i : OP_SPECIAL;
+            WORD word = sample(opcode, table == 1 ? i : 0, entry.format);
+            Instruction instruction(word);
+            REQUIRE(&instruction.entry() == &entry);
+            REQUIRE(&isa_entry(word) == &entry);
+            REQUIRE((int)opcode_class(instruction) == (int)entry.kind);
+            REQUIRE(instruction.is_load() == (entry.kind == KIND_LOAD));
+            REQUIRE(instruction.is_store() == (entry.kind == KIND_STORE));
+            REQUIRE((isa_access_bytes[opcode] != 0) == (instruction.is_load() || instruction.is_store()));
+
+            char text[DISASM_BUFFER];
+            disassemble(word, 0x100, text, sizeof(text));
+            REQUIRE(strncmp(text, entry.name, strlen(entry.name)) == 0);
+
+            AssemblerConfig config;
+            config.text_address = 0x100;
+            Assembler assembler(config);
+            INFO(text);
+            REQUIRE(assembler.assemble(text));
+            const std::vector<BYTE>& image = assembler.image();
+            REQUIRE(image.size() == 0x104);
+            REQUIRE((image[0x100] | image[0x101] << 8 | image[0x102] << 16 | (WORD)image[0x103] << 24) == word);
+        }
+    }
+    REQUIRE(rows == 24 + 36);
+}
+
+TEST_CASE("Encodings outside the ISA tables are unknown everywhere", "[Isa]") {
+    const WORD unknown[] = {Utilities::I_instruction(63, 1, 2, 3), Utilities::R_instruction(OP_SPECIAL, 1, 2, 3, 0, 63),
+                            Utilities::I_instruction(42, 1, 2, 3)};
+    for(WORD word : unknown) {
+        REQUIRE(isa_entry(word).name == NULL);
+        REQUIRE(opcode_class(Instruction(word)) == CLASS_TRAP);
+
+        char text[DISASM_BUFFER];
+        disassemble(word, 0, text, sizeof(text));
+        REQUIRE(strncmp(text, ".word", 5) == 0);
+
+        // step() skips them
+        Emulator vm(16, &word, 1);
+        REQUIRE(vm.step() == STEP_OK);
+        REQUIRE(vm.state().PC == 4);
+    }
+}
@@ -6,9 +6,9 @@ TEST_CASE("Test J-Type instructions", "[step][J-type]") {
 
     SECTION("j") {
         WORD program[1];
-        program[0] = Utilities::J_instruction(2, 0b10); // j 2
-        program[1] = Utilities::R_instruction(0, 1, 1, 2, 0, 32); // add r1, r1, r2
-        program[2] = Utilities::R_instruction(0, 1, 1, 3, 0, 32); // add r1, r1, r3
+        program[0] = Utilities::J_instruction(OP_J, 0b10); // j 2
+        program[1] = Utilities::R_instruction(OP_SPECIAL, 1, 1, 2, 0, FUNC_ADD); // add r1, r1, r2
+        program[2] = Utilities::R_instruction(OP_SPECIAL, 1, 1, 3, 0, FUNC_ADD); // add r1, r1, r3
 
         vm = new Emulator(128, program, 3);
         vm->set_register(1, 8);
@@ -24,9 +24,9 @@ TEST_CASE("Test J-Type instructions", "[step][J-type]") {
 
     SECTION("jal") {
         WORD program[1];
-        program[0] = Utilities::J_instruction(3, 0b10); // jal 2
-        program[1] = Utilities::R_instruction(0, 1, 1, 2, 0, 32); // add r1, r1, r2
-        program[2] = Utilities::R_instruction(0, 1, 1, 3, 0, 32); // add r1, r1, r3
+        program[0] = Utilities::J_instruction(OP_JAL, 0b10); // jal 2
+        program[1] = Utilities::R_instruction(OP_SPECIAL, 1, 1, 2, 0, FUNC_ADD); // add r1, r1, r2
+        program[2] = Utilities::R_instruction(OP_SPECIAL, 1, 1, 3, 0, FUNC_ADD); // add r1, r1, r3
 
         vm = new Emulator(128, program, 3);
         vm->set_register(1, 8);
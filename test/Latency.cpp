@@ -0,0 +1,86 @@
+#include "../include/catch.hpp"
+#include "../src/Latency.hpp"
+#include "../src/Utilities.hpp"
+#include "../src/Workloads.hpp"
+
+TEST_CASE("Latency histogram buckets and percentiles", "[Latency]") {
+    LatencyHistogram h;
+
+    SECTION("small values are exact") {
+        for(DWORD v = 1; v <= 50; v++) h.record(v);
+        REQUIRE(h.count() == 50);
+        REQUIRE(h.min() == 1);
+        REQUIRE(h.max() == 50);
+        REQUIRE(h.mean() == Approx(25.5));
+        REQUIRE(h.percentile(50) == 25);
+        REQUIRE(h.percentile(90) == 45);
+        REQUIRE(h.percentile(100) == 50);
+    }
+
+    SECTION("large values are within the bucket precision") {
+        for(DWORD v : {1000ULL, 123456ULL, 1ULL << 40, ~0ULL}) {
+            h.clear();
+            h.record(v);
+            h.record(0);
+            DWORD p = h.percentile(100);
+            REQUIRE(p >= v);
+            REQUIRE(p - v <= v / 32);
+        }
+    }
+
+    SECTION("buckets cover every value once") {
+        for(size_t i = 1; i < 1919; i++) REQUIRE(LatencyHistogram::bucket_low(i) == LatencyHistogram::bucket_high(i - 1) + 1);
+        REQUIRE(LatencyHistogram::bucket_high(1919) == ~0ULL);
+    }
+
+    SECTION("an outlier only shows in the tail") {
+        for(int i = 0; i < 999; i++) h.record(10);
+        h.record(100000);
+        REQUIRE(h.percentile(99) == 10);
+        REQUIRE(h.percentile(99.95) >= 100000);
+    }
+}
+
+TEST_CASE("Opcode classes", "[Latency]") {
+    REQUIRE(opcode_class(Instruction(Utilities::R_instruction(OP_SPECIAL, 1, 2, 3, 0, FUNC_ADDU))) == CLASS_ALU);
+    REQUIRE(opcode_class(Instruction(Utilities::R_instruction(OP_SPECIAL, 1, 0, 3, 4, FUNC_SLL))) == CLASS_SHIFT);
+    REQUIRE(opcode_class(Instruction(Utilities::R_instruction(OP_SPECIAL, 0, 2, 3, 0, FUNC_DIV))) == CLASS_MULTDIV);
+    REQUIRE(opcode_class(Instruction(Utilities::R_instruction(OP_SPECIAL, 0, 31, 0, 0, FUNC_JR))) == CLASS_JUMP);
+    REQUIRE(opcode_class(Instruction(Utilities::R_instruction(OP_SPECIAL, 0, 0, 0, 1, FUNC_BREAK))) == CLASS_TRAP);
+    REQUIRE(opcode_class(Instruction(Utilities::I_instruction(OP_ADDIU, 1, 0, 5))) == CLASS_ALU);
+    REQUIRE(opcode_class(Instruction(Utilities::I_instruction(OP_LW, 1, 0, 5))) == CLASS_LOAD);
+    REQUIRE(opcode_class(Instruction(Utilities::I_instruction(OP_SB, 1, 0, 5))) == CLASS_STORE);
+    REQUIRE(opcode_class(Instruction(Utilities::I_instruction(OP_BNE, 1, 0, 5))) == CLASS_BRANCH);
+    REQUIRE(opcode_class(Instruction(Utilities::J_instruction(OP_JAL, 5))) == CLASS_JUMP);
+}
+
+TEST_CASE("Latency profiler samples every Nth instruction", "[Latency][Workloads]") {
+    const Workload* sort = find_workload("sort");
+
+    for(DWORD every : {1ULL, 7ULL}) {
+        LatencyProfiler profiler(every);
+
+        Emulator* vm = sort->load();
+        DWORD executed = 0;
+        REQUIRE(vm->run(10000000, executed, profiler) == WORKLOAD_DONE);
+        REQUIRE(sort->check(*vm));
+        delete vm;
+
+        DWORD samples = 0;
+        for(int c = 0; c < OPCODE_CLASSES; c++) samples += profiler.histogram((OpcodeClass)c).count();
+        REQUIRE(samples == executed / every);
+        REQUIRE(profiler.histogram(CLASS_LOAD).count() > 0);
+        REQUIRE(profiler.histogram(CLASS_BRANCH).count() > 0);
+
+        FILE* file = tmpfile();
+        profiler.write_json(file);
+        char buffer[65536] = {};
+        rewind(file);
+        fread(buffer, 1, sizeof(buffer) - 1, file);
+        fclose(file);
+        std::string json = buffer;
+        REQUIRE(json.find("\"sample_every\": " + std::to_string(every)) != std::string::npos);
+        REQUIRE(json.find("\"load\": {\"count\": ") != std::string::npos);
+        REQUIRE(json.find("\"multdiv\"") == std::string::npos);
+    }
+}
@@ -6,10 +6,10 @@ TEST_CASE("Test memory I/O instructions", "[step][Memory][I/O]") {
 
     SECTION("lb") {
         WORD program[5];
-        program[0] = Utilities::I_instruction(32, 1, 5, 0); // lb r1, 0(r5)
-        program[1] = Utilities::I_instruction(32, 2, 7, -3); // lb r2, -3(r7)
-        program[2] = Utilities::I_instruction(32, 3, 5, 2); // lb r3, 2(r5)
-        program[3] = Utilities::I_instruction(32, 4, 7, -1); // lb r4, -1(r7)
+        program[0] = Utilities::I_instruction(OP_LB, 1, 5, 0); // lb r1, 0(r5)
+        program[1] = Utilities::I_instruction(OP_LB, 2, 7, -3); // lb r2, -3(r7)
+        program[2] = Utilities::I_instruction(OP_LB, 3, 5, 2); // lb r3, 2(r5)
+        program[3] = Utilities::I_instruction(OP_LB, 4, 7, -1); // lb r4, -1(r7)
         program[4] = 0x0108ddcc;
         vm = new Emulator(128, program, 5);
 
@@ -34,11 +34,11 @@ TEST_CASE("Test memory I/O instructions", "[step][Memory][I/O]") {
 
     SECTION("lh") {
         WORD program[5];
-        program[0] = Utilities::I_instruction(33, 1, 5, 0); // lh r1, 0(r5)
-        program[1] = Utilities::I_instruction(33, 2, 7, -4); // lh r2, -4(r7)
-        program[2] = Utilities::I_instruction(33, 3, 5, 2); // lh r3, 2(r5)
-        program[3] = Utilities::I_instruction(33, 4, 7, -2); // lh r4, -2(r7)
-        program[4] = Utilities::I_instruction(33, 6, 7, 1); // lh r6, 1(r7)
+        program[0] = Utilities::I_instruction(OP_LH, 1, 5, 0); // lh r1, 0(r5)
+        program[1] = Utilities::I_instruction(OP_LH, 2, 7, -4); // lh r2, -4(r7)
+        program[2] = Utilities::I_instruction(OP_LH, 3, 5, 2); // lh r3, 2(r5)
+        program[3] = Utilities::I_instruction(OP_LH, 4, 7, -2); // lh r4, -2(r7)
+        program[4] = Utilities::I_instruction(OP_LH, 6, 7, 1); // lh r6, 1(r7)
         program[5] = 0x0108ddcc;
         vm = new Emulator(128, program, 6);
 
@@ -67,10 +67,10 @@ TEST_CASE("Test memory I/O instructions", "[step][Memory][I/O]") {
 
     SECTION("lwl") {
         WORD program[5];
-        program[0] = Utilities::I_instruction(34, 1, 5, 0); // lwl r1, 0(r5)
-        program[1] = Utilities::I_instruction(34, 2, 5, 1); // lwl r2, 1(r5)
-        program[2] = Utilities::I_instruction(34, 3, 5, 2); // lwl r3, 2(r5)
-        program[3] = Utilities::I_instruction(34, 4, 5, 3); // lwl r4, 3(r5)
+        program[0] = Utilities::I_instruction(OP_LWL, 1, 5, 0); // lwl r1, 0(r5)
+        program[1] = Utilities::I_instruction(OP_LWL, 2, 5, 1); // lwl r2, 1(r5)
+        program[2] = Utilities::I_instruction(OP_LWL, 3, 5, 2); // lwl r3, 2(r5)
+        program[3] = Utilities::I_instruction(OP_LWL, 4, 5, 3); // lwl r4, 3(r5)
         program[4] = 0xaabbccdd;
         vm = new Emulator(128, program, 5);
 
@@ -91,10 +91,10 @@ TEST_CASE("Test memory I/O instructions", "[step][Memory][I/O]") {
 
     SECTION("lw") {
         WORD program[5];
-        program[0] = Utilities::I_instruction(35, 1, 5, 0); // lw r1, 0(r5)
-        program[1] = Utilities::I_instruction(35, 2, 5, 1); // lw r4, 1(r5)
-        program[2] = Utilities::I_instruction(35, 2, 5, 2); // lw r4, 2(r5)
-        program[3] = Utilities::I_instruction(35, 2, 5, 3); // lw r4, 3(r5)
+        program[0] = Utilities::I_instruction(OP_LW, 1, 5, 0); // lw r1, 0(r5)
+        program[1] = Utilities::I_instruction(OP_LW, 2, 5, 1); // lw r4, 1(r5)
+        program[2] = Utilities::I_instruction(OP_LW, 2, 5, 2); // lw r4, 2(r5)
+        program[3] = Utilities::I_instruction(OP_LW, 2, 5, 3); // lw r4, 3(r5)
         program[4] = 0x01020304;
         vm = new Emulator(128, program, 5);
 
@@ -115,10 +115,10 @@ TEST_CASE("Test memory I/O instructions", "[step][Memory][I/O]") {
 
     SECTION("lbu") {
         WORD program[5];
-        program[0] = Utilities::I_instruction(36, 1, 5, 0); // lbu r1, 0(r5)
-        program[1] = Utilities::I_instruction(36, 2, 7, -3); // lbu r2, -3(r7)
-        program[2] = Utilities::I_instruction(36, 3, 5, 2); // lbu r3, 2(r5)
-        program[3] = Utilities::I_instruction(36, 4, 7, -1); // lbu r4, -1(r7)
+        program[0] = Utilities::I_instruction(OP_LBU, 1, 5, 0); // lbu r1, 0(r5)
+        program[1] = Utilities::I_instruction(OP_LBU, 2, 7, -3); // lbu r2, -3(r7)
+        program[2] = Utilities::I_instruction(OP_LBU, 3, 5, 2); // lbu r3, 2(r5)
+        program[3] = Utilities::I_instruction(OP_LBU, 4, 7, -1); // lbu r4, -1(r7)
         program[4] = 0x0108ddcc;
         vm = new Emulator(128, program, 5);
 
@@ -143,11 +143,11 @@ TEST_CASE("Test memory I/O instructions", "[step][Memory][I/O]") {
 
     SECTION("lhu") {
         WORD program[5];
-        program[0] = Utilities::I_instruction(37, 1, 5, 0); // lhu r1, 0(r5)
-        program[1] = Utilities::I_instruction(37, 2, 7, -4); // lhu r2, -4(r7)
-        program[2] = Utilities::I_instruction(37, 3, 5, 2); // lhu r3, 2(r5)
-        program[3] = Utilities::I_instruction(37, 4, 7, -2); // lhu r4, -2(r7)
-        program[4] = Utilities::I_instruction(37, 6, 7, 1); // lhu r6, 1(r7)
+        program[0] = Utilities::I_instruction(OP_LHU, 1, 5, 0); // lhu r1, 0(r5)
+        program[1] = Utilities::I_instruction(OP_LHU, 2, 7, -4); // lhu r2, -4(r7)
+        program[2] = Utilities::I_instruction(OP_LHU, 3, 5, 2); // lhu r3, 2(r5)
+        program[3] = Utilities::I_instruction(OP_LHU, 4, 7, -2); // lhu r4, -2(r7)
+        program[4] = Utilities::I_instruction(OP_LHU, 6, 7, 1); // lhu r6, 1(r7)
         program[5] = 0x0108ddcc;
         vm = new Emulator(128, program, 6);
 
@@ -176,10 +176,10 @@ TEST_CASE("Test memory I/O instructions", "[step][Memory][I/O]") {
 
     SECTION("lwr") {
         WORD program[5];
-        program[0] = Utilities::I_instruction(38, 1, 5, 0); // lwr r1, 0(r5)
-        program[1] = Utilities::I_instruction(38, 2, 5, 1); // lwr r2, 1(r5)
-        program[2] = Utilities::I_instruction(38, 3, 5, 2); // lwr r3, 2(r5)
-        program[3] = Utilities::I_instruction(38, 4, 5, 3); // lwr r4, 3(r5)
+        program[0] = Utilities::I_instruction(OP_LWR, 1, 5, 0); // lwr r1, 0(r5)
+        program[1] = Utilities::I_instruction(OP_LWR, 2, 5, 1); // lwr r2, 1(r5)
+        program[2] = Utilities::I_instruction(OP_LWR, 3, 5, 2); // lwr r3, 2(r5)
+        program[3] = Utilities::I_instruction(OP_LWR, 4, 5, 3); // lwr r4, 3(r5)
         program[4] = 0xaabbccdd;
         vm = new Emulator(128, program, 5);
 
@@ -200,11 +200,11 @@ TEST_CASE("Test memory I/O instructions", "[step][Memory][I/O]") {
 
     SECTION("sb") {
         WORD program[5];
-        program[0] = Utilities::I_instruction(40, 1, 5, 0); // sb r1, 0(r5)
-        program[1] = Utilities::I_instruction(40, 2, 7, -3); // sb r2, -3(r7)
-        program[2] = Utilities::I_instruction(40, 3, 5, 2); // sb r3, 2(r5)
-        program[3] = Utilities::I_instruction(40, 4, 7, -1); // sb r4, -1(r7)
-        program[4] = Utilities::I_instruction(35, 8, 5, 0); // lw r8, 0(r5)
+        program[0] = Utilities::I_instruction(OP_SB, 1, 5, 0); // sb r1, 0(r5)
+        program[1] = Utilities::I_instruction(OP_SB, 2, 7, -3); // sb r2, -3(r7)
+        program[2] = Utilities::I_instruction(OP_SB, 3, 5, 2); // sb r3, 2(r5)
+        program[3] = Utilities::I_instruction(OP_SB, 4, 7, -1); // sb r4, -1(r7)
+        program[4] = Utilities::I_instruction(OP_LW, 8, 5, 0); // lw r8, 0(r5)
         vm = new Emulator(128, program, 5);
 
         vm->set_register(1, 0x01);
@@ -228,11 +228,11 @@ TEST_CASE("Test memory I/O instructions", "[step][Memory][I/O]") {
 
     SECTION("sh") {
         WORD program[6];
-        program[0] = Utilities::I_instruction(41, 8, 5, 0); // sh r1, 0(r5)
-        program[1] = Utilities::I_instruction(32, 1, 5, 0); // lb r1, 0(r5)
-        program[2] = Utilities::I_instruction(32, 2, 7, -3); // lb r2, -3(r7)
-        program[3] = Utilities::I_instruction(33, 9, 5, 0); // lh r1, 1(r5)
-        program[4] = Utilities::I_instruction(41, 8, 5, 1); // sh r1, 1(r5)
+        program[0] = Utilities::I_instruction(OP_SH, 8, 5, 0); // sh r1, 0(r5)
+        program[1] = Utilities::I_instruction(OP_LB, 1, 5, 0); // lb r1, 0(r5)
+        program[2] = Utilities::I_instruction(OP_LB, 2, 7, -3); // lb r2, -3(r7)
+        program[3] = Utilities::I_instruction(OP_LH, 9, 5, 0); // lh r1, 1(r5)
+        program[4] = Utilities::I_instruction(OP_SH, 8, 5, 1); // sh r1, 1(r5)
         vm = new Emulator(128, program, 5);
 
         vm->set_register(5, 32);
@@ -257,14 +257,14 @@ TEST_CASE("Test memory I/O instructions", "[step][Memory][I/O]") {
 
     SECTION("sw") {
         WORD program[6];
-        program[0] = Utilities::I_instruction(43, 8, 5, 0); // sw r1, 0(r5)
-        program[1] = Utilities::I_instruction(32, 1, 5, 0); // lb r1, 0(r5)
-        program[2] = Utilities::I_instruction(32, 2, 7, -3); // lb r2, -3(r7)
-        program[3] = Utilities::I_instruction(32, 3, 5, 2); // lb r3, 2(r5)
-        program[4] = Utilities::I_instruction(32, 4, 7, -1); // lb r4, -1(r7)
-        program[5] = Utilities::I_instruction(43, 1, 5, 1); // sw r1, 0(r5)
-        program[6] = Utilities::I_instruction(43, 1, 5, 2); // sw r1, 0(r5)
-        program[7] = Utilities::I_instruction(43, 1, 5, 3); // sw r1, 0(r5)
+        program[0] = Utilities::I_instruction(OP_SW, 8, 5, 0); // sw r1, 0(r5)
+        program[1] = Utilities::I_instruction(OP_LB, 1, 5, 0); // lb r1, 0(r5)
+        program[2] = Utilities::I_instruction(OP_LB, 2, 7, -3); // lb r2, -3(r7)
+        program[3] = Utilities::I_instruction(OP_LB, 3, 5, 2); // lb r3, 2(r5)
+        program[4] = Utilities::I_instruction(OP_LB, 4, 7, -1); // lb r4, -1(r7)
+        program[5] = Utilities::I_instruction(OP_SW, 1, 5, 1); // sw r1, 0(r5)
+        program[6] = Utilities::I_instruction(OP_SW, 1, 5, 2); // sw r1, 0(r5)
+        program[7] = Utilities::I_instruction(OP_SW, 1, 5, 3); // sw r1, 0(r5)
         vm = new Emulator(128, program, 8);
 
         vm->set_register(5, 32);
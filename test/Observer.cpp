@@ -0,0 +1,49 @@
+#include <vector>
+
+#include "../include/catch.hpp"
+#include "../src/Observer.hpp"
+#include "../src/Utilities.hpp"
+
+// Records what it is shown
+struct Recorder : public ExecutionObserver {
+    std::vector<ADDRESS> seen;
+    std::vector<ADDRESS> next;
+    std::vector<int> statuses;
+
+    void before(const Instruction& instruction, ADDRESS pc, const CPUState& cpu) {
+        REQUIRE(cpu.PC == pc);
+        REQUIRE(instruction.word != 0);
+        seen.push_back(pc);
+    }
+    void after(const Instruction&, ADDRESS, const CPUState& cpu, int status) {
+        next.push_back(cpu.PC);
+        statuses.push_back(status);
+    }
+};
+
+TEST_CASE("Observers see every instruction a run executes", "[Observer][step]") {
+    WORD program[3];
+    program[0] = Utilities::I_instruction(OP_ADDIU, 1, 0, 0x7fff);          // addiu r1, r0, 0x7fff
+    program[1] = Utilities::I_instruction(OP_ADDIU, 2, 0, 1);               // addiu r2, r0, 1
+    program[2] = Utilities::R_instruction(OP_SPECIAL, 0, 1, 0, 0, FUNC_JR); // jr r1
+
+    Emulator vm(64, program, 3);
+    Recorder first, second;
+    ObserverList both = {&first, &second};
+
+    DWORD executed = 0;
+    REQUIRE(vm.run(2, executed, both) == STEP_OK);
+    REQUIRE(executed == 2);
+    REQUIRE(vm.get_register(2) == 1);
+
+    // The jump out of memory runs; the fetch after it faults without reaching the observers
+    REQUIRE(vm.run(10, executed, both) == STEP_FAULT);
+    REQUIRE(executed == 4);
+    REQUIRE(vm.state().PC == 0x7fff);
+
+    for(Recorder* r : {&first, &second}) {
+        REQUIRE(r->seen == std::vector<ADDRESS>({0, 4, 8}));
+        REQUIRE(r->next == std::vector<ADDRESS>({4, 8, 0x7fff}));
+        REQUIRE(r->statuses == std::vector<int>({STEP_OK, STEP_OK, STEP_OK}));
+    }
+}
@@ -0,0 +1,44 @@
+#include "../include/catch.hpp"
+#include "../src/PerfCounters.hpp"
+#include "../src/Workloads.hpp"
+
+TEST_CASE("Guest branches are counted in a separate pass", "[PerfCounters][Workloads]") {
+    const Workload* fib = find_workload("fib");
+    Emulator* vm = fib->load();
+
+    // Every call runs one beq and one jr, and is made by one jal
+    REQUIRE(count_guest_branches(*vm, 10000000) == 3 * (2 * 4181 - 1));
+    REQUIRE(fib->check(*vm));
+    delete vm;
+}
+
+TEST_CASE("Perf runs work with or without host counters", "[PerfCounters][Workloads]") {
+    const Workload* crc = find_workload("crc32");
+    Emulator* vm = crc->load();
+    PerfCounters perf;
+
+    DWORD executed = 0;
+    PerfSample sample;
+    REQUIRE(perf_run(perf, *vm, 10000000, executed, sample) == WORKLOAD_DONE);
+    REQUIRE(crc->check(*vm));
+    delete vm;
+
+    REQUIRE(sample.seconds > 0);
+    if(perf.available()) {
+        if(sample.available[PERF_INSTRUCTIONS])
+            REQUIRE(sample.value[PERF_INSTRUCTIONS] > executed);
+    } else {
+        REQUIRE(!perf.error().empty());
+        for(int e = 0; e < PERF_EVENTS; e++) REQUIRE(!sample.available[e]);
+    }
+
+    FILE* file = tmpfile();
+    print_perf(file, sample, executed, 100);
+    char buffer[1024] = {};
+    rewind(file);
+    fread(buffer, 1, sizeof(buffer) - 1, file);
+    fclose(file);
+    std::string report = buffer;
+    REQUIRE(report.find("Guest instructions: " + std::to_string(executed) + " (100 branches)") != std::string::npos);
+    REQUIRE(report.find("branch-misses") != std::string::npos);
+}
@@ -0,0 +1,111 @@
+#include "../include/catch.hpp"
+#include "../src/Pipeline.hpp"
+#include "../src/Utilities.hpp"
+#include "../src/Workloads.hpp"
+
+static PipelineModel run_program(WORD* program, size_t words, const PipelineConfig& config = PipelineConfig()) {
+    Emulator vm(0x100, program, words);
+    PipelineModel model(config);
+    DWORD executed = 0;
+    REQUIRE(vm.run(1000, executed, model) == STEP_TRAP);
+    REQUIRE(model.instructions() == executed);
+    return model;
+}
+
+TEST_CASE("Pipeline fills and drains in four cycles", "[Pipeline]") {
+    WORD program[] = {
+        Utilities::I_instruction(OP_ADDIU, 1, 0, 1),        // addiu $1, $0, 1
+        Utilities::I_instruction(OP_ADDIU, 2, 0, 2),        // addiu $2, $0, 2
+        Utilities::I_instruction(OP_ADDIU, 3, 0, 3),        // addiu $3, $0, 3
+        Utilities::R_instruction(OP_SPECIAL, 0, 0, 0, 1, FUNC_BREAK), // break 1
+    };
+    PipelineModel model = run_program(program, 4);
+    REQUIRE(model.cycles() == 4 + 4);
+    for(int k = 0; k < STALL_KINDS; k++) REQUIRE(model.stall_cycles((StallKind)k) == 0);
+}
+
+TEST_CASE("Pipeline data hazards", "[Pipeline]") {
+    WORD program[] = {
+        Utilities::I_instruction(OP_LW, 1, 0, 0x40),    // lw $1, 0x40($0)
+        Utilities::R_instruction(OP_SPECIAL, 2, 1, 1, 0, FUNC_ADDU), // addu $2, $1, $1
+        Utilities::R_instruction(OP_SPECIAL, 3, 2, 2, 0, FUNC_ADDU), // addu $3, $2, $2
+        Utilities::I_instruction(OP_SW, 3, 0, 0x44),    // sw $3, 0x44($0)
+        Utilities::R_instruction(OP_SPECIAL, 0, 0, 0, 1, FUNC_BREAK), // break 1
+    };
+
+    SECTION("with forwarding only a load-use stalls") {
+        PipelineModel model = run_program(program, 5);
+        REQUIRE(model.stall_cycles(STALL_LOAD_USE) == 1);
+        REQUIRE(model.stall_cycles(STALL_DATA) == 0);
+        REQUIRE(model.cycles() == 5 + 4 + 1);
+    }
+
+    SECTION("without forwarding every dependency waits for writeback") {
+        PipelineConfig config;
+        config.forwarding = false;
+        PipelineModel model = run_program(program, 5, config);
+        REQUIRE(model.stall_cycles(STALL_LOAD_USE) == 0);
+        REQUIRE(model.stall_cycles(STALL_DATA) == 3 * 2);
+        REQUIRE(model.cycles() == 5 + 4 + 6);
+    }
+}
+
+TEST_CASE("Pipeline waits for HI/LO", "[Pipeline]") {
+    WORD program[] = {
+        Utilities::I_instruction(OP_ADDIU, 1, 0, 6),        // addiu $1, $0, 6
+        Utilities::I_instruction(OP_ADDIU, 2, 0, 7),        // addiu $2, $0, 7
+        Utilities::R_instruction(OP_SPECIAL, 0, 1, 2, 0, FUNC_MULT), // mult $1, $2
+        Utilities::R_instruction(OP_SPECIAL, 3, 0, 0, 0, FUNC_MFLO), // mflo $3
+        Utilities::R_instruction(OP_SPECIAL, 0, 1, 2, 0, FUNC_DIV), // div $1, $2
+        Utilities::I_instruction(OP_ADDIU, 4, 0, 1),        // addiu $4, $0, 1
+        Utilities::R_instruction(OP_SPECIAL, 5, 0, 0, 0, FUNC_MFHI), // mfhi $5
+        Utilities::R_instruction(OP_SPECIAL, 0, 0, 0, 1, FUNC_BREAK), // break 1
+    };
+    PipelineConfig config;
+    PipelineModel model = run_program(program, 8, config);
+    REQUIRE(model.stall_cycles(STALL_HILO) == (config.mult_latency - 1) + (config.div_latency - 2));
+}
+
+TEST_CASE("Pipeline branch penalties", "[Pipeline]") {
+    // 10 iterations: the loop branch is taken 9 times
+    WORD program[] = {
+        Utilities::I_instruction(OP_ADDIU, 1, 0, 10),       // addiu $1, $0, 10
+        Utilities::I_instruction(OP_ADDIU, 1, 1, -1),       // addiu $1, $1, -1
+        Utilities::I_instruction(OP_BGTZ, 0, 1, -1),       // bgtz $1, -1
+        Utilities::J_instruction(OP_J, 4),              // j 0x10
+        Utilities::R_instruction(OP_SPECIAL, 0, 0, 0, 1, FUNC_BREAK), // break 1
+    };
+    PipelineConfig config;
+
+    SECTION("predicting not taken") {
+        PipelineModel model = run_program(program, 5, config);
+        REQUIRE(model.stall_cycles(STALL_BRANCH) == 9 * config.branch_penalty);
+        REQUIRE(model.stall_cycles(STALL_JUMP) == config.jump_penalty);
+    }
+
+    SECTION("with a predictor") {
+        BimodalPredictor predictor;
+        Emulator vm(0x100, program, 5);
+        PipelineModel model(config, &predictor);
+        DWORD executed = 0;
+        REQUIRE(vm.run(1000, executed, model) == STEP_TRAP);
+        // Weakly not taken, then right until the exit
+        REQUIRE(model.stall_cycles(STALL_BRANCH) == 2 * config.branch_penalty);
+    }
+}
+
+TEST_CASE("Pipeline cycles add up on the workloads", "[Pipeline][Workloads]") {
+    for(const Workload& w : workload_corpus()) {
+        Emulator* vm = w.load();
+        PipelineModel model;
+        DWORD executed = 0;
+        REQUIRE(vm->run(100000000, executed, model) == WORKLOAD_DONE);
+        REQUIRE(w.check(*vm));
+        delete vm;
+
+        DWORD stalls = 0;
+        for(int k = 0; k < STALL_KINDS; k++) stalls += model.stall_cycles((StallKind)k);
+        REQUIRE(model.cycles() == executed + 4 + stalls);
+        REQUIRE(model.cpi() > 1);
+    }
+}
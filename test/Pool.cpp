@@ -0,0 +1,66 @@
+#include <cstdint>
+#include <thread>
+
+#include "../include/catch.hpp"
+#include "../src/Utilities.hpp"
+#include "../src/Pool.hpp"
+
+TEST_CASE("Emulators are backed by the per-thread pool", "[Pool]") {
+    Pool::trim();
+    PoolStats before = Pool::stats();
+
+    SECTION("Destroyed instances are reused without touching the heap") {
+        for(int i = 0; i < 10; i++) {
+            Emulator vm(4096);
+            vm.store_word(0xffffffff, 4092);
+            vm.set_register(5, 7);
+        }
+
+        PoolStats after = Pool::stats();
+        REQUIRE(after.allocations - before.allocations == 1);
+        REQUIRE(after.reuses - before.reuses == 9);
+        REQUIRE(after.releases - before.releases == 10);
+        REQUIRE(after.cached == 1);
+    }
+
+    SECTION("Reused storage is handed out zeroed") {
+        {
+            Emulator vm(128);
+            for(int i = 0; i < 128; i++) vm.store_byte(0xff, i);
+            for(int i = 1; i < 32; i++) vm.set_register(i, 0xffffffff);
+        }
+
+        Emulator vm(128);
+        for(int i = 0; i < 128; i++) {
+            REQUIRE(vm.load_byte(i) == 0);
+        }
+        for(int i = 0; i < 32; i++) {
+            REQUIRE(vm.get_register(i) == 0);
+        }
+    }
+
+    SECTION("Reserved blocks are cache-line aligned and satisfy later constructions") {
+        Pool::reserve(256, 4);
+        REQUIRE(Pool::stats().cached == 4);
+
+        BYTE* block = Pool::acquire(256);
+        REQUIRE((uintptr_t)block % CACHE_LINE == 0);
+        Pool::release(block, 256);
+
+        REQUIRE(Pool::stats().allocations - before.allocations == 4);
+    }
+
+    SECTION("Each thread has its own arena") {
+        size_t thread_allocations = 0;
+        std::thread worker([&]() {
+            Emulator vm(128);
+            thread_allocations = Pool::stats().allocations;
+        });
+        worker.join();
+
+        REQUIRE(thread_allocations == 1);
+        REQUIRE(Pool::stats().allocations == before.allocations);
+    }
+
+    Pool::trim();
+}
@@ -0,0 +1,87 @@
+#include <cstring>
+
+#include "../include/catch.hpp"
+#include "../src/Utilities.hpp"
+#include "../src/Profiler.hpp"
+#include "../src/Workloads.hpp"
+
+TEST_CASE("Symbol table resolves addresses to the closest symbol below", "[Symbols]") {
+    SymbolTable symbols;
+    symbols.add(0x40, "loop");
+    symbols.add(0x10, "main");
+    symbols.add(0x80, "exit");
+
+    REQUIRE(symbols.lookup(0x0c) == NULL);
+    REQUIRE(symbols.lookup(0x10)->name == "main");
+    REQUIRE(symbols.lookup(0x3c)->name == "main");
+    REQUIRE(symbols.lookup(0x44)->name == "loop");
+    REQUIRE(symbols.lookup(0x1000)->name == "exit");
+    REQUIRE(symbols.describe(0x48) == "loop+0x8");
+    REQUIRE(symbols.describe(0x40) == "loop");
+    REQUIRE(symbols.describe(0x4) == "0x00000004");
+    REQUIRE(symbols.find("exit") == 0x80);
+    REQUIRE(symbols.find("missing") == -1);
+}
+
+static std::string contents(FILE* file) {
+    char buffer[8192] = {};
+    rewind(file);
+    fread(buffer, 1, sizeof(buffer) - 1, file);
+    fclose(file);
+    return buffer;
+}
+
+TEST_CASE("Sampling profiler aggregates samples", "[Profiler]") {
+    SamplingProfiler profiler(1000);
+    SymbolTable symbols;
+    symbols.add(0x0, "main");
+    symbols.add(0x20, "loop");
+
+    for(int i = 0; i < 6; i++) profiler.add_sample(0x24);
+    for(int i = 0; i < 3; i++) profiler.add_sample(0x28);
+    profiler.add_sample(0x4);
+    REQUIRE(profiler.total_samples() == 10);
+
+    SECTION("hotspot report is sorted by samples") {
+        FILE* file = tmpfile();
+        profiler.report(file, &symbols, 10);
+        std::string report = contents(file);
+
+        REQUIRE(report.find("Samples: 10") != std::string::npos);
+        REQUIRE(report.find("6  60.00%  0x00000024  loop+0x4") < report.find("3  30.00%  0x00000028  loop+0x8"));
+        REQUIRE(report.find("9  90.00%  loop") != std::string::npos);
+        REQUIRE(report.find("1  10.00%  main") != std::string::npos);
+    }
+
+    SECTION("folded output has one line per address") {
+        FILE* file = tmpfile();
+        profiler.folded(file, &symbols);
+        REQUIRE(contents(file) == "main;main+0x4 1\nloop;loop+0x4 6\nloop;loop+0x8 3\n");
+    }
+
+    SECTION("clear") {
+        profiler.clear();
+        REQUIRE(profiler.total_samples() == 0);
+    }
+}
+
+TEST_CASE("Sampler thread finds the hot loop of a workload", "[Profiler][Workloads]") {
+    const Workload* crc = find_workload("crc32");
+    SamplingProfiler profiler(20);
+
+    // Rerun until there are enough samples to be meaningful
+    for(int run = 0; run < 10000 && profiler.total_samples() < 200; run++) {
+        Emulator* vm = crc->load();
+        DWORD executed = 0;
+        REQUIRE(profiler.run(*vm, 10000000, executed) == WORKLOAD_DONE);
+        REQUIRE(crc->check(*vm));
+        delete vm;
+    }
+    REQUIRE(profiler.total_samples() >= 200);
+
+    FILE* file = tmpfile();
+    profiler.report(file, &crc->symbols, 1);
+    std::string report = contents(file);
+    std::string functions = report.substr(report.find("Hotspots by function"));
+    REQUIRE(functions.find("  bit\n") != std::string::npos);
+}
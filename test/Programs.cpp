@@ -1,19 +1,22 @@
 #include "../include/catch.hpp"
+#include "../src/Differential.hpp"
 #include "../src/Utilities.hpp"
 
+static const WORD memory_io[7] = {
+    0x3c01aabb, // lui $1, 0xffffaabb
+    0x3429ccdd, // ori $9, $1, 0x0000ccdd
+    0xafa90004, // sw $9, 0x00000004($29)
+    0x23bd0004, // addi $29, $29, 0x00000004
+    0x8baa0001, // lwl $10, 0x00000001($29)
+    0x9bab0001, // lwr $11, 0x00000001($29)
+    0x83ac0000, // lb $12, 0x00000000($29)
+};
+
 TEST_CASE("Test system holistically", "[step][system-tests]") {
     Emulator* vm;
 
     SECTION("Simple memory I/O") {
-        WORD program[7];
-        program[0] = 0x3c01aabb; // lui $1, 0xffffaabb
-        program[1] = 0x3429ccdd; // ori $9, $1, 0x0000ccdd
-        program[2] = 0xafa90004; // sw $9, 0x00000004($29)
-        program[3] = 0x23bd0004; // addi $29, $29, 0x00000004
-        program[4] = 0x8baa0001; // lwl $10, 0x00000001($29)
-        program[5] = 0x9bab0001; // lwr $11, 0x00000001($29)
-        program[6] = 0x83ac0000; // lb $12, 0x00000000($29)
-        vm = new Emulator(128, program, 7);
+        vm = new Emulator(128, memory_io, 7);
 
         // set $29 (stack-pointer) to high memory address
         vm->set_register(29, 32);
@@ -30,3 +33,18 @@ TEST_CASE("Test system holistically", "[step][system-tests]") {
         REQUIRE(vm->get_register(12) == 0xffffffdd);
     }
 }
+
+TEST_CASE("System programs agree between the interpreter and the tracing path", "[Differential][system-tests]") {
+    // The same start as above; execution then runs on through the rest of memory into a fetch fault
+    auto load = [] {
+        Emulator* emulator = new Emulator(128, memory_io, 7);
+        emulator->set_register(29, 32);
+        return emulator;
+    };
+    LockstepChecker checker([&] { return new InterpreterBackend(load()); },
+                            [&] { return new TracingBackend(load()); }, 1);
+    DiffResult result = checker.run(1000);
+    REQUIRE(!result.diverged);
+    REQUIRE(result.reference_status == STEP_FAULT);
+    REQUIRE(result.executed == 33);
+}
@@ -0,0 +1,79 @@
+#include "../include/catch.hpp"
+#include "../src/Utilities.hpp"
+#include "../src/Replay.hpp"
+
+TEST_CASE("Recorded traces replay deterministically", "[Replay][TraceRecorder][TraceReplayer]") {
+    WORD program[5];
+    program[0] = Utilities::I_instruction(OP_ADDIU, 1, 1, 1); // addiu r1, r1, 1
+    program[1] = Utilities::I_instruction(OP_LW, 2, 0, 64); // lw r2, 64(r0)
+    program[2] = Utilities::R_instruction(OP_SPECIAL, 3, 3, 2, 0, FUNC_ADDU); // addu r3, r3, r2
+    program[3] = Utilities::I_instruction(OP_BNE, 4, 1, -3); // bne r1, r4, -3(-12)
+    program[4] = Utilities::R_instruction(OP_SPECIAL, 1, 0, 0, 0, FUNC_BREAK); // break 32
+
+    Emulator* vm = new Emulator(128, program, 5);
+    FILE* file = tmpfile();
+    TraceRecorder* recorder = new TraceRecorder(*vm, file, 64);
+
+    // Host inputs: loop bound, then a new value every 50 instructions
+    recorder->set_register(4, 100);
+    BYTE input[4] = {1, 0, 0, 0};
+    recorder->write_memory(64, input, 4);
+
+    int status = STEP_OK;
+    while(status == STEP_OK) {
+        status = recorder->step();
+        if(recorder->instructions() % 50 == 0) {
+            input[0]++;
+            recorder->write_memory(64, input, 4);
+        }
+    }
+    recorder->finish();
+
+    REQUIRE(status == 32);
+    REQUIRE(recorder->instructions() == 401);
+    REQUIRE(ftell(file) < 401 * 4);
+
+    rewind(file);
+    TraceReplayer replayer(file);
+    REQUIRE(replayer.valid());
+    REQUIRE(replayer.length() == 401);
+
+    SECTION("replaying from the start reproduces the final state") {
+        int replayed_status = STEP_OK;
+        while(!replayer.done()) {
+            replayed_status = replayer.step();
+        }
+
+        REQUIRE(replayed_status == 32);
+        REQUIRE_FALSE(replayer.diverged());
+        for(int i = 0; i < 32; i++) {
+            REQUIRE(replayer.emulator().get_register(i) == vm->get_register(i));
+        }
+        REQUIRE(replayer.emulator().state().PC == vm->state().PC);
+        REQUIRE(replayer.emulator().load_word(64) == vm->load_word(64));
+    }
+
+    SECTION("seeking lands on the state after that many instructions") {
+        REQUIRE(replayer.seek(130));
+        REQUIRE(replayer.position() == 130);
+        // 130 instructions: 32 full iterations and two more instructions of the 33rd
+        REQUIRE(replayer.emulator().get_register(1) == 33);
+        REQUIRE(replayer.emulator().state().PC == 8);
+
+        // Seeking backwards goes through an earlier keyframe
+        REQUIRE(replayer.seek(5));
+        REQUIRE(replayer.emulator().get_register(1) == 2);
+        REQUIRE(replayer.emulator().get_register(3) == 1);
+    }
+
+    SECTION("divergence from the recorded PCs is detected") {
+        REQUIRE(replayer.seek(10));
+        replayer.emulator().set_register(1, 90);
+        while(!replayer.done() && !replayer.diverged()) {
+            replayer.step();
+        }
+        REQUIRE(replayer.diverged());
+    }
+
+    fclose(file);
+}
@@ -0,0 +1,134 @@
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#include "../include/catch.hpp"
+#include "../src/Replay.hpp"
+#include "../src/StateHash.hpp"
+#include "../src/Utilities.hpp"
+#include "../src/Workloads.hpp"
+
+TEST_CASE("State hash covers registers and memory", "[StateHash]") {
+    CPUState cpu;
+    memset(&cpu, 0, sizeof(cpu));
+    std::vector<BYTE> memory(256, 0);
+    DWORD base = state_hash(cpu, memory.data(), memory.size());
+
+    cpu.gpr[DISCARD_SLOT] = 5;
+    cpu.status = 7;
+    REQUIRE(state_hash(cpu, memory.data(), memory.size()) == base);
+    cpu.LO = 1;
+    REQUIRE(state_hash(cpu, memory.data(), memory.size()) != base);
+    cpu.LO = 0;
+    memory[200] = 1;
+    REQUIRE(state_hash(cpu, memory.data(), memory.size()) != base);
+}
+
+TEST_CASE("Incremental digests only rehash the pages stored to", "[StateHash]") {
+    for(const Workload& w : workload_corpus()) {
+        SECTION(w.name) {
+            Emulator* vm = w.load();
+            StateHasher hasher(*vm);
+            size_t pages = vm->get_memory_size() / EMU_PAGE_SIZE;
+
+            hasher.digest(vm->state());
+            REQUIRE(hasher.pages_rehashed() == pages);
+
+            int status = STEP_OK;
+            DWORD executed = 0;
+            while(status == STEP_OK) {
+                status = run_workload(*vm, 5000, executed);
+                DWORD before = hasher.pages_rehashed();
+                REQUIRE(hasher.digest(vm->state()) == state_hash(vm->state(), vm->get_memory(), vm->get_memory_size()));
+                // The kernels keep their data and stack in a few pages
+                REQUIRE(hasher.pages_rehashed() - before <= 4);
+            }
+            REQUIRE(status == WORKLOAD_DONE);
+
+            delete vm;
+        }
+    }
+}
+
+TEST_CASE("Writes around the tracker need touch()", "[StateHash]") {
+    Emulator vm(4 * EMU_PAGE_SIZE);
+    StateHasher hasher(vm);
+    hasher.digest(vm.state());
+
+    vm.get_memory()[2 * EMU_PAGE_SIZE + 5] = 9;
+    REQUIRE(hasher.digest(vm.state()) != state_hash(vm.state(), vm.get_memory(), vm.get_memory_size()));
+
+    hasher.touch(2 * EMU_PAGE_SIZE, 8);
+    DWORD before = hasher.pages_rehashed();
+    REQUIRE(hasher.digest(vm.state()) == state_hash(vm.state(), vm.get_memory(), vm.get_memory_size()));
+    REQUIRE(hasher.pages_rehashed() - before == 1);
+
+    SECTION("swapping pages changes the digest") {
+        vm.get_memory()[2 * EMU_PAGE_SIZE + 5] = 0;
+        vm.get_memory()[EMU_PAGE_SIZE + 5] = 9;
+        hasher.touch_all();
+        DWORD swapped = hasher.digest(vm.state());
+        vm.get_memory()[EMU_PAGE_SIZE + 5] = 0;
+        vm.get_memory()[2 * EMU_PAGE_SIZE + 5] = 9;
+        hasher.touch_all();
+        REQUIRE(hasher.digest(vm.state()) != swapped);
+    }
+}
+
+TEST_CASE("Digests find repeated states", "[StateHash]") {
+    // $1 counts 1..4, 0 and wraps, storing each value: four iterations of 5 instructions and one of 6
+    WORD program[] = {
+        Utilities::I_instruction(OP_ADDIU, 1, 1, 1),           // 0x00: addiu $1, $1, 1
+        Utilities::I_instruction(OP_ADDIU, 2, 0, 5),           // 0x04: addiu $2, $0, 5
+        Utilities::I_instruction(OP_BNE, 2, 1, 2),           // 0x08: bne $1, $2, 0x10
+        Utilities::I_instruction(OP_ADDIU, 1, 0, 0),           // 0x0c: addiu $1, $0, 0
+        Utilities::I_instruction(OP_SW, 1, 0, 0x100),      // 0x10: sw $1, 0x100($0)
+        Utilities::J_instruction(OP_J, 0),                 // 0x14: j 0x00
+    };
+    Emulator vm(0x200, program, sizeof(program) / sizeof(WORD));
+    StateHasher hasher(vm);
+
+    std::unordered_map<DWORD, DWORD> seen;
+    DWORD first = 0, again = 0;
+    for(DWORD n = 0; n < 1000; n++) {
+        auto inserted = seen.insert({hasher.digest(vm.state()), n});
+        if(!inserted.second) {
+            first = inserted.first->second;
+            again = n;
+            break;
+        }
+        REQUIRE(vm.step() == STEP_OK);
+    }
+    REQUIRE(again - first == 26);
+}
+
+TEST_CASE("Replay keyframes round-trip to the same digest", "[StateHash][Replay]") {
+    const Workload* w = find_workload("sort");
+    REQUIRE(w != NULL);
+    Emulator* vm = w->load();
+    FILE* file = tmpfile();
+    TraceRecorder recorder(*vm, file, 1000);
+
+    std::vector<DWORD> digests;
+    StateHasher hasher(*vm);
+    int status = STEP_OK;
+    while(status == STEP_OK) {
+        if(recorder.instructions() % 1000 == 0) digests.push_back(hasher.digest(vm->state()));
+        status = recorder.step();
+    }
+    recorder.finish();
+    REQUIRE(status == WORKLOAD_DONE);
+    REQUIRE(digests.size() > 3);
+
+    rewind(file);
+    TraceReplayer replayer(file);
+    REQUIRE(replayer.valid());
+    for(size_t k = 0; k < digests.size(); k++) {
+        REQUIRE(replayer.seek(k * 1000));
+        Emulator& replayed = replayer.emulator();
+        REQUIRE(state_hash(replayed.state(), replayed.get_memory(), replayed.get_memory_size()) == digests[k]);
+    }
+
+    fclose(file);
+    delete vm;
+}
@@ -0,0 +1,122 @@
+#include "../include/catch.hpp"
+#include "../src/Utilities.hpp"
+#include "../src/Trace.hpp"
+
+TEST_CASE("Trace ring is a bounded SPSC queue", "[Trace][TraceRing]") {
+    TraceRing ring(3); // rounded up to 4
+    TraceRecord out[8];
+
+    SECTION("records come out in order") {
+        for(WORD i = 0; i < 3; i++) {
+            TraceRecord r = {i * 4, i, 0, 0, 0, 0};
+            REQUIRE(ring.push(r));
+        }
+        REQUIRE(ring.pop(out, 8) == 3);
+        REQUIRE(out[0].instruction == 0);
+        REQUIRE(out[2].instruction == 2);
+        REQUIRE(ring.pop(out, 8) == 0);
+    }
+
+    SECTION("producer drops and counts records when full") {
+        TraceRecord r = {};
+        for(int i = 0; i < 6; i++) ring.push(r);
+
+        REQUIRE(ring.dropped() == 2);
+        REQUIRE(ring.pop(out, 8) == 4);
+        REQUIRE(ring.push(r));
+    }
+}
+
+TEST_CASE("Emulator writes a compressed trace", "[Trace][TraceWriter][step]") {
+    WORD program[5];
+    program[0] = Utilities::I_instruction(OP_ADDIU, 1, 0, 0x55); // addiu r1, r0, 0x55
+    program[1] = Utilities::I_instruction(OP_SW, 1, 0, 64); // sw r1, 64(r0)
+    program[2] = Utilities::I_instruction(OP_LB, 2, 0, 64); // lb r2, 64(r0)
+    program[3] = Utilities::J_instruction(OP_J, 0); // j 0
+    program[4] = Utilities::I_instruction(OP_LW, 3, 0, 2); // lw r3, 2(r0)
+
+    Emulator* vm = new Emulator(128, program, 5);
+    TraceRing ring(1024);
+    FILE* file = tmpfile();
+    TraceWriter* writer = new TraceWriter(ring, file);
+
+    vm->trace_to(&ring);
+    for(int i = 0; i < 8; i++) {
+        REQUIRE(vm->step() == 0);
+    }
+    vm->state().PC = 16;
+    REQUIRE(vm->step() == STEP_TRAP);
+    vm->trace_to(NULL);
+    vm->step();
+
+    writer->stop();
+    REQUIRE(writer->records_written() == 9);
+    REQUIRE(writer->bytes_written() < 9 * sizeof(TraceRecord));
+    REQUIRE(!writer->write_failed());
+
+    rewind(file);
+    std::vector<TraceRecord> records = read_trace(file);
+    fclose(file);
+
+    REQUIRE(records.size() == 9);
+    REQUIRE(ring.dropped() == 0);
+
+    SECTION("PCs and instruction words are recorded") {
+        for(int i = 0; i < 8; i++) {
+            REQUIRE(records[i].pc == (WORD)(i % 4) * 4);
+            REQUIRE(records[i].instruction == program[i % 4]);
+        }
+        REQUIRE(records[8].pc == 16);
+    }
+
+    SECTION("loads and stores carry address and value") {
+        REQUIRE(records[1].flags == TRACE_STORE);
+        REQUIRE(records[1].address == 64);
+        REQUIRE(records[1].value == 0x55);
+        REQUIRE(records[2].flags == TRACE_LOAD);
+        REQUIRE(records[2].address == 64);
+        REQUIRE(records[2].value == 0x55);
+        REQUIRE(records[0].flags == 0);
+    }
+
+    SECTION("trap codes are recorded") {
+        REQUIRE(records[7].status == 0);
+        REQUIRE(records[8].status == STEP_TRAP);
+        REQUIRE(records[8].address == 2);
+    }
+}
+
+TEST_CASE("Trace writes that fail are reported", "[Trace][TraceWriter]") {
+    TraceRing ring(1024);
+    FILE* file = fopen("/dev/null", "r");
+    REQUIRE(file != NULL);
+    TraceWriter writer(ring, file);
+
+    TraceRecord record = {0, 0, 0, 0, 0, 0};
+    for(int i = 0; i < 16; i++) {
+        record.pc = i * 4;
+        REQUIRE(ring.push(record));
+    }
+
+    writer.stop();
+    fclose(file);
+    REQUIRE(writer.write_failed());
+    REQUIRE(writer.bytes_written() == 0);
+}
+
+TEST_CASE("Fetches outside of memory are not traced", "[Trace][step]") {
+    WORD program[1];
+    program[0] = Utilities::R_instruction(OP_SPECIAL, 0, 1, 0, 0, FUNC_JR); // jr r1
+
+    Emulator vm(64, program, 1);
+    TraceRing ring(4);
+    TraceRecord out[4];
+    vm.trace_to(&ring);
+    vm.set_register(1, 0x100000);
+
+    REQUIRE(vm.step() == STEP_OK);
+    REQUIRE(vm.step() == STEP_FAULT);
+    REQUIRE(vm.state().PC == 0x100000);
+    REQUIRE(ring.pop(out, 4) == 1);
+    REQUIRE(out[0].pc == 0);
+}
@@ -0,0 +1,17 @@
+#include "../include/catch.hpp"
+#include "../src/Utilities.hpp"
+#include "../src/Workloads.hpp"
+
+TEST_CASE("Workload corpus runs to its expected final state", "[Workloads][system-tests]") {
+    for(const Workload& w : workload_corpus()) {
+        SECTION(w.name) {
+            Emulator* vm = w.load();
+            DWORD executed = 0;
+
+            REQUIRE(run_workload(*vm, 10000000, executed) == WORKLOAD_DONE);
+            REQUIRE(w.check(*vm));
+            REQUIRE(executed > 1000);
+            delete vm;
+        }
+    }
+}